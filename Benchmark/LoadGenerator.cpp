@@ -0,0 +1,344 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "LoadGenerator.h"
+#include "SyntheticTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+//=================================================================================================
+
+namespace {
+
+juce::String makeHttpRequest (const juce::String& path, const juce::String& contentType, const juce::String& body)
+{
+    juce::String request;
+
+    request
+        << "GET " << path << " HTTP/1.1\r\n"
+        << "Host: localhost\r\n"
+        << "Content-Type: " << contentType << "\r\n"
+        << "Content-Length: " << body.getNumBytesAsUTF8() << "\r\n"
+        << "\r\n"
+        << body;
+
+    return request;
+}
+
+juce::String makeJsonRequest (const juce::String& path, const juce::var& data)
+{
+    return makeHttpRequest (path, "application/json", juce::JSON::toString (data, true));
+}
+
+juce::var makeComponentData (const juce::String& componentID)
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("id", componentID);
+    return object.get();
+}
+
+double getPercentile (const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0.0;
+
+    auto index = static_cast<std::size_t> (std::ceil (percentile * static_cast<double> (sortedValues.size()));
+    return sortedValues [juce::jlimit<std::size_t> (0, sortedValues.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::Result BenchmarkOptions::fromArguments (const juce::ArgumentList& arguments, BenchmarkOptions& options)
+{
+    auto getIntValue = [&] (juce::StringRef option, int& value, int minimumValue)
+    {
+        if (! arguments.containsOption (option))
+            return true;
+
+        value = arguments.getValueForOption (option).getIntValue();
+        return value >= minimumValue;
+    };
+
+    if (! getIntValue ("--nodes", options.numNodes, 1))
+        return juce::Result::fail ("Invalid number of nodes");
+
+    if (! getIntValue ("--fanout", options.fanOut, 1))
+        return juce::Result::fail ("Invalid fan out");
+
+    if (! getIntValue ("--clients", options.numClients, 1))
+        return juce::Result::fail ("Invalid number of clients");
+
+    if (! getIntValue ("--port", options.port, 1))
+        return juce::Result::fail ("Invalid port");
+
+    if (! getIntValue ("--requests", options.requestsPerClient, 0))
+        return juce::Result::fail ("Invalid number of requests per client");
+
+    if (arguments.containsOption ("--duration"))
+    {
+        options.durationSeconds = arguments.getValueForOption ("--duration").getDoubleValue();
+        if (options.durationSeconds <= 0.0)
+            return juce::Result::fail ("Invalid duration");
+    }
+
+    if (arguments.containsOption ("--endpoints"))
+    {
+        options.endpoints = juce::StringArray::fromTokens (arguments.getValueForOption ("--endpoints"), ",", "");
+        options.endpoints.trim();
+        options.endpoints.removeEmptyStrings();
+
+        for (const auto& endpoint : options.endpoints)
+        {
+            if (! juce::StringArray { "exists", "info", "click", "render", "python" }.contains (endpoint))
+                return juce::Result::fail ("Invalid endpoint " + endpoint);
+        }
+
+        if (options.endpoints.isEmpty())
+            return juce::Result::fail ("No endpoints specified");
+    }
+
+    if (arguments.containsOption ("--output"))
+        options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile (arguments.getValueForOption ("--output"));
+
+    return juce::Result::ok();
+}
+
+juce::String BenchmarkOptions::getUsage()
+{
+    return "straw_benchmark [--nodes=1000] [--fanout=8] [--clients=4] [--duration=10] [--requests=0] [--port=18001]\n"
+           "                [--endpoints=exists,info,click,render,python] [--output=report.json] [--windowed]";
+}
+
+juce::var BenchmarkOptions::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("nodes", numNodes);
+    object->setProperty ("fanout", fanOut);
+    object->setProperty ("clients", numClients);
+    object->setProperty ("duration_s", durationSeconds);
+    object->setProperty ("requests_per_client", requestsPerClient);
+    object->setProperty ("endpoints", endpoints);
+    return object.get();
+}
+
+//=================================================================================================
+
+class LoadGenerator::Client : public juce::Thread
+{
+public:
+    Client (const BenchmarkOptions& benchmarkOptions, int serverPort, int numNodes, int clientIndex)
+        : juce::Thread ("Straw Benchmark Client " + juce::String (clientIndex))
+        , options (benchmarkOptions)
+        , port (serverPort)
+        , nodeCount (numNodes)
+        , endpointIndex (clientIndex)
+        , random (static_cast<juce::int64> (clientIndex) + 1)
+    {
+    }
+
+    ~Client() override
+    {
+        stopThread (10000);
+    }
+
+    void run() override
+    {
+        const auto deadline = juce::Time::getMillisecondCounterHiRes() + options.durationSeconds * 1000.0;
+
+        for (int numRequests = 0; ! threadShouldExit(); ++numRequests)
+        {
+            if (options.requestsPerClient > 0 ? numRequests >= options.requestsPerClient
+                                              : juce::Time::getMillisecondCounterHiRes() >= deadline)
+                break;
+
+            const auto& endpoint = options.endpoints [endpointIndex++ % options.endpoints.size()];
+            const auto request = makeRequest (endpoint);
+
+            const auto startTime = juce::Time::getMillisecondCounterHiRes();
+            const bool succeeded = sendRequest (request);
+            const auto latency = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+            auto& endpointSamples = samples [endpoint];
+            endpointSamples.latencies.push_back (latency);
+
+            if (! succeeded)
+                ++endpointSamples.numErrors;
+        }
+
+        finished.store (true);
+    }
+
+    bool isFinished() const
+    {
+        return finished.load();
+    }
+
+    const std::map<juce::String, EndpointSamples>& getSamples() const
+    {
+        return samples;
+    }
+
+private:
+    juce::String makeRequest (const juce::String& endpoint)
+    {
+        auto componentID = SyntheticTree::getNodeID (random.nextInt (nodeCount));
+
+        if (endpoint == "exists")
+            return makeJsonRequest ("/straw/component/exists", makeComponentData (componentID));
+
+        if (endpoint == "info")
+            return makeJsonRequest ("/straw/component/info", makeComponentData (componentID));
+
+        if (endpoint == "click")
+        {
+            auto data = makeComponentData (componentID);
+            data.getDynamicObject()->setProperty ("time", 0);
+            return makeJsonRequest ("/straw/component/click", data);
+        }
+
+        if (endpoint == "render")
+        {
+            auto data = makeComponentData (componentID);
+            data.getDynamicObject()->setProperty ("withChildren", true);
+            return makeJsonRequest ("/straw/component/render", data);
+        }
+
+        return makeHttpRequest ("/", "text/x-python", "import straw\nstraw.findComponentById(\"" + componentID + "\")");
+    }
+
+    bool sendRequest (const juce::String& request)
+    {
+        juce::StreamingSocket socket;
+        if (! socket.connect ("127.0.0.1", port, 5000))
+            return false;
+
+        if (socket.write (request.toRawUTF8(), static_cast<int> (request.getNumBytesAsUTF8())) < 0)
+            return false;
+
+        juce::MemoryBlock response;
+        char buffer [4096];
+
+        while (true)
+        {
+            if (socket.waitUntilReady (true, 30000) != 1)
+                break;
+
+            auto numBytesRead = socket.read (buffer, static_cast<int> (sizeof (buffer)), false);
+            if (numBytesRead <= 0)
+                break;
+
+            response.append (buffer, static_cast<std::size_t> (numBytesRead));
+        }
+
+        return response.toString().startsWith ("HTTP/1.1 200");
+    }
+
+    const BenchmarkOptions& options;
+    const int port;
+    const int nodeCount;
+    int endpointIndex;
+    juce::Random random;
+    std::map<juce::String, EndpointSamples> samples;
+    std::atomic<bool> finished { false };
+};
+
+//=================================================================================================
+
+LoadGenerator::LoadGenerator (const BenchmarkOptions& benchmarkOptions, int port, int numNodes)
+    : options (benchmarkOptions)
+{
+    for (int clientIndex = 0; clientIndex < options.numClients; ++clientIndex)
+        clients.push_back (std::make_unique<Client> (options, port, numNodes, clientIndex));
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    clients.clear();
+}
+
+void LoadGenerator::start()
+{
+    for (auto& client : clients)
+        client->startThread();
+}
+
+bool LoadGenerator::isFinished() const
+{
+    return std::all_of (clients.begin(), clients.end(), [] (const auto& client) { return client->isFinished(); });
+}
+
+//=================================================================================================
+
+juce::var LoadGenerator::makeReport (double elapsedSeconds) const
+{
+    std::map<juce::String, EndpointSamples> mergedSamples;
+    EndpointSamples totalSamples;
+
+    for (const auto& client : clients)
+    {
+        for (const auto& [endpoint, endpointSamples] : client->getSamples())
+        {
+            for (auto* merged : { &mergedSamples [endpoint], &totalSamples })
+            {
+                merged->latencies.insert (merged->latencies.end(), endpointSamples.latencies.begin(), endpointSamples.latencies.end());
+                merged->numErrors += endpointSamples.numErrors;
+            }
+        }
+    }
+
+    juce::DynamicObject::Ptr endpointsObject = new juce::DynamicObject;
+    for (const auto& [endpoint, endpointSamples] : mergedSamples)
+        endpointsObject->setProperty (endpoint, makeLatencyReport (endpointSamples, elapsedSeconds));
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("configuration", options.toVar());
+    object->setProperty ("elapsed_s", elapsedSeconds);
+    object->setProperty ("total", makeLatencyReport (totalSamples, elapsedSeconds));
+    object->setProperty ("endpoints", endpointsObject.get());
+    return object.get();
+}
+
+juce::var LoadGenerator::makeLatencyReport (const EndpointSamples& samples, double elapsedSeconds)
+{
+    auto latencies = samples.latencies;
+    std::sort (latencies.begin(), latencies.end());
+
+    const auto numRequests = static_cast<int> (latencies.size());
+    const auto totalLatency = std::accumulate (latencies.begin(), latencies.end(), 0.0);
+
+    juce::DynamicObject::Ptr latencyObject = new juce::DynamicObject;
+    latencyObject->setProperty ("p50", getPercentile (latencies, 0.50));
+    latencyObject->setProperty ("p99", getPercentile (latencies, 0.99));
+    latencyObject->setProperty ("p999", getPercentile (latencies, 0.999));
+    latencyObject->setProperty ("max", latencies.empty() ? 0.0 : latencies.back());
+    latencyObject->setProperty ("mean", numRequests > 0 ? totalLatency / numRequests : 0.0);
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("requests", numRequests);
+    object->setProperty ("errors", samples.numErrors);
+    object->setProperty ("rps", elapsedSeconds > 0.0 ? numRequests / elapsedSeconds : 0.0);
+    object->setProperty ("latency_ms", latencyObject.get());
+    return object.get();
+}
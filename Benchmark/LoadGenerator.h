@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+//=================================================================================================
+
+/**
+ * @brief The configuration of a benchmark run, parsed from the command line.
+ */
+struct BenchmarkOptions
+{
+    int numNodes = 1000;
+    int fanOut = 8;
+    int numClients = 4;
+    int port = 18001;
+    double durationSeconds = 10.0;
+    int requestsPerClient = 0;
+    juce::StringArray endpoints { "exists", "info", "click", "render", "python" };
+    juce::File outputFile;
+
+    static juce::Result fromArguments (const juce::ArgumentList& arguments, BenchmarkOptions& options);
+    static juce::String getUsage();
+
+    juce::var toVar() const;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Drives the automation server with concurrent local clients and collects the request latencies.
+ */
+class LoadGenerator
+{
+public:
+    LoadGenerator (const BenchmarkOptions& options, int port, int numNodes);
+    ~LoadGenerator();
+
+    void start();
+    bool isFinished() const;
+
+    juce::var makeReport (double elapsedSeconds) const;
+
+private:
+    class Client;
+
+    struct EndpointSamples
+    {
+        std::vector<double> latencies;
+        int numErrors = 0;
+    };
+
+    static juce::var makeLatencyReport (const EndpointSamples& samples, double elapsedSeconds);
+
+    BenchmarkOptions options;
+    std::vector<std::unique_ptr<Client>> clients;
+
+    JUCE_DECLARE_NON_COPYABLE (LoadGenerator)
+};
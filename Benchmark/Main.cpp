@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "JuceHeader.h"
+#include "LoadGenerator.h"
+#include "SyntheticTree.h"
+
+#include <iostream>
+
+//=================================================================================================
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList arguments (argc, argv);
+
+    if (arguments.containsOption ("--help|-h"))
+    {
+        std::cout << BenchmarkOptions::getUsage() << std::endl;
+        return 0;
+    }
+
+    BenchmarkOptions options;
+
+    auto result = BenchmarkOptions::fromArguments (arguments, options);
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl << BenchmarkOptions::getUsage() << std::endl;
+        return 1;
+    }
+
+    straw::setHeadlessModeEnabled (! arguments.containsOption ("--windowed"));
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto tree = std::make_unique<SyntheticTree> (options.numNodes, options.fanOut);
+
+    straw::AutomationServer automationServer;
+    automationServer.registerDefaultEndpoints();
+    automationServer.registerDefaultComponents();
+
+    result = automationServer.start (options.port);
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    LoadGenerator generator (options, *automationServer.getPort(), tree->getNumNodes());
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    generator.start();
+
+    while (! generator.isFinished())
+        juce::MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+    const auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    auto report = generator.makeReport (elapsedSeconds);
+    report.getDynamicObject()->setProperty ("peak_rss_bytes", straw::Helpers::getPeakResidentMemorySize());
+
+    automationServer.stop();
+    tree.reset();
+
+    auto reportJson = juce::JSON::toString (report);
+    std::cout << reportJson << std::endl;
+
+    if (options.outputFile != juce::File() && ! options.outputFile.replaceWithText (reportJson))
+    {
+        std::cerr << "Unable to write " << options.outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
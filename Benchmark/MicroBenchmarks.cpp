@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "JuceHeader.h"
+#include "SyntheticTree.h"
+
+#include <benchmark/benchmark.h>
+
+#include <utility>
+#include <vector>
+
+//=================================================================================================
+
+namespace {
+
+// Tree shapes as { depth, fanOut } pairs, from a few dozen nodes to tens of thousands
+void addTreeShapes (benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames ({ "depth", "fanout" });
+
+    for (const auto& [depth, fanOut] : std::vector<std::pair<int, int>> { { 2, 4 }, { 3, 8 }, { 4, 8 }, { 3, 32 }, { 5, 8 } })
+        benchmark->Args ({ depth, fanOut });
+}
+
+// Payload sizes in bytes
+void addPayloadSizes (benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgName ("bytes")->RangeMultiplier (16)->Range (16, 1 << 20);
+}
+
+SyntheticTree makeTree (const benchmark::State& state)
+{
+    const auto depth = static_cast<int> (state.range (0));
+    const auto fanOut = static_cast<int> (state.range (1));
+
+    return SyntheticTree (SyntheticTree::getNumNodesForDepth (depth, fanOut), fanOut);
+}
+
+juce::String makeJsonPayload (std::size_t numBytes)
+{
+    juce::String data = "{\"id\":\"";
+    data << juce::String::repeatedString ("x", juce::jmax (0, static_cast<int> (numBytes) - 9)) << "\"}";
+    return data;
+}
+
+juce::String makeHttpRequest (const juce::String& body)
+{
+    juce::String request;
+
+    request
+        << "GET /straw/component/info HTTP/1.1\r\n"
+        << "Host: localhost\r\n"
+        << "Content-Type: application/json\r\n"
+        << "Content-Length: " << body.getNumBytesAsUTF8() << "\r\n"
+        << "\r\n"
+        << body;
+
+    return request;
+}
+
+} // namespace
+
+//=================================================================================================
+
+static void BM_FindComponentById (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto lastNodeID = SyntheticTree::getNodeID (tree.getNumNodes() - 1);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::findComponentById (lastNodeID));
+
+    state.counters ["nodes"] = tree.getNumNodes();
+}
+BENCHMARK (BM_FindComponentById)->Apply (addTreeShapes);
+
+static void BM_FindComponentByIdMissing (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::findComponentById ("missing"));
+
+    state.counters ["nodes"] = tree.getNumNodes();
+}
+BENCHMARK (BM_FindComponentByIdMissing)->Apply (addTreeShapes);
+
+static void BM_FindComponentsByType (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::findComponentsByType ("juce::TextButton"));
+
+    state.counters ["nodes"] = tree.getNumNodes();
+}
+BENCHMARK (BM_FindComponentsByType)->Apply (addTreeShapes);
+
+//=================================================================================================
+
+static void BM_MakeComponentInfoFlat (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto root = straw::Helpers::findComponentById (SyntheticTree::getNodeID (0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::makeComponentInfo (root, false));
+}
+BENCHMARK (BM_MakeComponentInfoFlat)->Apply (addTreeShapes);
+
+static void BM_MakeComponentInfoRecursive (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto root = straw::Helpers::findComponentById (SyntheticTree::getNodeID (0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::makeComponentInfo (root, true));
+
+    state.counters ["nodes"] = tree.getNumNodes();
+}
+BENCHMARK (BM_MakeComponentInfoRecursive)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+static void BM_ComponentInfoToJson (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto info = straw::Helpers::makeComponentInfo (straw::Helpers::findComponentById (SyntheticTree::getNodeID (0)), true);
+
+    std::size_t numBytes = 0;
+    for (auto _ : state)
+    {
+        auto json = juce::JSON::toString (info);
+        numBytes = json.getNumBytesAsUTF8();
+        benchmark::DoNotOptimize (json);
+    }
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * numBytes));
+}
+BENCHMARK (BM_ComponentInfoToJson)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+static void BM_ComponentInfoToWireFormat (benchmark::State& state, straw::WireFormat format)
+{
+    auto tree = makeTree (state);
+    auto info = straw::Helpers::makeComponentInfo (straw::Helpers::findComponentById (SyntheticTree::getNodeID (0)), true);
+
+    std::size_t numBytes = 0;
+    for (auto _ : state)
+    {
+        auto data = straw::encodeVar (info, format);
+        numBytes = data.getSize();
+        benchmark::DoNotOptimize (data);
+    }
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * numBytes));
+}
+BENCHMARK_CAPTURE (BM_ComponentInfoToWireFormat, msgpack, straw::WireFormat::msgpack)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+BENCHMARK_CAPTURE (BM_ComponentInfoToWireFormat, cbor, straw::WireFormat::cbor)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+static void BM_ComponentInfoFromWireFormat (benchmark::State& state, straw::WireFormat format)
+{
+    auto tree = makeTree (state);
+    auto info = straw::Helpers::makeComponentInfo (straw::Helpers::findComponentById (SyntheticTree::getNodeID (0)), true);
+    auto data = straw::encodeVar (info, format);
+
+    for (auto _ : state)
+    {
+        juce::var result;
+        auto decodeResult = straw::decodeVar (data.getData(), data.getSize(), format, result);
+        benchmark::DoNotOptimize (decodeResult);
+        benchmark::DoNotOptimize (result);
+    }
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * data.getSize()));
+}
+BENCHMARK_CAPTURE (BM_ComponentInfoFromWireFormat, json, straw::WireFormat::json)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+BENCHMARK_CAPTURE (BM_ComponentInfoFromWireFormat, msgpack, straw::WireFormat::msgpack)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+BENCHMARK_CAPTURE (BM_ComponentInfoFromWireFormat, cbor, straw::WireFormat::cbor)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+//=================================================================================================
+
+static void BM_RenderComponentToImage (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto root = straw::Helpers::findComponentById (SyntheticTree::getNodeID (0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Helpers::renderComponentToImage (root, true));
+}
+BENCHMARK (BM_RenderComponentToImage)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+static void BM_RenderComponentToPng (benchmark::State& state)
+{
+    auto tree = makeTree (state);
+    auto root = straw::Helpers::findComponentById (SyntheticTree::getNodeID (0));
+
+    for (auto _ : state)
+    {
+        auto image = straw::Helpers::renderComponentToImage (root, true);
+
+        juce::MemoryBlock data;
+        juce::MemoryOutputStream output (data, false);
+
+        juce::PNGImageFormat pngFormat;
+        pngFormat.writeImageToStream (image, output);
+        output.flush();
+
+        benchmark::DoNotOptimize (data);
+    }
+}
+BENCHMARK (BM_RenderComponentToPng)->Apply (addTreeShapes)->Unit (benchmark::kMillisecond);
+
+//=================================================================================================
+
+static void BM_ParseHttpPayload (benchmark::State& state)
+{
+    const auto request = makeHttpRequest (makeJsonPayload (static_cast<std::size_t> (state.range (0))));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Http::parseHttpPayload (request));
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * request.getNumBytesAsUTF8()));
+}
+BENCHMARK (BM_ParseHttpPayload)->Apply (addPayloadSizes);
+
+static void BM_MakeHttpResponseText (benchmark::State& state)
+{
+    const auto payload = makeJsonPayload (static_cast<std::size_t> (state.range (0)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Http::makeHttpResponse (payload, "plain/text", 200));
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * payload.getNumBytesAsUTF8()));
+}
+BENCHMARK (BM_MakeHttpResponseText)->Apply (addPayloadSizes);
+
+static void BM_MakeHttpResponseBinary (benchmark::State& state)
+{
+    const auto payload = juce::MemoryBlock (static_cast<std::size_t> (state.range (0)), true);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize (straw::Http::makeHttpResponse (payload, "application/octet-stream", 200));
+
+    state.SetBytesProcessed (static_cast<int64_t> (state.iterations() * payload.getSize()));
+}
+BENCHMARK (BM_MakeHttpResponseBinary)->Apply (addPayloadSizes);
+
+//=================================================================================================
+
+int main (int argc, char* argv[])
+{
+    straw::setHeadlessModeEnabled (true);
+
+    // The helpers expect to run on the message thread, which is the main thread here
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    benchmark::Initialize (&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments (argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
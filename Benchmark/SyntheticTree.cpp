@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "SyntheticTree.h"
+
+//=================================================================================================
+
+class SyntheticTree::Node : public juce::Component
+{
+public:
+    explicit Node (int nodeIndex)
+        : index (nodeIndex)
+    {
+        setComponentID (getNodeID (nodeIndex));
+        setOpaque (true);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        g.fillAll (juce::Colour::fromHSV (static_cast<float> (index % 360) / 360.0f, 0.5f, 0.8f, 1.0f));
+
+        g.setColour (juce::Colours::black);
+        g.drawRect (getLocalBounds());
+    }
+
+private:
+    const int index;
+};
+
+//=================================================================================================
+
+SyntheticTree::SyntheticTree (int numNodes, int fanOut)
+{
+    jassert (numNodes > 0);
+    jassert (fanOut > 0);
+
+    nodes.reserve (static_cast<std::size_t> (numNodes));
+
+    for (int index = 0; index < numNodes; ++index)
+    {
+        std::unique_ptr<Node> node;
+        if (index == 0)
+            node = std::make_unique<straw::Headless<Node>> (index);
+        else
+            node = std::make_unique<Node> (index);
+
+        if (index == 0)
+        {
+            node->setBounds (0, 0, 1024, 768);
+        }
+        else
+        {
+            const int slot = (index - 1) % fanOut;
+            node->setBounds ((slot % 4) * 16, (slot / 4) * 16, 64, 64);
+
+            nodes [static_cast<std::size_t> ((index - 1) / fanOut)]->addAndMakeVisible (*node);
+        }
+
+        nodes.push_back (std::move (node));
+    }
+
+    nodes.front()->addToDesktop (juce::ComponentPeer::windowIsTemporary);
+}
+
+SyntheticTree::~SyntheticTree()
+{
+    if (! nodes.empty())
+        nodes.front()->removeFromDesktop();
+
+    // Delete the children before their parents
+    while (! nodes.empty())
+        nodes.pop_back();
+}
+
+int SyntheticTree::getNumNodes() const
+{
+    return static_cast<int> (nodes.size());
+}
+
+juce::String SyntheticTree::getNodeID (int index)
+{
+    return "node_" + juce::String (index);
+}
+
+int SyntheticTree::getNumNodesForDepth (int depth, int fanOut)
+{
+    int numNodes = 0;
+
+    for (int level = 0, numLevelNodes = 1; level <= depth; ++level, numLevelNodes *= fanOut)
+        numNodes += numLevelNodes;
+
+    return numNodes;
+}
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "JuceHeader.h"
+
+#include <memory>
+#include <vector>
+
+//=================================================================================================
+
+/**
+ * @brief A synthetic component tree of configurable size, placed on the desktop so the automation server can find it.
+ *
+ * The root uses a headless peer when the headless mode is enabled, so no display server is needed.
+ *
+ * Nodes are laid out breadth first, each node having up to `fanOut` children, and are identified as `node_<index>`.
+ */
+class SyntheticTree
+{
+public:
+    SyntheticTree (int numNodes, int fanOut);
+    ~SyntheticTree();
+
+    int getNumNodes() const;
+
+    static juce::String getNodeID (int index);
+    static int getNumNodesForDepth (int depth, int fanOut);
+
+private:
+    class Node;
+
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    JUCE_DECLARE_NON_COPYABLE (SyntheticTree)
+};
@@ -41,20 +41,24 @@ public:
 
     void initialise (const String&) override
     {
+        juce::LookAndFeel::setDefaultLookAndFeel (&lookAndFeel);
+
         mainWindow.reset (new MainWindow ("SimpleAutomationDemo", new AutomationDemo(), *this));
     }
 
     void shutdown() override
     {
         mainWindow = nullptr;
+
+        juce::LookAndFeel::setDefaultLookAndFeel (nullptr);
     }
 
 private:
-    class MainWindow : public juce::DocumentWindow
+    class MainWindow : public straw::Headless<juce::DocumentWindow>
     {
     public:
         MainWindow (const juce::String& name, juce::Component* c, juce::JUCEApplication& a)
-            : juce::DocumentWindow (name, juce::Desktop::getInstance().getDefaultLookAndFeel()
+            : straw::Headless<juce::DocumentWindow> (name, juce::Desktop::getInstance().getDefaultLookAndFeel()
                                           .findColour (juce::ResizableWindow::backgroundColourId),
                                     juce::DocumentWindow::allButtons),
               app (a)
@@ -91,6 +95,7 @@ private:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainWindow)
     };
 
+    straw::HeadlessLookAndFeel<> lookAndFeel;
     std::unique_ptr<MainWindow> mainWindow;
 };
 
@@ -0,0 +1,81 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+"""
+Check the path parameters and the method matching of the router of a running demo.
+
+Like `client_wire_formats.py`, whose helpers it reuses, this script runs outside of the application:
+
+    python3 Demo/Scripts/client_router.py --port 8001
+"""
+
+import argparse
+import json
+import sys
+
+from client_wire_formats import BUTTON_ID, check, send_request
+
+
+def call(port, method, path, data=None):
+    body = json.dumps(data).encode("utf-8") if data is not None else b""
+    status, _, payload = send_request(port, path, body, "application/json", method=method)
+    return status, json.loads(payload) if payload else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the router of the straw demo.")
+    parser.add_argument("--port", type=int, default=8001, help="port of the demo")
+    args = parser.parse_args()
+
+    # Path parameters are exposed to the endpoints like body properties
+    status, response = call(args.port, "GET", f"/straw/component/{BUTTON_ID}/exists")
+    check(status == 200 and response == { "result": True }, "the id path parameter finds the component")
+
+    status, response = call(args.port, "GET", "/straw/component/straw::Missing/exists")
+    check(status == 200 and response == { "result": False }, "the id path parameter reports missing components")
+
+    status, response = call(args.port, "GET", f"/straw/component/{BUTTON_ID}/info")
+    check(status == 200 and response["result"]["id"] == BUTTON_ID, "parameterised routes reach their endpoint")
+
+    # Path parameters take precedence over the body
+    status, response = call(args.port, "GET", f"/straw/component/{BUTTON_ID}/exists", { "id": "straw::Missing" })
+    check(status == 200 and response == { "result": True }, "path parameters override body properties")
+
+    # Routes registered for a method reject the others, unknown routes are not found
+    status, response = call(args.port, "POST", f"/straw/component/{BUTTON_ID}/exists")
+    check(status == 405 and "error" in response, "other methods are not allowed on GET routes")
+
+    status, response = call(args.port, "GET", f"/straw/component/{BUTTON_ID}/click")
+    check(status == 405, "other methods are not allowed on POST routes")
+
+    status, response = call(args.port, "GET", f"/straw/component/{BUTTON_ID}/unknown")
+    check(status == 404 and "error" in response, "unknown routes are not found")
+
+    # Routes registered without a method accept any of them
+    status, response = call(args.port, "GET", "/straw/component/exists", { "id": BUTTON_ID })
+    check(status == 200 and response == { "result": True }, "routes without a method accept GET")
+
+    status, response = call(args.port, "POST", "/straw/component/exists", { "id": BUTTON_ID })
+    check(status == 200 and response == { "result": True }, "routes without a method accept POST")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
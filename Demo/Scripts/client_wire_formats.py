@@ -0,0 +1,276 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+"""
+Check the negotiation of the MessagePack and CBOR wire formats of a running demo.
+
+Unlike the other scripts in this directory, this one runs outside of the application, as a client of the automation
+server, with no dependencies besides the python standard library:
+
+    python3 Demo/Scripts/client_wire_formats.py --port 8001
+"""
+
+import argparse
+import json
+import socket
+import struct
+import sys
+
+
+BUTTON_ID = "straw::AutomationDemo::TextButton"
+
+
+# MessagePack subset used by the automation server ==================================================================
+
+def msgpack_encode(value):
+    if value is None:
+        return b"\xc0"
+    if value is True:
+        return b"\xc3"
+    if value is False:
+        return b"\xc2"
+    if isinstance(value, int):
+        return struct.pack(">Bq", 0xd3, value) if value < 0 or value > 127 else bytes([value])
+    if isinstance(value, float):
+        return struct.pack(">Bd", 0xcb, value)
+    if isinstance(value, str):
+        data = value.encode("utf-8")
+        return (bytes([0xa0 | len(data)]) if len(data) < 32 else struct.pack(">BI", 0xdb, len(data))) + data
+    if isinstance(value, list):
+        return struct.pack(">BI", 0xdd, len(value)) + b"".join(msgpack_encode(item) for item in value)
+    if isinstance(value, dict):
+        return struct.pack(">BI", 0xdf, len(value)) + b"".join(msgpack_encode(k) + msgpack_encode(v) for k, v in value.items())
+    raise TypeError(f"unsupported type {type(value)}")
+
+
+def msgpack_decode(data, offset=0):
+    tag = data[offset]
+    offset += 1
+
+    def read(fmt):
+        nonlocal offset
+        result = struct.unpack_from(fmt, data, offset)[0]
+        offset += struct.calcsize(fmt)
+        return result
+
+    def read_bytes(size):
+        nonlocal offset
+        offset += size
+        return data[offset - size:offset]
+
+    def read_items(count):
+        nonlocal offset
+        items = []
+        for _ in range(count):
+            item, offset = msgpack_decode(data, offset)
+            items.append(item)
+        return items
+
+    if tag <= 0x7f:
+        return tag, offset
+    if tag >= 0xe0:
+        return tag - 0x100, offset
+    if 0x80 <= tag <= 0x8f:
+        items = read_items(2 * (tag & 0x0f))
+        return dict(zip(items[0::2], items[1::2])), offset
+    if 0x90 <= tag <= 0x9f:
+        return read_items(tag & 0x0f), offset
+    if 0xa0 <= tag <= 0xbf:
+        return read_bytes(tag & 0x1f).decode("utf-8"), offset
+
+    simple = { 0xc0: None, 0xc2: False, 0xc3: True }
+    if tag in simple:
+        return simple[tag], offset
+
+    binaries = { 0xc4: ">B", 0xc5: ">H", 0xc6: ">I" }
+    if tag in binaries:
+        return bytes(read_bytes(read(binaries[tag]))), offset
+
+    strings = { 0xd9: ">B", 0xda: ">H", 0xdb: ">I" }
+    if tag in strings:
+        return read_bytes(read(strings[tag])).decode("utf-8"), offset
+
+    numbers = { 0xca: ">f", 0xcb: ">d", 0xcc: ">B", 0xcd: ">H", 0xce: ">I", 0xcf: ">Q",
+                0xd0: ">b", 0xd1: ">h", 0xd2: ">i", 0xd3: ">q" }
+    if tag in numbers:
+        return read(numbers[tag]), offset
+
+    if tag in (0xdc, 0xdd):
+        return read_items(read(">H" if tag == 0xdc else ">I")), offset
+    if tag in (0xde, 0xdf):
+        items = read_items(2 * read(">H" if tag == 0xde else ">I"))
+        return dict(zip(items[0::2], items[1::2])), offset
+
+    raise ValueError(f"unsupported msgpack tag {tag:#x}")
+
+
+# CBOR subset used by the automation server =========================================================================
+
+def cbor_encode_head(major, length):
+    if length < 24:
+        return bytes([(major << 5) | length])
+    return struct.pack(">BQ", (major << 5) | 27, length)
+
+
+def cbor_encode(value):
+    if value is None:
+        return b"\xf6"
+    if value is True:
+        return b"\xf5"
+    if value is False:
+        return b"\xf4"
+    if isinstance(value, int):
+        return cbor_encode_head(0, value) if value >= 0 else cbor_encode_head(1, -1 - value)
+    if isinstance(value, float):
+        return struct.pack(">Bd", 0xfb, value)
+    if isinstance(value, str):
+        data = value.encode("utf-8")
+        return cbor_encode_head(3, len(data)) + data
+    if isinstance(value, list):
+        return cbor_encode_head(4, len(value)) + b"".join(cbor_encode(item) for item in value)
+    if isinstance(value, dict):
+        return cbor_encode_head(5, len(value)) + b"".join(cbor_encode(k) + cbor_encode(v) for k, v in value.items())
+    raise TypeError(f"unsupported type {type(value)}")
+
+
+def cbor_decode(data, offset=0):
+    major = data[offset] >> 5
+    info = data[offset] & 0x1f
+    offset += 1
+
+    if major == 7:
+        simple = { 20: False, 21: True, 22: None, 23: None }
+        if info in simple:
+            return simple[info], offset
+        floats = { 25: (">e", 2), 26: (">f", 4), 27: (">d", 8) }
+        if info in floats:
+            fmt, size = floats[info]
+            return struct.unpack_from(fmt, data, offset)[0], offset + size
+        raise ValueError(f"unsupported cbor simple value {info}")
+
+    if info < 24:
+        argument = info
+    elif info <= 27:
+        size = 1 << (info - 24)
+        argument = int.from_bytes(data[offset:offset + size], "big")
+        offset += size
+    else:
+        raise ValueError("indefinite cbor lengths are not supported")
+
+    if major == 0:
+        return argument, offset
+    if major == 1:
+        return -1 - argument, offset
+    if major in (2, 3):
+        payload = data[offset:offset + argument]
+        return (bytes(payload) if major == 2 else payload.decode("utf-8")), offset + argument
+
+    items = []
+    for _ in range(argument * (2 if major == 5 else 1)):
+        item, offset = cbor_decode(data, offset)
+        items.append(item)
+
+    if major == 4:
+        return items, offset
+    if major == 5:
+        return dict(zip(items[0::2], items[1::2])), offset
+
+    raise ValueError(f"unsupported cbor major type {major}")
+
+
+# Requests ==========================================================================================================
+
+def send_request(port, path, body, content_type, accept=None, method="POST"):
+    request_headers = [
+        f"{method} {path} HTTP/1.1",
+        "Host: localhost",
+        f"Content-Type: {content_type}",
+        f"Content-Length: {len(body)}",
+    ]
+
+    if accept:
+        request_headers.append(f"Accept: {accept}")
+
+    with socket.create_connection(("127.0.0.1", port)) as connection:
+        connection.sendall(("\r\n".join(request_headers) + "\r\n\r\n").encode("utf-8") + body)
+        connection.shutdown(socket.SHUT_WR)
+
+        chunks = []
+        while True:
+            chunk = connection.recv(65536)
+            if not chunk:
+                break
+            chunks.append(chunk)
+
+    header_data, _, payload = b"".join(chunks).partition(b"\n\n")
+    lines = header_data.decode("utf-8").splitlines()
+
+    headers = {}
+    for line in lines[1:]:
+        key, separator, value = line.partition(":")
+        if separator:
+            headers[key.strip().lower()] = value.strip()
+
+    return int(lines[0].split()[1]), headers.get("content-type", ""), payload
+
+
+def check(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+    print(f"ok: {message}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check the wire format negotiation of the straw demo.")
+    parser.add_argument("--port", type=int, default=8001, help="port of the demo")
+    args = parser.parse_args()
+
+    request = { "id": BUTTON_ID }
+
+    # Responses default to the format of the request body
+    status, content_type, payload = send_request(args.port, "/straw/component/exists", msgpack_encode(request), "application/msgpack")
+    check(status == 200 and content_type == "application/msgpack", "msgpack requests get msgpack responses")
+    check(msgpack_decode(payload)[0] == { "result": True }, "msgpack responses decode to the result")
+
+    status, content_type, payload = send_request(args.port, "/straw/component/exists", cbor_encode(request), "application/cbor")
+    check(status == 200 and content_type == "application/cbor", "cbor requests get cbor responses")
+    check(cbor_decode(payload)[0] == { "result": True }, "cbor responses decode to the result")
+
+    # The first supported type of the Accept header wins over the request body format
+    status, content_type, payload = send_request(args.port, "/straw/component/exists", json.dumps(request).encode("utf-8"),
+                                                 "application/json", accept="text/html, application/cbor, application/msgpack")
+    check(status == 200 and content_type == "application/cbor", "the first supported accepted type is negotiated")
+    check(cbor_decode(payload)[0] == { "result": True }, "negotiated responses decode to the result")
+
+    status, content_type, payload = send_request(args.port, "/straw/component/exists", msgpack_encode(request),
+                                                 "application/msgpack", accept="application/json")
+    check(status == 200 and content_type == "application/json", "json can be accepted for binary requests")
+    check(json.loads(payload) == { "result": True }, "json responses decode to the result")
+
+    # Malformed bodies are rejected in the format they were sent in
+    status, content_type, payload = send_request(args.port, "/straw/component/exists", b"\xc1", "application/msgpack")
+    check(status == 500 and content_type == "application/msgpack", "malformed msgpack bodies are rejected")
+    check("error" in msgpack_decode(payload)[0], "rejections carry an error")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
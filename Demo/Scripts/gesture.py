@@ -0,0 +1,35 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+import straw
+
+straw.log ("Testing playGesture")
+
+slider = straw.findComponentById ("straw::AutomationDemo::Slider")
+initialValue = slider.getValue()
+
+straw.playGesture ({
+    "id": "straw::AutomationDemo::Slider",
+    "events": [
+        { "type": "drag", "t": 0, "from": { "x": 0.1, "y": 0.5 }, "to": { "x": 0.9, "y": 0.5 }, "relative": True, "duration": 200, "rate": 1000 },
+        { "type": "wheel", "t": 250, "x": 0.5, "y": 0.5, "relative": True, "deltaY": -0.25 }
+    ]
+})
+
+straw.assertNotEqual (slider.getValue(), initialValue)
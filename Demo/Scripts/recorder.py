@@ -0,0 +1,53 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+import os
+import tempfile
+
+import straw
+
+straw.log ("Testing startRecording, stopRecording and replayRecording")
+
+editor = straw.findComponentById ("straw::AutomationDemo::TextEditor")
+editor.clear()
+
+# Keys are consumed by the focused text editor, the recorder must still see them
+straw.startRecording()
+
+straw.playGesture ({
+    "id": "straw::AutomationDemo::TextEditor",
+    "events": [
+        { "type": "click", "t": 0, "x": 0.5, "y": 0.5, "relative": True, "duration": 20 },
+        { "type": "text", "t": 100, "text": "straw", "interval": 20 }
+    ]
+})
+
+recordingFile = os.path.join (tempfile.gettempdir(), "straw_recording.bin")
+numEvents = straw.stopRecording (recordingFile)
+
+straw.assertEqual (editor.getText(), "straw")
+straw.assertGreaterThanEqual (numEvents, 7)
+
+# Replaying the binary log ten times faster types the same text again
+editor.clear()
+straw.replayRecording (recordingFile, 10.0)
+
+straw.assertEqual (editor.getText(), "straw")
+
+os.remove (recordingFile)
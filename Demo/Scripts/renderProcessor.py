@@ -0,0 +1,58 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+import os
+import tempfile
+
+import straw
+
+straw.log ("Testing renderProcessor")
+
+request = {
+    "processor": "gain",
+    "sampleRate": 48000,
+    "blockSize": 512,
+    "duration": 500,
+    "signal": { "type": "sine", "frequency": 440, "gain": 0.5 },
+    "sweeps": [{ "parameter": "gain", "from": 0.0, "to": 1.0, "steps": 5 }],
+    "golden": os.path.join (tempfile.gettempdir(), "straw_goldens"),
+    "tolerance": 1e-6
+}
+
+# Record the golden files of the sweep, then render it again and compare
+recorded = straw.renderProcessor (dict (request, updateGolden = True))
+straw.assertTrue (recorded["passed"])
+straw.assertEqual (len (recorded["renders"]), 5)
+
+compared = straw.renderProcessor (request)
+straw.assertTrue (compared["passed"])
+
+for render in compared["renders"]:
+    straw.assertTrue (render["golden"]["passed"])
+    straw.assertLessThanEqual (render["golden"]["max_difference"], 1e-6)
+    straw.assertGreaterThan (render["realtime_factor"], 1.0)
+
+# The output follows the swept gain
+peaks = [render["channels"][0]["peak"] for render in compared["renders"]]
+straw.assertLessThan (peaks[0], 1e-6)
+straw.assertGreaterThan (peaks[-1], 0.49)
+
+# A different input doesn't match the golden files anymore
+mismatched = straw.renderProcessor (dict (request, signal = { "type": "sine", "frequency": 880, "gain": 0.5 }))
+straw.assertFalse (mismatched["passed"])
@@ -40,6 +40,90 @@ PYBIND11_EMBEDDED_MODULE(custom, m)
 
 //=================================================================================================
 
+GainProcessor::GainProcessor()
+    : juce::AudioProcessor (BusesProperties()
+        .withInput ("Input", juce::AudioChannelSet::stereo())
+        .withOutput ("Output", juce::AudioChannelSet::stereo()))
+{
+    addParameter (gain = new juce::AudioParameterFloat (juce::ParameterID { "gain", 1 }, "Gain", 0.0f, 1.0f, 0.5f));
+}
+
+const juce::String GainProcessor::getName() const
+{
+    return "Gain";
+}
+
+void GainProcessor::prepareToPlay (double, int)
+{
+}
+
+void GainProcessor::releaseResources()
+{
+}
+
+void GainProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    buffer.applyGain (gain->get());
+}
+
+double GainProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+bool GainProcessor::acceptsMidi() const
+{
+    return false;
+}
+
+bool GainProcessor::producesMidi() const
+{
+    return false;
+}
+
+juce::AudioProcessorEditor* GainProcessor::createEditor()
+{
+    return nullptr;
+}
+
+bool GainProcessor::hasEditor() const
+{
+    return false;
+}
+
+int GainProcessor::getNumPrograms()
+{
+    return 1;
+}
+
+int GainProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void GainProcessor::setCurrentProgram (int)
+{
+}
+
+const juce::String GainProcessor::getProgramName (int)
+{
+    return {};
+}
+
+void GainProcessor::changeProgramName (int, const juce::String&)
+{
+}
+
+void GainProcessor::getStateInformation (juce::MemoryBlock&)
+{
+}
+
+void GainProcessor::setStateInformation (const void*, int)
+{
+}
+
+//=================================================================================================
+
 AutomationDemo::AutomationDemo()
 {
     setOpaque (true);
@@ -55,6 +139,9 @@ AutomationDemo::AutomationDemo()
     slider.setComponentID ("straw::AutomationDemo::Slider");
     slider.setSliderStyle (juce::Slider::LinearBar);
 
+    addAndMakeVisible (textEditor);
+    textEditor.setComponentID ("straw::AutomationDemo::TextEditor");
+
     setSize (300, 600);
 
     automationServer.registerDefaultEndpoints();
@@ -64,7 +151,7 @@ AutomationDemo::AutomationDemo()
     {
         auto colour = juce::Colour::fromString (request.data.getProperty ("colour", "FF00FF00").toString());
 
-        juce::MessageManager::callAsync ([weakThis, colour, connection = std::move (request.connection)]
+        straw::callOnMessageThread ([weakThis, colour, connection = std::move (request.connection)]
         {
             if (auto self = weakThis.getComponent())
             {
@@ -84,9 +171,41 @@ AutomationDemo::AutomationDemo()
     automationServer.registerCustomPythonModules ({ "custom" });
     automationServer.registerComponentType ("CustomSlider", &popsicle::ComponentType<CustomSlider>);
 
-    auto result = automationServer.start (8001);
-    if (result.failed())
-        juce::Logger::writeToLog (result.getErrorMessage());
+    // Tests restore the demo to the state it has at startup, instead of relaunching it
+    auto snapshots = straw::StateSnapshots::getInstance();
+    snapshots->addComponentPropertiesProvider ("demo.properties", *this);
+    snapshots->addProvider ("demo.slider",
+        [weakThis]
+        {
+            juce::MemoryBlock data;
+
+            if (auto self = weakThis.getComponent())
+            {
+                juce::MemoryOutputStream output (data, false);
+                output.writeDouble (self->slider.getValue());
+                output.writeBool (self->slider.isVisible());
+            }
+
+            return data;
+        },
+        [weakThis] (const juce::MemoryBlock& data)
+        {
+            auto self = weakThis.getComponent();
+            if (self == nullptr)
+                return juce::Result::fail ("demo has been deleted");
+
+            juce::MemoryInputStream input (data, false);
+            self->slider.setValue (input.readDouble());
+            self->slider.setVisible (input.readBool());
+
+            return juce::Result::ok();
+        });
+    snapshots->capture ("baseline");
+
+    // Regression tests render the processors of the application offline
+    straw::OfflineRenderer::getInstance()->registerProcessor ("gain", [] { return std::make_unique<GainProcessor>(); });
+
+    automationServer.startAsync (8001);
 }
 
 AutomationDemo::~AutomationDemo()
@@ -109,6 +228,7 @@ void AutomationDemo::resized()
     slider.setBounds (10, 50, 200, 30);
 
     dynamicComponent.setBounds (10, 100, 200, 30);
+    textEditor.setBounds (10, 140, 200, 30);
 }
 
 void AutomationDemo::parentHierarchyChanged()
@@ -35,9 +35,40 @@ public:
 
 //=================================================================================================
 
+class GainProcessor : public juce::AudioProcessor
+{
+public:
+    GainProcessor();
+
+    // juce::AudioProcessor
+    const juce::String getName() const override;
+    void prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    double getTailLengthSeconds() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+private:
+    juce::AudioParameterFloat* gain = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainProcessor)
+};
+
+//=================================================================================================
+
 class AutomationDemo
     : public juce::Component
-    , public juce::Timer
+    , public straw::WarpableTimer
     , public juce::Button::Listener
 {
 public:
@@ -49,7 +80,7 @@ public:
     void resized() override;
     void parentHierarchyChanged() override;
 
-    // juce::Timer
+    // straw::WarpableTimer
     void timerCallback() override;
 
     // juce::Button::Listener
@@ -59,6 +90,7 @@ private:
     juce::TextButton textButton;
     juce::TextButton dynamicComponent;
     CustomSlider slider;
+    juce::TextEditor textEditor;
 
     straw::AutomationServer automationServer;
 
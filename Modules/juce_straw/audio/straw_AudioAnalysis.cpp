@@ -0,0 +1,337 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_AudioAnalysis.h"
+
+#include "../diagnostics/straw_SessionTracer.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+double sumOfSquares (const float* data, int numSamples) noexcept
+{
+    double sum = 0.0;
+    int index = 0;
+
+    // Scalar head until the data is aligned for the SIMD registers
+    const auto alignedData = SIMDFloat::getNextSIMDAlignedPtr (const_cast<float*> (data));
+    for (const auto numHeadSamples = juce::jmin (numSamples, static_cast<int> (alignedData - data)); index < numHeadSamples; ++index)
+        sum += static_cast<double> (data [index]) * data [index];
+
+    // Lanes are flushed to the double sum regularly, so long buffers don't lose precision
+    constexpr int samplesPerFlush = 4096 * static_cast<int> (SIMDFloat::SIMDNumElements);
+
+    while (index + static_cast<int> (SIMDFloat::SIMDNumElements) <= numSamples)
+    {
+        auto accumulator = SIMDFloat::expand (0.0f);
+
+        const auto flushIndex = juce::jmin (numSamples - static_cast<int> (SIMDFloat::SIMDNumElements) + 1, index + samplesPerFlush);
+        for (; index < flushIndex; index += static_cast<int> (SIMDFloat::SIMDNumElements))
+        {
+            const auto values = SIMDFloat::fromRawArray (data + index);
+            accumulator += values * values;
+        }
+
+        sum += accumulator.sum();
+    }
+
+    for (; index < numSamples; ++index)
+        sum += static_cast<double> (data [index]) * data [index];
+
+    return sum;
+}
+
+std::vector<float> mixToMono (const juce::AudioBuffer<float>& buffer)
+{
+    std::vector<float> mono (static_cast<std::size_t> (buffer.getNumSamples()), 0.0f);
+
+    if (buffer.getNumChannels() == 0 || mono.empty())
+        return mono;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        juce::FloatVectorOperations::add (mono.data(), buffer.getReadPointer (channel), buffer.getNumSamples());
+
+    juce::FloatVectorOperations::multiply (mono.data(), 1.0f / static_cast<float> (buffer.getNumChannels()), buffer.getNumSamples());
+
+    return mono;
+}
+
+int getFFTOrderForSize (int size)
+{
+    int order = 0;
+    while ((1 << order) < size)
+        ++order;
+
+    return order;
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::var AudioLevels::toVar() const
+{
+    juce::Array<juce::var> channels;
+
+    for (std::size_t channel = 0; channel < rms.size(); ++channel)
+    {
+        juce::DynamicObject::Ptr object = new juce::DynamicObject;
+        object->setProperty ("rms", rms [channel]);
+        object->setProperty ("rms_db", juce::Decibels::gainToDecibels (rms [channel]));
+        object->setProperty ("peak", peak [channel]);
+        object->setProperty ("peak_db", juce::Decibels::gainToDecibels (peak [channel]));
+        channels.add (object.get());
+    }
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("channels", std::move (channels));
+    return object.get();
+}
+
+juce::var AudioSpectrum::toVar() const
+{
+    juce::Array<juce::var> peaksArray;
+
+    for (const auto& peak : peaks)
+    {
+        juce::DynamicObject::Ptr object = new juce::DynamicObject;
+        object->setProperty ("frequency", peak.frequency);
+        object->setProperty ("level_db", peak.levelDecibels);
+        peaksArray.add (object.get());
+    }
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("dominant_frequency", dominantFrequency);
+    object->setProperty ("centroid", centroid);
+    object->setProperty ("peaks", std::move (peaksArray));
+    return object.get();
+}
+
+juce::var AudioLatency::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("latency_samples", latencySamples);
+    object->setProperty ("latency_ms", latencyMilliseconds);
+    object->setProperty ("correlation", correlation);
+    return object.get();
+}
+
+} // namespace straw
+
+//=================================================================================================
+
+namespace straw::AudioAnalysis {
+
+AudioLevels measureLevels (const juce::AudioBuffer<float>& buffer)
+{
+    ScopedTraceSpan span ("audio", "measureLevels");
+
+    AudioLevels levels;
+
+    const auto numSamples = buffer.getNumSamples();
+    if (numSamples == 0)
+        return levels;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const auto data = buffer.getReadPointer (channel);
+        const auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+
+        levels.rms.push_back (static_cast<float> (std::sqrt (sumOfSquares (data, numSamples) / numSamples)));
+        levels.peak.push_back (juce::jmax (std::abs (range.getStart()), std::abs (range.getEnd())));
+    }
+
+    return levels;
+}
+
+juce::Result computeSpectrum (const juce::AudioBuffer<float>& buffer,
+                              double sampleRate,
+                              int fftOrder,
+                              int maxPeaks,
+                              AudioSpectrum& spectrum)
+{
+    ScopedTraceSpan span ("audio", "computeSpectrum");
+
+    if (fftOrder < 4 || fftOrder > 16)
+        return juce::Result::fail ("invalid fft order, must be between 4 and 16");
+
+    if (buffer.getNumSamples() == 0 || sampleRate <= 0.0)
+        return juce::Result::fail ("no audio to analyse");
+
+    const auto mono = mixToMono (buffer);
+    const auto numSamples = static_cast<int> (mono.size());
+
+    const auto fftSize = 1 << fftOrder;
+    const auto numBins = fftSize / 2 + 1;
+
+    juce::dsp::FFT fft (fftOrder);
+    juce::dsp::WindowingFunction<float> window (static_cast<std::size_t> (fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+
+    std::vector<float> frame (static_cast<std::size_t> (fftSize) * 2, 1.0f);
+    window.multiplyWithWindowingTable (frame.data(), static_cast<std::size_t> (fftSize));
+
+    double windowSum = 0.0;
+    for (int index = 0; index < fftSize; ++index)
+        windowSum += frame [static_cast<std::size_t> (index)];
+
+    // Half overlapping frames, the last one being zero padded
+    std::vector<float> magnitudes (static_cast<std::size_t> (numBins), 0.0f);
+    int numFrames = 0;
+
+    for (int start = 0; start < numSamples; start += fftSize / 2)
+    {
+        const auto numFrameSamples = juce::jmin (fftSize, numSamples - start);
+
+        std::fill (frame.begin(), frame.end(), 0.0f);
+        juce::FloatVectorOperations::copy (frame.data(), mono.data() + start, numFrameSamples);
+        window.multiplyWithWindowingTable (frame.data(), static_cast<std::size_t> (fftSize));
+
+        fft.performFrequencyOnlyForwardTransform (frame.data(), true);
+        juce::FloatVectorOperations::add (magnitudes.data(), frame.data(), numBins);
+        ++numFrames;
+
+        if (start + fftSize >= numSamples)
+            break;
+    }
+
+    // Scaled so a full scale sine reads as 0 dB
+    juce::FloatVectorOperations::multiply (magnitudes.data(), static_cast<float> (2.0 / (windowSum * numFrames)), numBins);
+
+    const auto binWidth = sampleRate / fftSize;
+
+    double weightedFrequencySum = 0.0;
+    double magnitudeSum = 0.0;
+    for (int bin = 1; bin < numBins; ++bin)
+    {
+        weightedFrequencySum += bin * binWidth * magnitudes [static_cast<std::size_t> (bin)];
+        magnitudeSum += magnitudes [static_cast<std::size_t> (bin)];
+    }
+
+    spectrum.centroid = magnitudeSum > 0.0 ? weightedFrequencySum / magnitudeSum : 0.0;
+    spectrum.peaks.clear();
+
+    std::vector<float> levels (magnitudes.size());
+    for (std::size_t bin = 0; bin < magnitudes.size(); ++bin)
+        levels [bin] = juce::Decibels::gainToDecibels (magnitudes [bin], -200.0f);
+
+    // Local maxima, refined by parabolic interpolation of the levels around them
+    for (std::size_t bin = 1; bin + 1 < levels.size(); ++bin)
+    {
+        const auto previous = levels [bin - 1];
+        const auto current = levels [bin];
+        const auto next = levels [bin + 1];
+
+        if (current <= previous || current < next || current <= -120.0f)
+            continue;
+
+        const auto denominator = previous - 2.0f * current + next;
+        const auto offset = denominator != 0.0f ? 0.5f * (previous - next) / denominator : 0.0f;
+
+        AudioSpectrum::Peak peak;
+        peak.frequency = (static_cast<double> (bin) + offset) * binWidth;
+        peak.levelDecibels = current - 0.25f * (previous - next) * offset;
+        spectrum.peaks.push_back (peak);
+    }
+
+    std::sort (spectrum.peaks.begin(), spectrum.peaks.end(), [] (const auto& lhs, const auto& rhs)
+    {
+        return lhs.levelDecibels > rhs.levelDecibels;
+    });
+
+    if (static_cast<int> (spectrum.peaks.size()) > maxPeaks)
+        spectrum.peaks.resize (static_cast<std::size_t> (juce::jmax (0, maxPeaks)));
+
+    spectrum.dominantFrequency = spectrum.peaks.empty() ? 0.0 : spectrum.peaks.front().frequency;
+
+    return juce::Result::ok();
+}
+
+juce::Result measureLatency (const juce::AudioBuffer<float>& reference,
+                             const juce::AudioBuffer<float>& signal,
+                             double sampleRate,
+                             int maxLatencySamples,
+                             AudioLatency& latency)
+{
+    ScopedTraceSpan span ("audio", "measureLatency");
+
+    const auto referenceMono = mixToMono (reference);
+    const auto signalMono = mixToMono (signal);
+
+    const auto numSamples = static_cast<int> (juce::jmin (referenceMono.size(), signalMono.size()));
+    if (numSamples == 0 || sampleRate <= 0.0)
+        return juce::Result::fail ("no audio to analyse");
+
+    if (sumOfSquares (referenceMono.data(), numSamples) <= 1.0e-12)
+        return juce::Result::fail ("reference signal is silent");
+
+    // Zero padded to twice the length, so the circular correlation doesn't wrap positive delays around
+    const auto fftOrder = getFFTOrderForSize (numSamples * 2);
+    const auto fftSize = 1 << fftOrder;
+
+    juce::dsp::FFT fft (fftOrder);
+
+    std::vector<float> referenceSpectrum (static_cast<std::size_t> (fftSize) * 2, 0.0f);
+    std::vector<float> crossSpectrum (static_cast<std::size_t> (fftSize) * 2, 0.0f);
+    juce::FloatVectorOperations::copy (referenceSpectrum.data(), referenceMono.data(), numSamples);
+    juce::FloatVectorOperations::copy (crossSpectrum.data(), signalMono.data(), numSamples);
+
+    fft.performRealOnlyForwardTransform (referenceSpectrum.data());
+    fft.performRealOnlyForwardTransform (crossSpectrum.data());
+
+    // The cross correlation is the inverse transform of the signal spectrum times the conjugate reference spectrum
+    auto referenceBins = reinterpret_cast<const std::complex<float>*> (referenceSpectrum.data());
+    auto crossBins = reinterpret_cast<std::complex<float>*> (crossSpectrum.data());
+    for (int bin = 0; bin < fftSize; ++bin)
+        crossBins [bin] *= std::conj (referenceBins [bin]);
+
+    fft.performRealOnlyInverseTransform (crossSpectrum.data());
+
+    const auto maxLag = juce::jlimit (0, numSamples - 1, maxLatencySamples);
+    const auto bestLag = static_cast<int> (std::max_element (crossSpectrum.begin(), crossSpectrum.begin() + maxLag + 1) - crossSpectrum.begin());
+
+    // Normalised over the overlapping parts, independently of the transform scaling
+    const auto numOverlappingSamples = numSamples - bestLag;
+
+    double dotProduct = 0.0;
+    for (int index = 0; index < numOverlappingSamples; ++index)
+        dotProduct += static_cast<double> (referenceMono [static_cast<std::size_t> (index)]) * signalMono [static_cast<std::size_t> (index + bestLag)];
+
+    const auto energy = std::sqrt (sumOfSquares (referenceMono.data(), numOverlappingSamples)
+                                   * sumOfSquares (signalMono.data() + bestLag, numOverlappingSamples));
+
+    latency.latencySamples = bestLag;
+    latency.latencyMilliseconds = bestLag * 1000.0 / sampleRate;
+    latency.correlation = energy > 0.0 ? static_cast<float> (dotProduct / energy) : 0.0f;
+
+    return juce::Result::ok();
+}
+
+} // namespace straw::AudioAnalysis
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The levels of each channel of a buffer.
+ */
+struct AudioLevels
+{
+    std::vector<float> rms;
+    std::vector<float> peak;
+
+    /**
+     * @brief Convert the levels to a var, with linear and decibel values.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+/**
+ * @brief The summary of the averaged spectrum of a buffer, mixed down to mono.
+ */
+struct AudioSpectrum
+{
+    struct Peak
+    {
+        double frequency = 0.0;
+        float levelDecibels = 0.0f;
+    };
+
+    double dominantFrequency = 0.0;
+    double centroid = 0.0;
+    std::vector<Peak> peaks;
+
+    /**
+     * @brief Convert the spectrum summary to a var.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+/**
+ * @brief The delay of a signal relative to a reference signal.
+ */
+struct AudioLatency
+{
+    int latencySamples = 0;
+    double latencyMilliseconds = 0.0;
+    float correlation = 0.0f;
+
+    /**
+     * @brief Convert the latency to a var.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+} // namespace straw
+
+//=================================================================================================
+
+/**
+ * @brief Server side analysis of captured audio, returning summary numbers instead of samples.
+ *
+ * The kernels use the SIMD registers of `juce::dsp` and the vectorised `juce::FloatVectorOperations`, and the spectra
+ * and correlations are computed with `juce::dsp::FFT`, so analysing seconds of audio takes a few milliseconds.
+ */
+namespace straw::AudioAnalysis {
+
+/**
+ * @brief Measure the RMS and peak levels of each channel.
+ */
+[[nodiscard]] AudioLevels measureLevels (const juce::AudioBuffer<float>& buffer);
+
+/**
+ * @brief Compute the spectrum averaged over overlapping Hann windowed frames, and summarise it.
+ *
+ * @param buffer The samples, mixed down to mono.
+ * @param sampleRate The sample rate of the samples.
+ * @param fftOrder The order of the FFT, the frames being 2 to the power of the order samples long.
+ * @param maxPeaks The maximum number of spectral peaks to return, loudest first.
+ * @param spectrum The spectrum summary to fill.
+ *
+ * @return The result of the operation.
+ */
+[[nodiscard]] juce::Result computeSpectrum (const juce::AudioBuffer<float>& buffer,
+                                            double sampleRate,
+                                            int fftOrder,
+                                            int maxPeaks,
+                                            AudioSpectrum& spectrum);
+
+/**
+ * @brief Measure the delay of a signal relative to a reference, from the peak of their cross correlation.
+ *
+ * @param reference The reference samples, mixed down to mono.
+ * @param signal The delayed samples, mixed down to mono, captured over the same time span as the reference.
+ * @param sampleRate The sample rate of the samples.
+ * @param maxLatencySamples The maximum delay to look for.
+ * @param latency The latency to fill, with the normalised correlation at that delay.
+ *
+ * @return The result of the operation, failing when the reference is silent.
+ */
+[[nodiscard]] juce::Result measureLatency (const juce::AudioBuffer<float>& reference,
+                                           const juce::AudioBuffer<float>& signal,
+                                           double sampleRate,
+                                           int maxLatencySamples,
+                                           AudioLatency& latency);
+
+} // namespace straw::AudioAnalysis
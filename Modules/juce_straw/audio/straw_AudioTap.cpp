@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_AudioTap.h"
+
+#include <algorithm>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+juce::CriticalSection& getAudioTapsLock()
+{
+    static juce::CriticalSection lock;
+    return lock;
+}
+
+juce::Array<AudioTap*>& getAudioTaps()
+{
+    static juce::Array<AudioTap*> taps;
+    return taps;
+}
+
+} // namespace
+
+//=================================================================================================
+
+AudioTap::Ring::Ring (int maxNumChannels, int capacityInSamples)
+    : samples (maxNumChannels, capacityInSamples)
+{
+    samples.clear();
+}
+
+void AudioTap::Ring::write (const float* const* channels, int numChannelsToWrite, int numSamples) noexcept
+{
+    const auto capacity = samples.getNumSamples();
+    const auto channelsToWrite = juce::jmin (numChannelsToWrite, samples.getNumChannels());
+
+    numChannels.store (channelsToWrite, std::memory_order_relaxed);
+
+    // Blocks larger than the ring only keep their most recent samples
+    const auto skippedSamples = juce::jmax (0, numSamples - capacity);
+    const auto position = writePosition.load (std::memory_order_relaxed) + skippedSamples;
+    const auto samplesToWrite = numSamples - skippedSamples;
+
+    // Readers check the samples they copied haven't been overwritten, against the end of the block being written
+    pendingWritePosition.store (position + samplesToWrite, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    const auto offset = static_cast<int> (position % capacity);
+    const auto firstChunkSize = juce::jmin (samplesToWrite, capacity - offset);
+
+    for (int channel = 0; channel < channelsToWrite; ++channel)
+    {
+        auto destination = samples.getWritePointer (channel);
+
+        if (const auto source = channels [channel])
+        {
+            juce::FloatVectorOperations::copy (destination + offset, source + skippedSamples, firstChunkSize);
+            juce::FloatVectorOperations::copy (destination, source + skippedSamples + firstChunkSize, samplesToWrite - firstChunkSize);
+        }
+        else
+        {
+            juce::FloatVectorOperations::clear (destination + offset, firstChunkSize);
+            juce::FloatVectorOperations::clear (destination, samplesToWrite - firstChunkSize);
+        }
+    }
+
+    writePosition.store (position + samplesToWrite, std::memory_order_release);
+}
+
+juce::AudioBuffer<float> AudioTap::Ring::read (int numSamples) const
+{
+    const auto capacity = samples.getNumSamples();
+    const auto endPosition = writePosition.load (std::memory_order_acquire);
+    const auto beginPosition = juce::jmax<juce::int64> (0, endPosition - juce::jlimit (0, capacity, numSamples));
+    const auto numChannelsToRead = numChannels.load (std::memory_order_relaxed);
+
+    juce::AudioBuffer<float> result (numChannelsToRead, static_cast<int> (endPosition - beginPosition));
+
+    const auto offset = static_cast<int> (beginPosition % capacity);
+    const auto firstChunkSize = juce::jmin (result.getNumSamples(), capacity - offset);
+
+    for (int channel = 0; channel < numChannelsToRead; ++channel)
+    {
+        result.copyFrom (channel, 0, samples, channel, offset, firstChunkSize);
+        result.copyFrom (channel, firstChunkSize, samples, channel, 0, result.getNumSamples() - firstChunkSize);
+    }
+
+    // The oldest samples might have been overwritten by the writer while being copied, they are dropped
+    std::atomic_thread_fence (std::memory_order_acquire);
+    const auto firstValidPosition = pendingWritePosition.load (std::memory_order_relaxed) - capacity;
+
+    if (firstValidPosition > beginPosition)
+    {
+        const auto numOverwrittenSamples = static_cast<int> (juce::jmin<juce::int64> (firstValidPosition - beginPosition, result.getNumSamples()));
+
+        juce::AudioBuffer<float> validResult (numChannelsToRead, result.getNumSamples() - numOverwrittenSamples);
+        for (int channel = 0; channel < numChannelsToRead; ++channel)
+            validResult.copyFrom (channel, 0, result, channel, numOverwrittenSamples, validResult.getNumSamples());
+
+        return validResult;
+    }
+
+    return result;
+}
+
+//=================================================================================================
+
+AudioTap::AudioTap (const juce::String& tapName, juce::AudioIODeviceCallback* callbackToWrap, int maxNumChannels, int capacityInSamples)
+    : name (tapName)
+    , wrappedCallback (callbackToWrap)
+    , inputRing (maxNumChannels, capacityInSamples)
+    , outputRing (maxNumChannels, capacityInSamples)
+{
+    jassert (maxNumChannels > 0);
+    jassert (capacityInSamples > 0);
+
+    auto lock = juce::CriticalSection::ScopedLockType (getAudioTapsLock());
+
+    // Taps are looked up by name, they must be unique
+    jassert (std::none_of (getAudioTaps().begin(), getAudioTaps().end(), [&] (auto tap) { return tap->getName() == name; }));
+
+    getAudioTaps().add (this);
+}
+
+AudioTap::~AudioTap()
+{
+    auto lock = juce::CriticalSection::ScopedLockType (getAudioTapsLock());
+
+    getAudioTaps().removeFirstMatchingValue (this);
+}
+
+//=================================================================================================
+
+const juce::String& AudioTap::getName() const noexcept
+{
+    return name;
+}
+
+double AudioTap::getSampleRate() const noexcept
+{
+    return sampleRate.load (std::memory_order_relaxed);
+}
+
+void AudioTap::setSampleRate (double newSampleRate) noexcept
+{
+    sampleRate.store (newSampleRate, std::memory_order_relaxed);
+}
+
+int AudioTap::getNumChannels (Stream stream) const noexcept
+{
+    return getRing (stream).numChannels.load (std::memory_order_relaxed);
+}
+
+juce::int64 AudioTap::getNumCapturedSamples (Stream stream) const noexcept
+{
+    return getRing (stream).writePosition.load (std::memory_order_relaxed);
+}
+
+void AudioTap::writeOutput (const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    outputRing.write (channels, numChannels, numSamples);
+}
+
+juce::AudioBuffer<float> AudioTap::read (Stream stream, int numSamples) const
+{
+    return getRing (stream).read (numSamples);
+}
+
+//=================================================================================================
+
+juce::StringArray AudioTap::getTapNames()
+{
+    auto lock = juce::CriticalSection::ScopedLockType (getAudioTapsLock());
+
+    juce::StringArray names;
+    for (auto tap : getAudioTaps())
+        names.add (tap->getName());
+
+    return names;
+}
+
+juce::Result AudioTap::readTap (const juce::String& tapName,
+                                Stream stream,
+                                juce::RelativeTime duration,
+                                juce::AudioBuffer<float>& buffer,
+                                double& tapSampleRate)
+{
+    auto lock = juce::CriticalSection::ScopedLockType (getAudioTapsLock());
+
+    for (auto tap : getAudioTaps())
+    {
+        if (tap->getName() != tapName)
+            continue;
+
+        tapSampleRate = tap->getSampleRate();
+        if (tapSampleRate <= 0.0)
+            return juce::Result::fail ("audio tap not started: " + tapName);
+
+        buffer = tap->read (stream, static_cast<int> (duration.inSeconds() * tapSampleRate));
+        if (buffer.getNumChannels() == 0 || buffer.getNumSamples() == 0)
+            return juce::Result::fail ("audio tap has not captured any audio: " + tapName);
+
+        return juce::Result::ok();
+    }
+
+    return juce::Result::fail ("audio tap not found: " + tapName);
+}
+
+std::optional<AudioTap::Stream> AudioTap::streamFromString (juce::StringRef streamName)
+{
+    if (streamName == "input")
+        return Stream::input;
+
+    if (streamName == "output")
+        return Stream::output;
+
+    return std::nullopt;
+}
+
+//=================================================================================================
+
+void AudioTap::audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                                 int numInputChannels,
+                                                 float* const* outputChannelData,
+                                                 int numOutputChannels,
+                                                 int numSamples,
+                                                 const juce::AudioIODeviceCallbackContext& context)
+{
+    if (wrappedCallback != nullptr)
+    {
+        wrappedCallback->audioDeviceIOCallbackWithContext (inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples, context);
+    }
+    else
+    {
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+        {
+            if (auto output = outputChannelData [channel])
+                juce::FloatVectorOperations::clear (output, numSamples);
+        }
+    }
+
+    inputRing.write (inputChannelData, numInputChannels, numSamples);
+    outputRing.write (outputChannelData, numOutputChannels, numSamples);
+}
+
+void AudioTap::audioDeviceAboutToStart (juce::AudioIODevice* device)
+{
+    setSampleRate (device->getCurrentSampleRate());
+
+    if (wrappedCallback != nullptr)
+        wrappedCallback->audioDeviceAboutToStart (device);
+}
+
+void AudioTap::audioDeviceStopped()
+{
+    if (wrappedCallback != nullptr)
+        wrappedCallback->audioDeviceStopped();
+}
+
+void AudioTap::audioDeviceError (const juce::String& errorMessage)
+{
+    if (wrappedCallback != nullptr)
+        wrappedCallback->audioDeviceError (errorMessage);
+}
+
+//=================================================================================================
+
+AudioTap::Ring& AudioTap::getRing (Stream stream) noexcept
+{
+    return stream == Stream::input ? inputRing : outputRing;
+}
+
+const AudioTap::Ring& AudioTap::getRing (Stream stream) const noexcept
+{
+    return stream == Stream::input ? inputRing : outputRing;
+}
+
+} // namespace straw
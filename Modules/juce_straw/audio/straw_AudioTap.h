@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <atomic>
+#include <optional>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Captures the audio of an application into lock-free ring buffers, so it can be analysed while the audio runs.
+ *
+ * A tap is an audio device callback wrapping the callback of the application: register the tap with the
+ * `juce::AudioDeviceManager` instead of the application callback, and both the input and the output of the device are
+ * captured. Applications rendering audio elsewhere can write the output themselves with `writeOutput`.
+ *
+ * The audio thread is the only writer, it never blocks nor allocates, and overwrites the oldest samples when a ring is full.
+ * Readers copy the most recent samples from any thread. Taps are registered by name while they are alive, so the automation
+ * endpoints can find them.
+ */
+class AudioTap : public juce::AudioIODeviceCallback
+{
+public:
+    /**
+     * @brief The captured streams.
+     */
+    enum class Stream
+    {
+        input,
+        output
+    };
+
+    /**
+     * @brief Constructor for the AudioTap class.
+     *
+     * @param name The name of the tap, unique among the alive taps.
+     * @param callbackToWrap The application callback producing the output, or nullptr to produce silence.
+     * @param maxNumChannels The maximum number of channels captured for each stream.
+     * @param capacityInSamples The number of samples kept for each channel.
+     */
+    AudioTap (const juce::String& name,
+              juce::AudioIODeviceCallback* callbackToWrap,
+              int maxNumChannels = 2,
+              int capacityInSamples = 1 << 19);
+
+    /**
+     * @brief Destructor for the AudioTap class.
+     */
+    ~AudioTap() override;
+
+    /**
+     * @brief Get the name of the tap.
+     */
+    [[nodiscard]] const juce::String& getName() const noexcept;
+
+    /**
+     * @brief Get the sample rate of the captured audio, zero before the device starts.
+     */
+    [[nodiscard]] double getSampleRate() const noexcept;
+
+    /**
+     * @brief Set the sample rate, for applications writing the output themselves.
+     */
+    void setSampleRate (double newSampleRate) noexcept;
+
+    /**
+     * @brief Get the number of channels captured for a stream.
+     */
+    [[nodiscard]] int getNumChannels (Stream stream) const noexcept;
+
+    /**
+     * @brief Get the total number of samples captured for a stream since the tap was created.
+     */
+    [[nodiscard]] juce::int64 getNumCapturedSamples (Stream stream) const noexcept;
+
+    /**
+     * @brief Write output samples, must only be called from the audio thread.
+     */
+    void writeOutput (const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /**
+     * @brief Copy the most recent samples of a stream, from any thread.
+     *
+     * Both streams are written by the same device callback, so reading the same number of samples from both streams gives
+     * aligned buffers, unless the device callback runs in between.
+     *
+     * @param stream The stream to read.
+     * @param numSamples The number of samples to read, fewer are returned when fewer have been captured.
+     *
+     * @return The samples, one channel for each captured channel.
+     */
+    [[nodiscard]] juce::AudioBuffer<float> read (Stream stream, int numSamples) const;
+
+    /**
+     * @brief Get the names of the alive taps.
+     */
+    [[nodiscard]] static juce::StringArray getTapNames();
+
+    /**
+     * @brief Copy the most recent samples of a stream of a tap, by name.
+     *
+     * @param name The name of the tap.
+     * @param stream The stream to read.
+     * @param duration The duration to read.
+     * @param buffer The buffer to fill with the samples.
+     * @param sampleRate The sample rate of the samples.
+     *
+     * @return The result of the operation, failing when the tap is not found or hasn't captured any audio.
+     */
+    [[nodiscard]] static juce::Result readTap (const juce::String& name,
+                                               Stream stream,
+                                               juce::RelativeTime duration,
+                                               juce::AudioBuffer<float>& buffer,
+                                               double& sampleRate);
+
+    /**
+     * @brief Convert the name of a stream.
+     */
+    [[nodiscard]] static std::optional<Stream> streamFromString (juce::StringRef name);
+
+    /** @internal */
+    void audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                           int numInputChannels,
+                                           float* const* outputChannelData,
+                                           int numOutputChannels,
+                                           int numSamples,
+                                           const juce::AudioIODeviceCallbackContext& context) override;
+    /** @internal */
+    void audioDeviceAboutToStart (juce::AudioIODevice* device) override;
+    /** @internal */
+    void audioDeviceStopped() override;
+    /** @internal */
+    void audioDeviceError (const juce::String& errorMessage) override;
+
+private:
+    class Ring
+    {
+    public:
+        Ring (int maxNumChannels, int capacityInSamples);
+
+        void write (const float* const* channels, int numChannels, int numSamples) noexcept;
+        [[nodiscard]] juce::AudioBuffer<float> read (int numSamples) const;
+
+        std::atomic<int> numChannels { 0 };
+        std::atomic<juce::int64> writePosition { 0 };
+        std::atomic<juce::int64> pendingWritePosition { 0 };
+
+    private:
+        juce::AudioBuffer<float> samples;
+    };
+
+    Ring& getRing (Stream stream) noexcept;
+    const Ring& getRing (Stream stream) const noexcept;
+
+    const juce::String name;
+    juce::AudioIODeviceCallback* const wrappedCallback;
+    Ring inputRing;
+    Ring outputRing;
+    std::atomic<double> sampleRate { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE (AudioTap)
+};
+
+} // namespace straw
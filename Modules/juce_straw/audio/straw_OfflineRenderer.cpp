@@ -0,0 +1,716 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_OfflineRenderer.h"
+
+#include <atomic>
+#include <cmath>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+// Renders are bounded, so a single request can't exhaust the memory of the application
+constexpr double maxRenderSeconds = 600.0;
+constexpr juce::int64 maxRenderSampleCount = juce::int64 (1) << 27; // samples over all the channels, 512 MB of floats
+
+juce::Result checkRenderSize (juce::int64 numSamples, int numChannels, double sampleRate)
+{
+    if (numSamples <= 0)
+        return juce::Result::fail ("invalid render duration");
+
+    if (static_cast<double> (numSamples) > maxRenderSeconds * sampleRate)
+        return juce::Result::fail ("render duration exceeds the limit of " + juce::String (maxRenderSeconds, 0) + " seconds");
+
+    if (numSamples * juce::jmax (1, numChannels) > maxRenderSampleCount)
+        return juce::Result::fail ("render exceeds the limit of " + juce::String (maxRenderSampleCount) + " samples over all the channels");
+
+    return juce::Result::ok();
+}
+
+//=================================================================================================
+
+juce::Result readSignalFile (const juce::File& file, double sampleRate, juce::int64 numSamples, juce::AudioBuffer<float>& buffer)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file));
+    if (reader == nullptr)
+        return juce::Result::fail ("unable to read audio file " + file.getFullPathName());
+
+    if (! juce::approximatelyEqual (reader->sampleRate, sampleRate))
+        return juce::Result::fail ("sample rate of the audio file differs from the render sample rate");
+
+    const auto length = numSamples > 0 ? numSamples : reader->lengthInSamples;
+
+    if (auto result = checkRenderSize (length, static_cast<int> (reader->numChannels), sampleRate); result.failed())
+        return result;
+
+    buffer.setSize (static_cast<int> (reader->numChannels), static_cast<int> (length));
+    buffer.clear();
+
+    // Files shorter than the render are padded with silence
+    reader->read (&buffer, 0, static_cast<int> (juce::jmin (length, reader->lengthInSamples)), 0, true, true);
+
+    return juce::Result::ok();
+}
+
+juce::Result makeTestSignal (const TestSignal& signal, double sampleRate, juce::int64 numSamples, juce::AudioBuffer<float>& buffer)
+{
+    if (signal.type == TestSignal::Type::file)
+        return readSignalFile (signal.file, sampleRate, numSamples, buffer);
+
+    if (auto result = checkRenderSize (numSamples, signal.numChannels, sampleRate); result.failed())
+        return result;
+
+    buffer.setSize (juce::jmax (1, signal.numChannels), static_cast<int> (numSamples));
+    buffer.clear();
+
+    auto* samples = buffer.getWritePointer (0);
+
+    switch (signal.type)
+    {
+        case TestSignal::Type::sine:
+        {
+            const auto increment = juce::MathConstants<double>::twoPi * signal.frequency / sampleRate;
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                samples [sample] = signal.gain * static_cast<float> (std::sin (increment * sample));
+
+            break;
+        }
+
+        case TestSignal::Type::sweep:
+        {
+            // Logarithmic sweep over the whole duration, with the phase continuous at every sample
+            const auto duration = buffer.getNumSamples() / sampleRate;
+            const auto ratio = std::log (signal.endFrequency / signal.frequency);
+            const auto scale = juce::MathConstants<double>::twoPi * signal.frequency * duration / ratio;
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                const auto time = sample / sampleRate;
+                samples [sample] = signal.gain * static_cast<float> (std::sin (scale * (std::exp (time / duration * ratio) - 1.0)));
+            }
+
+            break;
+        }
+
+        case TestSignal::Type::noise:
+        {
+            juce::Random random (signal.seed);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                samples [sample] = signal.gain * (random.nextFloat() * 2.0f - 1.0f);
+
+            break;
+        }
+
+        case TestSignal::Type::impulse:
+            samples [0] = signal.gain;
+            break;
+
+        case TestSignal::Type::silence:
+        case TestSignal::Type::file:
+            break;
+    }
+
+    for (int channel = 1; channel < buffer.getNumChannels(); ++channel)
+        buffer.copyFrom (channel, 0, buffer, 0, 0, buffer.getNumSamples());
+
+    return juce::Result::ok();
+}
+
+//=================================================================================================
+
+juce::AudioProcessorParameter* findProcessorParameter (juce::AudioProcessor& processor, const juce::String& parameterID)
+{
+    for (auto* parameter : processor.getParameters())
+    {
+        if (auto* parameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*> (parameter))
+        {
+            if (parameterWithID->paramID == parameterID)
+                return parameter;
+        }
+    }
+
+    for (auto* parameter : processor.getParameters())
+    {
+        if (parameter->getName (1024) == parameterID)
+            return parameter;
+    }
+
+    return nullptr;
+}
+
+void setOrAddParameterValue (std::vector<std::pair<juce::String, float>>& parameters, const juce::String& parameterID, float value)
+{
+    for (auto& parameter : parameters)
+    {
+        if (parameter.first == parameterID)
+        {
+            parameter.second = value;
+            return;
+        }
+    }
+
+    parameters.emplace_back (parameterID, value);
+}
+
+//=================================================================================================
+
+juce::Result readGoldenFile (const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    juce::WavAudioFormat format;
+
+    std::unique_ptr<juce::AudioFormatReader> reader (format.createReaderFor (file.createInputStream().release(), true));
+    if (reader == nullptr)
+        return juce::Result::fail ("unable to read golden file " + file.getFullPathName());
+
+    if (auto result = checkRenderSize (reader->lengthInSamples, static_cast<int> (reader->numChannels), reader->sampleRate); result.failed())
+        return juce::Result::fail ("golden file is too large: " + result.getErrorMessage());
+
+    buffer.setSize (static_cast<int> (reader->numChannels), static_cast<int> (reader->lengthInSamples));
+    reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+    return juce::Result::ok();
+}
+
+juce::Result writeGoldenFile (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    if (! file.getParentDirectory().createDirectory())
+        return juce::Result::fail ("unable to create the golden directory " + file.getParentDirectory().getFullPathName());
+
+    // Written aside and moved in place, so an interrupted render never leaves a truncated golden file
+    juce::TemporaryFile temporaryFile (file);
+
+    {
+        auto stream = temporaryFile.getFile().createOutputStream();
+        if (stream == nullptr)
+            return juce::Result::fail ("unable to write golden file " + file.getFullPathName());
+
+        juce::WavAudioFormat format;
+
+        // 32 bits wav files store the samples as floats, so goldens are bit exact
+        std::unique_ptr<juce::AudioFormatWriter> writer (format.createWriterFor (stream.get(), sampleRate, static_cast<unsigned int> (buffer.getNumChannels()), 32, {}, 0));
+        if (writer == nullptr)
+            return juce::Result::fail ("unable to write golden file " + file.getFullPathName());
+
+        stream.release();
+
+        if (! writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples()))
+            return juce::Result::fail ("unable to write golden file " + file.getFullPathName());
+    }
+
+    if (! temporaryFile.overwriteTargetFileWithTemporary())
+        return juce::Result::fail ("unable to replace golden file " + file.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+juce::Result compareWithGolden (const juce::AudioBuffer<float>& golden, float tolerance, OfflineRenderResult& renderResult)
+{
+    const auto& output = renderResult.output;
+
+    if (golden.getNumChannels() != output.getNumChannels() || golden.getNumSamples() != output.getNumSamples())
+    {
+        return juce::Result::fail ("golden file has " + juce::String (golden.getNumChannels()) + " channels and "
+            + juce::String (golden.getNumSamples()) + " samples, the render has " + juce::String (output.getNumChannels())
+            + " channels and " + juce::String (output.getNumSamples()) + " samples");
+    }
+
+    double sumOfDifferences = 0.0;
+    float maxDifference = 0.0f;
+    juce::int64 firstDifferenceSample = -1;
+
+    for (int channel = 0; channel < output.getNumChannels(); ++channel)
+    {
+        const auto* outputSamples = output.getReadPointer (channel);
+        const auto* goldenSamples = golden.getReadPointer (channel);
+
+        for (int sample = 0; sample < output.getNumSamples(); ++sample)
+        {
+            const auto difference = std::abs (outputSamples [sample] - goldenSamples [sample]);
+
+            maxDifference = juce::jmax (maxDifference, difference);
+            sumOfDifferences += static_cast<double> (difference) * difference;
+
+            if (difference > tolerance && (firstDifferenceSample < 0 || sample < firstDifferenceSample))
+                firstDifferenceSample = sample;
+        }
+    }
+
+    const auto numValues = juce::jmax (1, output.getNumChannels() * output.getNumSamples());
+
+    renderResult.hasGolden = true;
+    renderResult.goldenPassed = maxDifference <= tolerance;
+    renderResult.maxDifference = maxDifference;
+    renderResult.rmsDifferenceDecibels = juce::Decibels::gainToDecibels (static_cast<float> (std::sqrt (sumOfDifferences / numValues)));
+    renderResult.firstDifferenceSample = firstDifferenceSample;
+
+    return juce::Result::ok();
+}
+
+} // namespace
+
+//=================================================================================================
+
+std::optional<TestSignal::Type> TestSignal::typeFromString (juce::StringRef name)
+{
+    if (name == "silence")
+        return Type::silence;
+
+    if (name == "sine")
+        return Type::sine;
+
+    if (name == "sweep")
+        return Type::sweep;
+
+    if (name == "noise")
+        return Type::noise;
+
+    if (name == "impulse")
+        return Type::impulse;
+
+    if (name == "file")
+        return Type::file;
+
+    return std::nullopt;
+}
+
+//=================================================================================================
+
+bool OfflineRenderResult::passed() const
+{
+    return result.wasOk() && (! hasGolden || goldenPassed);
+}
+
+juce::var OfflineRenderResult::toVar() const
+{
+    juce::DynamicObject::Ptr parametersObject = new juce::DynamicObject;
+    for (const auto& [parameterID, value] : parameters)
+        parametersObject->setProperty (parameterID, value);
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("name", name);
+    object->setProperty ("parameters", parametersObject.get());
+    object->setProperty ("passed", passed());
+
+    if (result.failed())
+    {
+        object->setProperty ("error", result.getErrorMessage());
+        return object.get();
+    }
+
+    juce::Array<juce::var> channels;
+
+    for (int channel = 0; channel < output.getNumChannels(); ++channel)
+    {
+        const auto rms = output.getRMSLevel (channel, 0, output.getNumSamples());
+        const auto peak = output.getMagnitude (channel, 0, output.getNumSamples());
+
+        juce::DynamicObject::Ptr channelObject = new juce::DynamicObject;
+        channelObject->setProperty ("rms", rms);
+        channelObject->setProperty ("rms_db", juce::Decibels::gainToDecibels (rms));
+        channelObject->setProperty ("peak", peak);
+        channelObject->setProperty ("peak_db", juce::Decibels::gainToDecibels (peak));
+        channels.add (channelObject.get());
+    }
+
+    object->setProperty ("channels", std::move (channels));
+    object->setProperty ("num_samples", output.getNumSamples());
+    object->setProperty ("render_ms", renderMilliseconds);
+    object->setProperty ("realtime_factor", realtimeFactor);
+
+    if (goldenWritten)
+    {
+        object->setProperty ("golden", "written");
+    }
+    else if (hasGolden)
+    {
+        juce::DynamicObject::Ptr goldenObject = new juce::DynamicObject;
+        goldenObject->setProperty ("passed", goldenPassed);
+        goldenObject->setProperty ("max_difference", maxDifference);
+        goldenObject->setProperty ("rms_difference_db", rmsDifferenceDecibels);
+        goldenObject->setProperty ("first_difference_sample", firstDifferenceSample);
+        object->setProperty ("golden", goldenObject.get());
+    }
+
+    return object.get();
+}
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (OfflineRenderer)
+
+OfflineRenderer::OfflineRenderer()
+    : renderPool (juce::ThreadPoolOptions().withThreadName ("Straw Render Thread").withNumberOfThreads (juce::SystemStats::getNumCpus()))
+{
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    renderPool.removeAllJobs (true, 10000);
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void OfflineRenderer::registerProcessor (const juce::String& name, ProcessorFactory factory)
+{
+    const juce::ScopedLock sl (factoriesLock);
+
+    factories [name] = std::move (factory);
+}
+
+void OfflineRenderer::unregisterProcessor (const juce::String& name)
+{
+    const juce::ScopedLock sl (factoriesLock);
+
+    factories.erase (name);
+}
+
+juce::StringArray OfflineRenderer::getProcessorNames() const
+{
+    const juce::ScopedLock sl (factoriesLock);
+
+    juce::StringArray names;
+    for (const auto& [name, factory] : factories)
+        names.add (name);
+
+    return names;
+}
+
+//=================================================================================================
+
+std::vector<OfflineRenderResult> OfflineRenderer::render (const std::vector<OfflineRenderJob>& jobs)
+{
+    std::vector<OfflineRenderResult> results (jobs.size());
+    if (jobs.empty())
+        return results;
+
+    std::atomic<std::size_t> remainingJobs { jobs.size() };
+    juce::WaitableEvent allJobsFinished;
+
+    for (std::size_t index = 0; index < jobs.size(); ++index)
+    {
+        renderPool.addJob ([this, &jobs, &results, &remainingJobs, &allJobsFinished, index]
+        {
+            results [index] = renderJob (jobs [index]);
+
+            if (remainingJobs.fetch_sub (1) == 1)
+                allJobsFinished.signal();
+        });
+    }
+
+    allJobsFinished.wait();
+
+    return results;
+}
+
+OfflineRenderResult OfflineRenderer::renderJob (const OfflineRenderJob& job) const
+{
+    OfflineRenderResult renderResult;
+    renderResult.name = job.name;
+    renderResult.parameters = job.parameters;
+
+    ProcessorFactory factory;
+
+    {
+        const juce::ScopedLock sl (factoriesLock);
+
+        if (auto it = factories.find (job.processorName); it != factories.end())
+            factory = it->second;
+    }
+
+    if (! factory)
+    {
+        renderResult.result = juce::Result::fail ("unable to find processor " + job.processorName);
+        return renderResult;
+    }
+
+    juce::AudioBuffer<float> input;
+
+    renderResult.result = makeTestSignal (job.signal, job.sampleRate, job.numSamples, input);
+    if (renderResult.result.failed())
+        return renderResult;
+
+    auto processor = factory();
+    if (processor == nullptr)
+    {
+        renderResult.result = juce::Result::fail ("unable to create processor " + job.processorName);
+        return renderResult;
+    }
+
+    // Parameters are set before preparing, so smoothed values start at their targets
+    for (const auto& [parameterID, value] : job.parameters)
+    {
+        auto* parameter = findProcessorParameter (*processor, parameterID);
+        if (parameter == nullptr)
+        {
+            renderResult.result = juce::Result::fail ("unable to find parameter " + parameterID);
+            return renderResult;
+        }
+
+        parameter->setValueNotifyingHost (juce::jlimit (0.0f, 1.0f, value));
+    }
+
+    processor->setNonRealtime (true);
+    processor->setRateAndBufferSizeDetails (job.sampleRate, job.blockSize);
+    processor->prepareToPlay (job.sampleRate, job.blockSize);
+
+    const auto numInputChannels = processor->getTotalNumInputChannels();
+    const auto numOutputChannels = processor->getTotalNumOutputChannels();
+    const auto numSamples = input.getNumSamples();
+
+    // The output follows the channels of the processor, which can be more than the channels of the signal
+    renderResult.result = checkRenderSize (numSamples, numOutputChannels, job.sampleRate);
+    if (renderResult.result.failed())
+    {
+        processor->releaseResources();
+        return renderResult;
+    }
+
+    juce::AudioBuffer<float> block (juce::jmax (1, numInputChannels, numOutputChannels), job.blockSize);
+    juce::MidiBuffer midiMessages;
+
+    renderResult.output.setSize (numOutputChannels, numSamples);
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (int position = 0; position < numSamples; position += job.blockSize)
+    {
+        const auto numBlockSamples = juce::jmin (job.blockSize, numSamples - position);
+
+        // The last block is shorter, keeping the allocated samples so the loop never allocates
+        block.setSize (block.getNumChannels(), numBlockSamples, false, false, true);
+
+        for (int channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            if (channel < numInputChannels)
+                block.copyFrom (channel, 0, input, channel % input.getNumChannels(), position, numBlockSamples);
+            else
+                block.clear (channel, 0, numBlockSamples);
+        }
+
+        {
+            const juce::ScopedLock sl (processor->getCallbackLock());
+
+            if (processor->isSuspended())
+                block.clear();
+            else
+                processor->processBlock (block, midiMessages);
+        }
+
+        midiMessages.clear();
+
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+            renderResult.output.copyFrom (channel, position, block, channel, 0, numBlockSamples);
+    }
+
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    processor->releaseResources();
+    processor.reset();
+
+    renderResult.renderMilliseconds = elapsedSeconds * 1000.0;
+    renderResult.realtimeFactor = elapsedSeconds > 0.0 ? (numSamples / job.sampleRate) / elapsedSeconds : 0.0;
+
+    if (job.goldenFile == juce::File())
+        return renderResult;
+
+    if (job.updateGolden)
+    {
+        renderResult.result = writeGoldenFile (job.goldenFile, renderResult.output, job.sampleRate);
+        renderResult.goldenWritten = renderResult.result.wasOk();
+        return renderResult;
+    }
+
+    if (! job.goldenFile.existsAsFile())
+    {
+        renderResult.result = juce::Result::fail ("unable to find golden file " + job.goldenFile.getFullPathName());
+        return renderResult;
+    }
+
+    juce::AudioBuffer<float> golden;
+
+    renderResult.result = readGoldenFile (job.goldenFile, golden);
+    if (renderResult.result.wasOk())
+        renderResult.result = compareWithGolden (golden, job.tolerance, renderResult);
+
+    return renderResult;
+}
+
+//=================================================================================================
+
+juce::Result OfflineRenderer::parseJobs (const juce::var& data, std::vector<OfflineRenderJob>& jobs)
+{
+    OfflineRenderJob baseJob;
+
+    baseJob.processorName = data.getProperty ("processor", "").toString();
+    if (baseJob.processorName.isEmpty())
+        return juce::Result::fail ("processor name is missing");
+
+    baseJob.sampleRate = static_cast<double> (data.getProperty ("sampleRate", 48000.0));
+    baseJob.blockSize = static_cast<int> (data.getProperty ("blockSize", 512));
+    if (baseJob.sampleRate <= 0.0 || baseJob.sampleRate > 1000000.0 || baseJob.blockSize <= 0 || baseJob.blockSize > 65536)
+        return juce::Result::fail ("invalid sample rate or block size");
+
+    const auto signal = data.getProperty ("signal", juce::var());
+
+    const auto signalType = TestSignal::typeFromString (signal.getProperty ("type", "silence").toString());
+    if (! signalType.has_value())
+        return juce::Result::fail ("unknown signal type " + signal.getProperty ("type", "").toString());
+
+    baseJob.signal.type = *signalType;
+    baseJob.signal.numChannels = juce::jlimit (1, 64, static_cast<int> (signal.getProperty ("channels", 2)));
+    baseJob.signal.gain = static_cast<float> (signal.getProperty ("gain", 0.5f));
+    baseJob.signal.frequency = static_cast<double> (signal.getProperty ("frequency", 1000.0));
+    baseJob.signal.endFrequency = static_cast<double> (signal.getProperty ("endFrequency", 20000.0));
+    baseJob.signal.seed = static_cast<juce::int64> (signal.getProperty ("seed", 0));
+
+    if (baseJob.signal.frequency <= 0.0 || baseJob.signal.endFrequency <= 0.0)
+        return juce::Result::fail ("invalid signal frequency");
+
+    if (baseJob.signal.type == TestSignal::Type::file)
+    {
+        const auto path = signal.getProperty ("file", "").toString();
+        if (! juce::File::isAbsolutePath (path))
+            return juce::Result::fail ("signal file must be an absolute path");
+
+        baseJob.signal.file = juce::File (path);
+    }
+
+    // Renders of files default to the length of the file, generated signals to one second
+    if (data.hasProperty ("duration"))
+    {
+        const auto duration = juce::jlimit (0.0, maxRenderSeconds * 1000.0 + 1.0, static_cast<double> (data.getProperty ("duration", 0)));
+        baseJob.numSamples = static_cast<juce::int64> (std::llround (duration * baseJob.sampleRate / 1000.0));
+    }
+    else if (baseJob.signal.type != TestSignal::Type::file)
+    {
+        baseJob.numSamples = static_cast<juce::int64> (baseJob.sampleRate);
+    }
+
+    // Files are checked once their channels are known, when they're read
+    if (baseJob.signal.type != TestSignal::Type::file || baseJob.numSamples > 0)
+    {
+        const auto numChannels = baseJob.signal.type != TestSignal::Type::file ? baseJob.signal.numChannels : 1;
+
+        if (auto result = checkRenderSize (baseJob.numSamples, numChannels, baseJob.sampleRate); result.failed())
+            return result;
+    }
+
+    if (auto* parametersObject = data.getProperty ("parameters", juce::var()).getDynamicObject())
+    {
+        for (const auto& property : parametersObject->getProperties())
+            baseJob.parameters.emplace_back (property.name.toString(), static_cast<float> (property.value));
+    }
+
+    juce::File goldenDirectory;
+
+    if (const auto path = data.getProperty ("golden", "").toString(); path.isNotEmpty())
+    {
+        if (! juce::File::isAbsolutePath (path))
+            return juce::Result::fail ("golden directory must be an absolute path");
+
+        goldenDirectory = juce::File (path);
+    }
+
+    baseJob.updateGolden = static_cast<bool> (data.getProperty ("updateGolden", false));
+    baseJob.tolerance = static_cast<float> (data.getProperty ("tolerance", 1.0e-5f));
+
+    const auto addJob = [&] (OfflineRenderJob job, const juce::String& name)
+    {
+        job.name = name;
+
+        if (goldenDirectory != juce::File())
+            job.goldenFile = goldenDirectory.getChildFile (juce::File::createLegalFileName (name) + ".wav");
+
+        jobs.push_back (std::move (job));
+    };
+
+    const auto sweeps = data.getProperty ("sweeps", juce::var());
+    if (! sweeps.isArray() || sweeps.size() == 0)
+    {
+        addJob (baseJob, "render");
+        return juce::Result::ok();
+    }
+
+    for (const auto& sweep : *sweeps.getArray())
+    {
+        const auto parameterID = sweep.getProperty ("parameter", "").toString();
+        if (parameterID.isEmpty())
+            return juce::Result::fail ("sweep parameter is missing");
+
+        juce::Array<float> values;
+
+        if (const auto valuesArray = sweep.getProperty ("values", juce::var()); valuesArray.isArray())
+        {
+            for (const auto& value : *valuesArray.getArray())
+                values.add (static_cast<float> (value));
+        }
+        else
+        {
+            const auto from = static_cast<float> (sweep.getProperty ("from", 0.0f));
+            const auto to = static_cast<float> (sweep.getProperty ("to", 1.0f));
+            const auto steps = static_cast<int> (sweep.getProperty ("steps", 5));
+
+            if (steps <= 0)
+                return juce::Result::fail ("sweep of " + parameterID + " has no steps");
+
+            for (int step = 0; step < steps; ++step)
+                values.add (steps > 1 ? juce::jmap (static_cast<float> (step), 0.0f, static_cast<float> (steps - 1), from, to) : from);
+        }
+
+        for (int index = 0; index < values.size(); ++index)
+        {
+            auto job = baseJob;
+            setOrAddParameterValue (job.parameters, parameterID, values [index]);
+
+            addJob (std::move (job), parameterID + "-" + juce::String (index));
+        }
+    }
+
+    return juce::Result::ok();
+}
+
+juce::var OfflineRenderer::resultsToVar (const std::vector<OfflineRenderResult>& results)
+{
+    juce::Array<juce::var> renders;
+    bool allPassed = true;
+
+    for (const auto& renderResult : results)
+    {
+        renders.add (renderResult.toVar());
+        allPassed = allPassed && renderResult.passed();
+    }
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("passed", allPassed);
+    object->setProperty ("renders", std::move (renders));
+    return object.get();
+}
+
+} // namespace straw
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The signal fed to the input of a processor rendered offline.
+ */
+struct TestSignal
+{
+    enum class Type
+    {
+        silence,
+        sine,
+        sweep,
+        noise,
+        impulse,
+        file
+    };
+
+    Type type = Type::silence;
+    int numChannels = 2;
+    float gain = 0.5f;
+    double frequency = 1000.0;      // the frequency of the sine, or the start frequency of the logarithmic sweep
+    double endFrequency = 20000.0;  // the end frequency of the logarithmic sweep
+    juce::int64 seed = 0;           // the seed of the noise, so renders are reproducible
+    juce::File file;                // the audio file, at the sample rate of the render
+
+    /**
+     * @brief Parse the type of a signal.
+     */
+    [[nodiscard]] static std::optional<Type> typeFromString (juce::StringRef name);
+};
+
+/**
+ * @brief A render of a processor, with the golden file its output is compared with.
+ */
+struct OfflineRenderJob
+{
+    juce::String name;
+    juce::String processorName;
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    juce::int64 numSamples = 0;     // zero for the length of the file signal
+    TestSignal signal;
+    std::vector<std::pair<juce::String, float>> parameters;   // normalised values, by parameter ID or name
+    juce::File goldenFile;
+    bool updateGolden = false;
+    float tolerance = 1.0e-5f;
+};
+
+/**
+ * @brief The outcome of a render.
+ */
+struct OfflineRenderResult
+{
+    juce::String name;
+    juce::Result result = juce::Result::ok();
+    std::vector<std::pair<juce::String, float>> parameters;
+    juce::AudioBuffer<float> output;
+    double renderMilliseconds = 0.0;
+    double realtimeFactor = 0.0;
+
+    bool hasGolden = false;         // false when there's no golden file, or when it has been written
+    bool goldenWritten = false;
+    bool goldenPassed = false;
+    float maxDifference = 0.0f;
+    float rmsDifferenceDecibels = -100.0f;
+    juce::int64 firstDifferenceSample = -1;
+
+    /**
+     * @brief Check if the render succeeded and matched its golden file, if any.
+     */
+    [[nodiscard]] bool passed() const;
+
+    /**
+     * @brief Convert the result to a var, with the levels of the output instead of the samples.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Renders registered audio processors offline, faster than realtime, for plugin regression tests.
+ *
+ * Applications register factories of their processors by name. Each render creates its own processor instance, prepares
+ * it in non realtime mode, sets its parameters, and runs `processBlock` in a tight loop over a generated test signal or an
+ * audio file. The output is compared with a golden file, written as a 32 bit float wav file, within a tolerance.
+ *
+ * Renders run in parallel on a thread pool with a thread per core, so parameter sweeps scale with the cores of the host.
+ * Factories are called from the pool threads, so processors must not need the message thread to be constructed.
+ */
+class OfflineRenderer : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Callback type creating a new instance of a processor.
+     */
+    using ProcessorFactory = std::function<std::unique_ptr<juce::AudioProcessor>()>;
+
+    /**
+     * @brief Destructor for the OfflineRenderer class.
+     */
+    ~OfflineRenderer() override;
+
+    /**
+     * @brief Register a processor factory, replacing any factory with the same name.
+     *
+     * @param name The name of the processor.
+     * @param factory The callback creating new instances of the processor.
+     */
+    void registerProcessor (const juce::String& name, ProcessorFactory factory);
+
+    /**
+     * @brief Unregister a processor factory.
+     *
+     * @param name The name of the processor.
+     */
+    void unregisterProcessor (const juce::String& name);
+
+    /**
+     * @brief Get the names of the registered processors.
+     */
+    [[nodiscard]] juce::StringArray getProcessorNames() const;
+
+    /**
+     * @brief Render jobs in parallel, blocking until all of them are rendered.
+     *
+     * @param jobs The jobs to render.
+     *
+     * @return The results, in the order of the jobs.
+     */
+    [[nodiscard]] std::vector<OfflineRenderResult> render (const std::vector<OfflineRenderJob>& jobs);
+
+    /**
+     * @brief Parse the jobs of a render request.
+     *
+     * Requests have the `processor` name, the `sampleRate`, `blockSize` and `duration` in milliseconds, the input `signal`
+     * with its `type` (silence, sine, sweep, noise, impulse or file) and properties, the normalised `parameters` values by
+     * ID, and the `golden` directory with the `tolerance` and the `updateGolden` flag. Each value of each parameter of the
+     * `sweeps` (either listed in `values`, or spaced evenly with `from`, `to` and `steps`) is rendered on its own, named
+     * after the parameter and the index of the value, otherwise a single `render` is made. The golden file of each render
+     * is named after it.
+     *
+     * Each render is limited to ten minutes and 2^27 samples over all its channels, so a request can't exhaust the memory
+     * of the application.
+     *
+     * @param data The request.
+     * @param jobs The jobs to fill.
+     *
+     * @return The result of the operation.
+     */
+    [[nodiscard]] static juce::Result parseJobs (const juce::var& data, std::vector<OfflineRenderJob>& jobs);
+
+    /**
+     * @brief Convert the results of a set of renders to a var.
+     */
+    [[nodiscard]] static juce::var resultsToVar (const std::vector<OfflineRenderResult>& results);
+
+    JUCE_DECLARE_SINGLETON (OfflineRenderer, false)
+
+private:
+    OfflineRenderer();
+
+    OfflineRenderResult renderJob (const OfflineRenderJob& job) const;
+
+    mutable juce::CriticalSection factoriesLock;
+    std::map<juce::String, ProcessorFactory> factories;
+    juce::ThreadPool renderPool;
+};
+
+} // namespace straw
@@ -0,0 +1,313 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_AsyncLogger.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+juce::String truncatePayload (const juce::String& payload, std::size_t maxNumBytes)
+{
+    const auto numBytes = payload.getNumBytesAsUTF8();
+    if (numBytes <= maxNumBytes)
+        return payload;
+
+    const auto* data = payload.toRawUTF8();
+
+    // Never cut a multibyte character in half
+    auto numBytesToKeep = maxNumBytes;
+    while (numBytesToKeep > 0 && (static_cast<juce::uint8> (data [numBytesToKeep]) & 0xc0) == 0x80)
+        --numBytesToKeep;
+
+    return juce::String::fromUTF8 (data, static_cast<int> (numBytesToKeep))
+        + "... (" + juce::String (static_cast<juce::uint64> (numBytes - numBytesToKeep)) + " more bytes)";
+}
+
+void writeToJuceLogger (const LogEntry& entry)
+{
+    juce::String line;
+
+    line
+        << juce::Time (entry.timeMilliseconds).toISO8601 (true)
+        << " [" << AsyncLogger::levelToString (entry.level) << "] "
+        << entry.category << ": "
+        << entry.message;
+
+    juce::Logger::writeToLog (line);
+}
+
+} // namespace
+
+//=================================================================================================
+
+class AsyncLogger::WriterThread : public juce::Thread
+{
+public:
+    explicit WriterThread (AsyncLogger& loggerToDrain)
+        : juce::Thread ("Straw Log Writer")
+        , logger (loggerToDrain)
+    {
+    }
+
+    ~WriterThread() override
+    {
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        // Producers never signal, waking up regularly keeps the logging path free of any lock
+        while (! threadShouldExit())
+        {
+            logger.writePendingEntries();
+
+            wait (20);
+        }
+
+        logger.writePendingEntries();
+    }
+
+private:
+    AsyncLogger& logger;
+};
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (AsyncLogger)
+
+AsyncLogger::AsyncLogger()
+{
+    if (auto level = levelFromString (juce::SystemStats::getEnvironmentVariable ("STRAW_LOG_LEVEL", {})))
+        minimumLevel.store (*level);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    std::unique_ptr<WriterThread> threadToStop;
+
+    {
+        auto lock = juce::CriticalSection::ScopedLockType (writerLock);
+        threadToStop = std::move (writerThread);
+    }
+
+    // Deleted at shutdown, so the sink is flushed while the application objects it captures are still alive
+    threadToStop.reset();
+
+    writePendingEntries();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void AsyncLogger::setLevel (LogLevel level)
+{
+    minimumLevel.store (level);
+}
+
+LogLevel AsyncLogger::getLevel() const
+{
+    return minimumLevel.load();
+}
+
+void AsyncLogger::setMaxPayloadSize (std::size_t numBytes)
+{
+    maxPayloadSize.store (numBytes);
+}
+
+std::size_t AsyncLogger::getMaxPayloadSize() const
+{
+    return maxPayloadSize.load();
+}
+
+void AsyncLogger::setEndpointSampling (juce::StringRef endpoint, int everyNth)
+{
+    auto lock = juce::CriticalSection::ScopedLockType (samplingLock);
+
+    // Copy on write, the published table is read without locking and retired tables are kept alive
+    auto newTable = std::make_unique<SamplingTable>();
+
+    if (auto table = samplingTable.load (std::memory_order_acquire))
+        *newTable = *table;
+
+    (*newTable) [juce::String (endpoint)] = std::make_shared<Sampling> (juce::jmax (0, everyNth));
+
+    samplingTable.store (newTable.get(), std::memory_order_release);
+    samplingTables.push_back (std::move (newTable));
+}
+
+void AsyncLogger::setSink (Sink newSink)
+{
+    auto lock = juce::CriticalSection::ScopedLockType (writerLock);
+
+    sink = std::move (newSink);
+}
+
+//=================================================================================================
+
+void AsyncLogger::log (LogLevel level, juce::StringRef category, const juce::String& message)
+{
+    if (! isEnabled (level))
+        return;
+
+    enqueue ({ level, juce::String (category), message, juce::Time::currentTimeMillis() });
+}
+
+void AsyncLogger::logPayload (juce::StringRef category, juce::StringRef endpoint, const juce::String& payload)
+{
+    if (! isEnabled (LogLevel::debug) || ! shouldSample (endpoint))
+        return;
+
+    juce::String message;
+    message << endpoint << " " << truncatePayload (payload, maxPayloadSize.load (std::memory_order_relaxed));
+
+    enqueue ({ LogLevel::debug, juce::String (category), std::move (message), juce::Time::currentTimeMillis() });
+}
+
+//=================================================================================================
+
+void AsyncLogger::flush()
+{
+    writePendingEntries();
+}
+
+juce::uint64 AsyncLogger::getNumLoggedEntries() const
+{
+    return numLoggedEntries.load();
+}
+
+//=================================================================================================
+
+juce::var AsyncLogger::toVar() const
+{
+    juce::DynamicObject::Ptr sampling = new juce::DynamicObject;
+
+    if (auto table = samplingTable.load (std::memory_order_acquire))
+    {
+        for (const auto& [endpoint, endpointSampling] : *table)
+            sampling->setProperty (endpoint, endpointSampling->everyNth);
+    }
+
+    juce::DynamicObject::Ptr result = new juce::DynamicObject;
+    result->setProperty ("level", levelToString (getLevel()));
+    result->setProperty ("maxPayloadSize", static_cast<juce::int64> (getMaxPayloadSize()));
+    result->setProperty ("sampling", sampling.get());
+    result->setProperty ("logged", static_cast<juce::int64> (getNumLoggedEntries()));
+    return result.get();
+}
+
+//=================================================================================================
+
+std::optional<LogLevel> AsyncLogger::levelFromString (juce::StringRef name)
+{
+    static const std::pair<const char*, LogLevel> levels[]
+    {
+        { "trace", LogLevel::trace },
+        { "debug", LogLevel::debug },
+        { "info", LogLevel::info },
+        { "warning", LogLevel::warning },
+        { "error", LogLevel::error },
+        { "off", LogLevel::off }
+    };
+
+    for (const auto& [levelName, level] : levels)
+    {
+        if (juce::String (name).trim().equalsIgnoreCase (levelName))
+            return level;
+    }
+
+    return std::nullopt;
+}
+
+juce::String AsyncLogger::levelToString (LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::trace: return "trace";
+        case LogLevel::debug: return "debug";
+        case LogLevel::info: return "info";
+        case LogLevel::warning: return "warning";
+        case LogLevel::error: return "error";
+        case LogLevel::off: return "off";
+        default: break;
+    }
+
+    return "info";
+}
+
+//=================================================================================================
+
+bool AsyncLogger::shouldSample (juce::StringRef endpoint) const
+{
+    auto table = samplingTable.load (std::memory_order_acquire);
+    if (table == nullptr)
+        return true;
+
+    auto it = table->find (juce::String (endpoint));
+    if (it == table->end())
+        return true;
+
+    const auto everyNth = it->second->everyNth;
+    if (everyNth <= 0)
+        return false;
+
+    return it->second->counter.fetch_add (1, std::memory_order_relaxed) % static_cast<juce::uint64> (everyNth) == 0;
+}
+
+void AsyncLogger::enqueue (LogEntry entry)
+{
+    queue.push (std::move (entry));
+
+    // Started on first use, so nothing runs until something is logged
+    if (! writerStarted.load (std::memory_order_acquire))
+    {
+        auto lock = juce::CriticalSection::ScopedLockType (writerLock);
+
+        if (! writerStarted.load (std::memory_order_relaxed))
+        {
+            writerThread = std::make_unique<WriterThread> (*this);
+            writerThread->startThread();
+
+            writerStarted.store (true, std::memory_order_release);
+        }
+    }
+}
+
+void AsyncLogger::writePendingEntries()
+{
+    // The queue supports a single consumer at a time
+    auto lock = juce::CriticalSection::ScopedLockType (writerLock);
+
+    LogEntry entry;
+    while (queue.pop (entry))
+    {
+        if (sink != nullptr)
+            sink (entry);
+        else
+            writeToJuceLogger (entry);
+
+        numLoggedEntries.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace straw
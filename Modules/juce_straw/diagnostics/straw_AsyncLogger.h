@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "straw_MpscQueue.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The severity of a log entry, in increasing order.
+ */
+enum class LogLevel
+{
+    trace,
+    debug,
+    info,
+    warning,
+    error,
+    off
+};
+
+/**
+ * @brief An entry of the asynchronous log.
+ */
+struct LogEntry
+{
+    LogLevel level = LogLevel::info;
+    juce::String category;
+    juce::String message;
+    juce::int64 timeMilliseconds = 0;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Asynchronous log sink, with levels, per endpoint sampling of payloads and payload truncation.
+ *
+ * Entries are pushed on a lock-free queue and written by a background thread, so logging never blocks the calling thread on
+ * the actual output. When a level is disabled, logging at that level costs a single relaxed atomic load.
+ *
+ * Request and response payloads are logged at the debug level, after being sampled and truncated: the default level is
+ * info, unless the `STRAW_LOG_LEVEL` environment variable specifies another one. Entries are written to the current
+ * `juce::Logger` unless a custom sink is set.
+ */
+class AsyncLogger : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Callback type receiving the log entries, always called from the logger thread.
+     */
+    using Sink = std::function<void (const LogEntry&)>;
+
+    /**
+     * @brief Destructor for the AsyncLogger class, stops the writer thread and writes the pending entries.
+     */
+    ~AsyncLogger() override;
+
+    /**
+     * @brief Set the minimum level of the entries to log.
+     */
+    void setLevel (LogLevel level);
+
+    /**
+     * @brief Get the minimum level of the entries to log.
+     */
+    [[nodiscard]] LogLevel getLevel() const;
+
+    /**
+     * @brief Check if entries of a level are logged.
+     */
+    [[nodiscard]] bool isEnabled (LogLevel level) const noexcept
+    {
+        return level != LogLevel::off && level >= minimumLevel.load (std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Set the maximum number of bytes of a payload to log, longer payloads are truncated.
+     */
+    void setMaxPayloadSize (std::size_t numBytes);
+
+    /**
+     * @brief Get the maximum number of bytes of a payload to log.
+     */
+    [[nodiscard]] std::size_t getMaxPayloadSize() const;
+
+    /**
+     * @brief Log only one payload every `everyNth` for an endpoint.
+     *
+     * @param endpoint The endpoint path, as registered, or `text/x-python` for scripts.
+     * @param everyNth The sampling interval, 1 to log every payload and 0 to log none.
+     */
+    void setEndpointSampling (juce::StringRef endpoint, int everyNth);
+
+    /**
+     * @brief Set the sink receiving the log entries, nullptr to restore the default `juce::Logger` sink.
+     */
+    void setSink (Sink newSink);
+
+    /**
+     * @brief Log a message. Can be called from any thread.
+     *
+     * @param level The level of the message.
+     * @param category The category of the message, like `server` or `python`.
+     * @param message The message.
+     */
+    void log (LogLevel level, juce::StringRef category, const juce::String& message);
+
+    /**
+     * @brief Log a text payload of an endpoint at the debug level, sampled and truncated. Can be called from any thread.
+     *
+     * @param category The category of the payload, like `request` or `response`.
+     * @param endpoint The endpoint the payload belongs to.
+     * @param payload The payload.
+     */
+    void logPayload (juce::StringRef category, juce::StringRef endpoint, const juce::String& payload);
+
+    /**
+     * @brief Write all the pending entries before returning.
+     */
+    void flush();
+
+    /**
+     * @brief Get the number of entries logged so far.
+     */
+    [[nodiscard]] juce::uint64 getNumLoggedEntries() const;
+
+    /**
+     * @brief Get the configuration of the logger as an object.
+     */
+    [[nodiscard]] juce::var toVar() const;
+
+    /**
+     * @brief Get the log level from its name, like `debug` or `warning`.
+     */
+    [[nodiscard]] static std::optional<LogLevel> levelFromString (juce::StringRef name);
+
+    /**
+     * @brief Get the name of a log level.
+     */
+    [[nodiscard]] static juce::String levelToString (LogLevel level);
+
+    JUCE_DECLARE_SINGLETON (AsyncLogger, false)
+
+private:
+    AsyncLogger();
+
+    class WriterThread;
+
+    struct Sampling
+    {
+        explicit Sampling (int interval)
+            : everyNth (interval)
+        {
+        }
+
+        const int everyNth = 1;
+        std::atomic<juce::uint64> counter { 0 };
+    };
+
+    using SamplingTable = std::unordered_map<juce::String, std::shared_ptr<Sampling>>;
+
+    bool shouldSample (juce::StringRef endpoint) const;
+    void enqueue (LogEntry entry);
+    void writePendingEntries();
+
+    std::atomic<LogLevel> minimumLevel { LogLevel::info };
+    std::atomic<std::size_t> maxPayloadSize { 1024 };
+    std::atomic<juce::uint64> numLoggedEntries { 0 };
+
+    MpscQueue<LogEntry> queue;
+
+    juce::CriticalSection samplingLock;
+    std::atomic<const SamplingTable*> samplingTable { nullptr };
+    std::vector<std::unique_ptr<const SamplingTable>> samplingTables;
+
+    juce::CriticalSection writerLock;
+    Sink sink;
+    std::unique_ptr<WriterThread> writerThread;
+    std::atomic<bool> writerStarted { false };
+
+    JUCE_DECLARE_NON_COPYABLE (AsyncLogger)
+};
+
+} // namespace straw
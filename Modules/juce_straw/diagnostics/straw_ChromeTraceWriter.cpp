@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_ChromeTraceWriter.h"
+
+#include "../helpers/straw_ProcessHelpers.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+juce::String ticksToMicroseconds (juce::int64 ticks)
+{
+    return juce::String (juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6, 3);
+}
+
+} // namespace
+
+//=================================================================================================
+
+ChromeTraceWriter::ChromeTraceWriter()
+    : output (data, false)
+    , processId (static_cast<juce::int64> (Helpers::getCurrentProcessId()))
+{
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+}
+
+//=================================================================================================
+
+void ChromeTraceWriter::addThreadName (juce::int64 threadId, juce::StringRef name)
+{
+    beginEvent();
+
+    output << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << processId
+           << ",\"tid\":" << threadId
+           << ",\"args\":{\"name\":" << juce::JSON::toString (juce::String (name)) << "}}";
+}
+
+void ChromeTraceWriter::addCompleteEvent (juce::StringRef name,
+                                          juce::StringRef category,
+                                          juce::int64 threadId,
+                                          juce::int64 startTicks,
+                                          juce::int64 endTicks,
+                                          const juce::var& args)
+{
+    beginEvent();
+
+    output << "{\"ph\":\"X\",\"name\":" << juce::JSON::toString (juce::String (name))
+           << ",\"cat\":" << juce::JSON::toString (juce::String (category))
+           << ",\"pid\":" << processId
+           << ",\"tid\":" << threadId
+           << ",\"ts\":" << ticksToMicroseconds (startTicks)
+           << ",\"dur\":" << ticksToMicroseconds (juce::jmax (static_cast<juce::int64> (0), endTicks - startTicks));
+
+    if (args.isObject())
+        output << ",\"args\":" << juce::JSON::toString (args, true);
+
+    output << "}";
+}
+
+void ChromeTraceWriter::addInstantEvent (juce::StringRef name, juce::StringRef category, juce::int64 threadId, juce::int64 ticks)
+{
+    beginEvent();
+
+    output << "{\"ph\":\"i\",\"s\":\"t\",\"name\":" << juce::JSON::toString (juce::String (name))
+           << ",\"cat\":" << juce::JSON::toString (juce::String (category))
+           << ",\"pid\":" << processId
+           << ",\"tid\":" << threadId
+           << ",\"ts\":" << ticksToMicroseconds (ticks) << "}";
+}
+
+juce::MemoryBlock ChromeTraceWriter::finish()
+{
+    output << "]}";
+    output.flush();
+
+    return data;
+}
+
+//=================================================================================================
+
+void ChromeTraceWriter::beginEvent()
+{
+    if (hasEvents)
+        output << ",";
+
+    hasEvents = true;
+}
+
+} // namespace straw
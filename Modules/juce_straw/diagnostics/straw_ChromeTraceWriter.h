@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Incrementally writes a trace in the Chrome trace event JSON format.
+ *
+ * The resulting file can be loaded in `chrome://tracing` or in the Perfetto UI. Timestamps are expressed in high resolution
+ * ticks and converted to microseconds when written.
+ */
+class ChromeTraceWriter
+{
+public:
+    /**
+     * @brief Constructor for the ChromeTraceWriter class.
+     */
+    ChromeTraceWriter();
+
+    /**
+     * @brief Add a metadata event naming a thread track.
+     *
+     * @param threadId The identifier of the thread track.
+     * @param name The name to display for the track.
+     */
+    void addThreadName (juce::int64 threadId, juce::StringRef name);
+
+    /**
+     * @brief Add a complete event, a span with a start and a duration.
+     *
+     * @param name The name of the span.
+     * @param category The category of the span.
+     * @param threadId The identifier of the thread track the span belongs to.
+     * @param startTicks The start of the span in high resolution ticks.
+     * @param endTicks The end of the span in high resolution ticks.
+     * @param args Optional arguments to attach to the span, must be an object.
+     */
+    void addCompleteEvent (juce::StringRef name,
+                           juce::StringRef category,
+                           juce::int64 threadId,
+                           juce::int64 startTicks,
+                           juce::int64 endTicks,
+                           const juce::var& args = {});
+
+    /**
+     * @brief Add an instant event, a single point in time.
+     *
+     * @param name The name of the event.
+     * @param category The category of the event.
+     * @param threadId The identifier of the thread track the event belongs to.
+     * @param ticks The time of the event in high resolution ticks.
+     */
+    void addInstantEvent (juce::StringRef name, juce::StringRef category, juce::int64 threadId, juce::int64 ticks);
+
+    /**
+     * @brief Finish the trace and get the resulting JSON document.
+     */
+    [[nodiscard]] juce::MemoryBlock finish();
+
+private:
+    void beginEvent();
+
+    juce::MemoryBlock data;
+    juce::MemoryOutputStream output;
+    juce::int64 processId = 0;
+    bool hasEvents = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ChromeTraceWriter)
+};
+
+} // namespace straw
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A fixed size ring buffer of trivially copyable events, with a single writer and any number of readers.
+ *
+ * Pushing never blocks nor allocates, and overwrites the oldest events when the ring is full. Readers take consistent
+ * snapshots without ever blocking the writer, each slot being protected by its own sequence counter.
+ */
+template <class T, std::size_t Capacity>
+class EventRing
+{
+    static_assert (std::is_trivially_copyable_v<T>, "Events must be trivially copyable");
+
+public:
+    /**
+     * @brief Push an event, must only be called from the writer thread.
+     *
+     * @param item The event to push.
+     */
+    void push (const T& item) noexcept
+    {
+        auto index = writeIndex.load (std::memory_order_relaxed);
+        auto& slot = slots [index % Capacity];
+
+        auto sequence = slot.sequence.load (std::memory_order_relaxed);
+        slot.sequence.store (sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        slot.index = index;
+        std::memcpy (&slot.item, &item, sizeof (T));
+
+        slot.sequence.store (sequence + 2, std::memory_order_release);
+        writeIndex.store (index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Take a snapshot of the events currently in the ring, oldest first.
+     *
+     * Events being overwritten while the snapshot is taken are skipped.
+     */
+    [[nodiscard]] std::vector<T> snapshot() const
+    {
+        std::vector<T> result;
+
+        auto endIndex = writeIndex.load (std::memory_order_acquire);
+        auto beginIndex = endIndex > Capacity ? endIndex - Capacity : 0;
+        result.reserve (static_cast<std::size_t> (endIndex - beginIndex));
+
+        for (auto index = beginIndex; index < endIndex; ++index)
+        {
+            const auto& slot = slots [index % Capacity];
+
+            for (int attempt = 0; attempt < 4; ++attempt)
+            {
+                auto sequenceBefore = slot.sequence.load (std::memory_order_acquire);
+                if ((sequenceBefore & 1) != 0)
+                    continue;
+
+                T item;
+                auto slotIndex = slot.index;
+                std::memcpy (&item, &slot.item, sizeof (T));
+
+                std::atomic_thread_fence (std::memory_order_acquire);
+                if (slot.sequence.load (std::memory_order_relaxed) != sequenceBefore)
+                    continue;
+
+                if (slotIndex == index)
+                    result.push_back (item);
+
+                break;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<juce::uint32> sequence { 0 };
+        juce::uint64 index = 0;
+        T item {};
+    };
+
+    std::array<Slot, Capacity> slots;
+    std::atomic<juce::uint64> writeIndex { 0 };
+};
+
+} // namespace straw
@@ -0,0 +1,400 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_FrameMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+double frameTicksToMilliseconds (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+}
+
+double getSortedPercentile (const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+        return 0.0;
+
+    const auto rank = static_cast<std::size_t> (std::ceil (percentile / 100.0 * static_cast<double> (sortedValues.size())));
+    return sortedValues [juce::jlimit<std::size_t> (1, sortedValues.size(), rank) - 1];
+}
+
+juce::var makeFrameTimeVar (std::vector<double> frameTimes)
+{
+    std::sort (frameTimes.begin(), frameTimes.end());
+
+    double sum = 0.0;
+    for (auto frameTime : frameTimes)
+        sum += frameTime;
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("mean", frameTimes.empty() ? 0.0 : sum / static_cast<double> (frameTimes.size()));
+    object->setProperty ("p50", getSortedPercentile (frameTimes, 50.0));
+    object->setProperty ("p95", getSortedPercentile (frameTimes, 95.0));
+    object->setProperty ("p99", getSortedPercentile (frameTimes, 99.0));
+    object->setProperty ("max", frameTimes.empty() ? 0.0 : frameTimes.back());
+    return object.get();
+}
+
+juce::Component& findRepaintedComponent (juce::Component& window, juce::Rectangle<int>& area)
+{
+    auto* component = &window;
+
+    // Walk down to the innermost visible component covering the area, children on top first
+    for (;;)
+    {
+        juce::Component* coveringChild = nullptr;
+
+        for (int index = component->getNumChildComponents(); --index >= 0;)
+        {
+            auto* child = component->getChildComponent (index);
+
+            if (child->isVisible() && child->getBoundsInParent().contains (area))
+            {
+                coveringChild = child;
+                break;
+            }
+        }
+
+        if (coveringChild == nullptr)
+            return *component;
+
+        area = coveringChild->getLocalArea (component, area);
+        component = coveringChild;
+    }
+}
+
+} // namespace
+
+//=================================================================================================
+
+class FrameMonitor::RepaintHook : public juce::CachedComponentImage
+{
+public:
+    RepaintHook (FrameMonitor& monitorToNotify, juce::Component& windowToHook)
+        : monitor (monitorToNotify)
+        , window (windowToHook)
+    {
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        // This is how the window paints itself when it has no cached image
+        window.paintEntireComponent (g, false);
+    }
+
+    bool invalidateAll() override
+    {
+        monitor.recordRepaint (window, window.getLocalBounds());
+        return true;
+    }
+
+    bool invalidate (const juce::Rectangle<int>& area) override
+    {
+        monitor.recordRepaint (window, area);
+        return true;
+    }
+
+    void releaseResources() override
+    {
+    }
+
+private:
+    FrameMonitor& monitor;
+    juce::Component& window;
+
+    JUCE_DECLARE_NON_COPYABLE (RepaintHook)
+};
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (FrameMonitor)
+
+FrameMonitor::~FrameMonitor()
+{
+    stopTimer();
+    untrackAll();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void FrameMonitor::start()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    stop();
+
+    // Serials keep increasing, so events of previous capture windows never refer to the new components
+    monitoredComponents.clear();
+
+    captureStartTicks = juce::Time::getHighResolutionTicks();
+    captureEndTicks = 0;
+    running = true;
+
+    update();
+
+    // Windows added to the desktop are picked up periodically
+    startTimer (250);
+}
+
+void FrameMonitor::stop()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (! running)
+        return;
+
+    stopTimer();
+    untrackAll();
+
+    pendingRepaints.clear();
+
+    captureEndTicks = juce::Time::getHighResolutionTicks();
+    running = false;
+}
+
+bool FrameMonitor::isRunning() const
+{
+    return running;
+}
+
+//=================================================================================================
+
+juce::var FrameMonitor::getStatistics (int maxComponents) const
+{
+    const auto endTicks = running ? juce::Time::getHighResolutionTicks() : captureEndTicks;
+    const auto isInCaptureWindow = [this, endTicks] (juce::int64 ticks) { return ticks >= captureStartTicks && ticks <= endTicks; };
+
+    std::unordered_map<juce::uint32, std::vector<FrameEvent>> framesByWindow;
+    for (const auto& frame : frames.snapshot())
+    {
+        if (isInCaptureWindow (frame.ticks))
+            framesByWindow [frame.windowSerial].push_back (frame);
+    }
+
+    std::vector<double> vblankIntervals;
+    std::vector<double> frameTimes;
+    int numVBlanks = 0;
+
+    for (const auto& [windowSerial, windowFrames] : framesByWindow)
+    {
+        numVBlanks += static_cast<int> (windowFrames.size());
+
+        for (std::size_t index = 1; index < windowFrames.size(); ++index)
+        {
+            const auto interval = frameTicksToMilliseconds (windowFrames [index].ticks - windowFrames [index - 1].ticks);
+            vblankIntervals.push_back (interval);
+
+            if (windowFrames [index].numRepaints > 0)
+                frameTimes.push_back (interval);
+        }
+    }
+
+    std::sort (vblankIntervals.begin(), vblankIntervals.end());
+    const auto refreshInterval = getSortedPercentile (vblankIntervals, 50.0);
+
+    int droppedFrames = 0;
+    if (refreshInterval > 0.0)
+    {
+        for (auto frameTime : frameTimes)
+            droppedFrames += juce::jmax (0, juce::roundToInt (frameTime / refreshInterval) - 1);
+    }
+
+    struct RepaintCount
+    {
+        juce::uint32 componentSerial = 0;
+        int numRepaints = 0;
+        juce::int64 repaintedPixels = 0;
+    };
+
+    std::unordered_map<juce::uint32, RepaintCount> repaintCounts;
+    int numRepaints = 0;
+
+    for (const auto& repaint : repaints.snapshot())
+    {
+        if (! isInCaptureWindow (repaint.ticks))
+            continue;
+
+        auto& repaintCount = repaintCounts [repaint.componentSerial];
+        repaintCount.componentSerial = repaint.componentSerial;
+        repaintCount.numRepaints += 1;
+        repaintCount.repaintedPixels += static_cast<juce::int64> (repaint.width) * repaint.height;
+
+        ++numRepaints;
+    }
+
+    std::vector<RepaintCount> topRepaintCounts;
+    for (const auto& [componentSerial, repaintCount] : repaintCounts)
+        topRepaintCounts.push_back (repaintCount);
+
+    std::sort (topRepaintCounts.begin(), topRepaintCounts.end(), [] (const auto& lhs, const auto& rhs)
+    {
+        return lhs.numRepaints != rhs.numRepaints ? lhs.numRepaints > rhs.numRepaints : lhs.repaintedPixels > rhs.repaintedPixels;
+    });
+
+    juce::Array<juce::var> topComponents;
+    for (const auto& repaintCount : topRepaintCounts)
+    {
+        if (topComponents.size() >= maxComponents)
+            break;
+
+        juce::DynamicObject::Ptr component = new juce::DynamicObject;
+
+        if (auto monitoredComponent = monitoredComponents.find (repaintCount.componentSerial); monitoredComponent != monitoredComponents.end())
+        {
+            component->setProperty ("id", monitoredComponent->second.componentID);
+            component->setProperty ("name", monitoredComponent->second.name);
+            component->setProperty ("type", monitoredComponent->second.type);
+        }
+
+        component->setProperty ("repaints", repaintCount.numRepaints);
+        component->setProperty ("repainted_pixels", repaintCount.repaintedPixels);
+        topComponents.add (component.get());
+    }
+
+    const auto durationSeconds = captureStartTicks != 0 ? juce::Time::highResolutionTicksToSeconds (endTicks - captureStartTicks) : 0.0;
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("running", running);
+    object->setProperty ("duration_ms", durationSeconds * 1000.0);
+    object->setProperty ("num_vblanks", numVBlanks);
+    object->setProperty ("refresh_interval_ms", refreshInterval);
+    object->setProperty ("num_frames", static_cast<int> (frameTimes.size()));
+    object->setProperty ("dropped_frames", droppedFrames);
+    object->setProperty ("frame_time_ms", makeFrameTimeVar (frameTimes));
+    object->setProperty ("fps", durationSeconds > 0.0 ? static_cast<double> (frameTimes.size()) / durationSeconds : 0.0);
+    object->setProperty ("num_repaints", numRepaints);
+    object->setProperty ("repaints_per_second", durationSeconds > 0.0 ? numRepaints / durationSeconds : 0.0);
+    object->setProperty ("top_components", std::move (topComponents));
+    return object.get();
+}
+
+//=================================================================================================
+
+void FrameMonitor::componentTracked (juce::Component& component)
+{
+    const auto serial = ++lastSerial;
+
+    componentSerials [&component] = serial;
+    monitoredComponents [serial] = { component.getComponentID(),
+                                     component.getName(),
+                                     popsicle::Helpers::demangleClassName (typeid (component).name()) };
+
+    if (component.getParentComponent() != nullptr)
+        return;
+
+    vblankAttachments [&component] = std::make_unique<juce::VBlankAttachment> (&component, [this, &component] { recordFrame (component); });
+
+    // Only windows are hooked, every repaint reaches them, while the components keep their cached image slot for buffering
+    if (component.getCachedComponentImage() == nullptr)
+        component.setCachedComponentImage (new RepaintHook (*this, component));
+}
+
+void FrameMonitor::componentUntracked (juce::Component& component, bool isBeingDeleted)
+{
+    vblankAttachments.erase (&component);
+    pendingRepaints.erase (&component);
+    componentSerials.erase (&component);
+
+    // Components being deleted delete their hook themselves
+    if (! isBeingDeleted && dynamic_cast<RepaintHook*> (component.getCachedComponentImage()) != nullptr)
+        component.setCachedComponentImage (nullptr);
+}
+
+void FrameMonitor::componentsChanged (const std::unordered_set<juce::Component*>& components)
+{
+    for (auto component : components)
+    {
+        if (auto serial = componentSerials.find (component); serial != componentSerials.end())
+        {
+            auto& monitoredComponent = monitoredComponents [serial->second];
+            monitoredComponent.componentID = component->getComponentID();
+            monitoredComponent.name = component->getName();
+        }
+    }
+}
+
+//=================================================================================================
+
+void FrameMonitor::timerCallback()
+{
+    update();
+}
+
+//=================================================================================================
+
+void FrameMonitor::recordRepaint (juce::Component& window, juce::Rectangle<int> area)
+{
+    if (! isTracked (&window) || area.isEmpty())
+        return;
+
+    // Repaints reach the window in its own coordinates, they are attributed to the component they most likely come from
+    auto* component = &findRepaintedComponent (window, area);
+
+    // Components added since the last update aren't tracked yet, their closest tracked parent is accounted instead
+    auto serial = componentSerials.find (component);
+    while (serial == componentSerials.end() && component != &window)
+    {
+        auto* parent = component->getParentComponent();
+        area = parent->getLocalArea (component, area);
+        component = parent;
+        serial = componentSerials.find (component);
+    }
+
+    if (serial == componentSerials.end())
+        return;
+
+    RepaintEvent repaint;
+    repaint.componentSerial = serial->second;
+    repaint.x = area.getX();
+    repaint.y = area.getY();
+    repaint.width = area.getWidth();
+    repaint.height = area.getHeight();
+    repaint.ticks = juce::Time::getHighResolutionTicks();
+    repaints.push (repaint);
+
+    pendingRepaints [&window] += 1;
+}
+
+void FrameMonitor::recordFrame (juce::Component& window)
+{
+    auto serial = componentSerials.find (&window);
+    if (serial == componentSerials.end())
+        return;
+
+    FrameEvent frame;
+    frame.windowSerial = serial->second;
+    frame.numRepaints = std::exchange (pendingRepaints [&window], 0u);
+    frame.ticks = juce::Time::getHighResolutionTicks();
+    frames.push (frame);
+}
+
+} // namespace straw
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_EventRing.h"
+#include "../helpers/straw_ComponentTracker.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A vertical blank of a window, with the number of repaints requested in the window since the previous one.
+ */
+struct FrameEvent
+{
+    juce::uint32 windowSerial = 0;
+    juce::uint32 numRepaints = 0;
+    juce::int64 ticks = 0;
+};
+
+/**
+ * @brief A repaint requested by a component, with the repainted area in the component coordinates.
+ */
+struct RepaintEvent
+{
+    juce::uint32 componentSerial = 0;
+    juce::int32 x = 0;
+    juce::int32 y = 0;
+    juce::int32 width = 0;
+    juce::int32 height = 0;
+    juce::int64 ticks = 0;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Monitors the frame timing and the repaint rate of all the windows on the desktop, over a capture window.
+ *
+ * Each window gets a `juce::VBlankAttachment`, recording the interval between vertical blanks, which are delivered on the
+ * message thread and so are delayed by slow paints and busy message threads. Each window also gets a repaint hook installed
+ * as its `juce::CachedComponentImage`, painting the window exactly as it would without one, and recording the areas of the
+ * window the repaints invalidate. A repaint is attributed to the innermost visible component covering its area, which is
+ * where it comes from unless a child covers its parent entirely. Components other than the windows are never hooked, so
+ * they can be buffered to an image or not while monitored. Windows already buffered to an image aren't hooked and don't
+ * record repaints. Frames and repaints are kept in lock-free ring buffers, so the statistics cover the most recent events
+ * of the capture window.
+ *
+ * Must be used from the message thread.
+ */
+class FrameMonitor
+    : public juce::DeletedAtShutdown
+    , private ComponentTracker
+    , private juce::Timer
+{
+public:
+    /**
+     * @brief Destructor for the FrameMonitor class.
+     */
+    ~FrameMonitor() override;
+
+    /**
+     * @brief Start a new capture window, hooking all the windows on the desktop.
+     */
+    void start();
+
+    /**
+     * @brief Stop the capture window, removing all the hooks.
+     */
+    void stop();
+
+    /**
+     * @brief Check if a capture window is in progress.
+     */
+    [[nodiscard]] bool isRunning() const;
+
+    /**
+     * @brief Get the jank statistics of the last capture window.
+     *
+     * The frame times are the vertical blank intervals with repaints to present, and the dropped frames the vertical blanks
+     * those intervals missed, compared to the median vertical blank interval. An idle interface has no frames to present.
+     *
+     * @param maxComponents The number of top repainting components to return.
+     *
+     * @return The statistics, with the top repainting components.
+     */
+    [[nodiscard]] juce::var getStatistics (int maxComponents = 10) const;
+
+    JUCE_DECLARE_SINGLETON (FrameMonitor, false)
+
+private:
+    FrameMonitor() = default;
+
+    class RepaintHook;
+
+    struct MonitoredComponent
+    {
+        juce::String componentID;
+        juce::String name;
+        juce::String type;
+    };
+
+    void componentTracked (juce::Component& component) override;
+    void componentUntracked (juce::Component& component, bool isBeingDeleted) override;
+    void componentsChanged (const std::unordered_set<juce::Component*>& components) override;
+
+    void timerCallback() override;
+
+    void recordRepaint (juce::Component& window, juce::Rectangle<int> area);
+    void recordFrame (juce::Component& window);
+
+    EventRing<FrameEvent, 8192> frames;
+    EventRing<RepaintEvent, 16384> repaints;
+
+    std::unordered_map<juce::Component*, juce::uint32> componentSerials;
+    std::unordered_map<juce::uint32, MonitoredComponent> monitoredComponents;
+    std::unordered_map<juce::Component*, std::unique_ptr<juce::VBlankAttachment>> vblankAttachments;
+    std::unordered_map<juce::Component*, juce::uint32> pendingRepaints;
+    juce::uint32 lastSerial = 0;
+
+    juce::int64 captureStartTicks = 0;
+    juce::int64 captureEndTicks = 0;
+    bool running = false;
+};
+
+} // namespace straw
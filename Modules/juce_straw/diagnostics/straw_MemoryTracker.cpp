@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_MemoryTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unordered_set>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+std::atomic<juce::uint64> totalAllocations { 0 };
+std::atomic<juce::uint64> totalDeallocations { 0 };
+std::atomic<juce::uint64> totalAllocatedBytes { 0 };
+std::atomic<juce::int64> currentLiveBytes { 0 };
+std::atomic<juce::int64> currentPeakLiveBytes { 0 };
+
+void raisePeakLiveBytes (juce::int64 liveBytes) noexcept
+{
+    auto peakLiveBytes = currentPeakLiveBytes.load (std::memory_order_relaxed);
+
+    while (liveBytes > peakLiveBytes
+           && ! currentPeakLiveBytes.compare_exchange_weak (peakLiveBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+#if STRAW_ENABLE_ALLOCATION_TRACKING
+// The size of each allocation is stored in front of it, keeping the default new alignment
+constexpr std::size_t allocationHeaderSize = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void* trackedAllocate (std::size_t size)
+{
+    for (;;)
+    {
+        if (auto block = static_cast<char*> (std::malloc (size + allocationHeaderSize)))
+        {
+            *reinterpret_cast<std::size_t*> (block) = size;
+
+            totalAllocations.fetch_add (1, std::memory_order_relaxed);
+            totalAllocatedBytes.fetch_add (size, std::memory_order_relaxed);
+            raisePeakLiveBytes (currentLiveBytes.fetch_add (static_cast<juce::int64> (size), std::memory_order_relaxed) + static_cast<juce::int64> (size));
+
+            return block + allocationHeaderSize;
+        }
+
+        auto newHandler = std::get_new_handler();
+        if (newHandler == nullptr)
+            throw std::bad_alloc();
+
+        newHandler();
+    }
+}
+
+void trackedDeallocate (void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    auto block = static_cast<char*> (pointer) - allocationHeaderSize;
+    const auto size = *reinterpret_cast<std::size_t*> (block);
+
+    totalDeallocations.fetch_add (1, std::memory_order_relaxed);
+    currentLiveBytes.fetch_sub (static_cast<juce::int64> (size), std::memory_order_relaxed);
+
+    std::free (block);
+}
+#endif
+
+int getBytesPerPixel (const juce::Image& image)
+{
+    switch (image.getFormat())
+    {
+        case juce::Image::ARGB: return 4;
+        case juce::Image::RGB: return 3;
+        case juce::Image::SingleChannel: return 1;
+        case juce::Image::UnknownFormat:
+        default: break;
+    }
+
+    return 0;
+}
+
+void addReachableMemory (juce::Component& component, std::unordered_set<const void*>& countedPixelData, MemorySnapshot& snapshot)
+{
+    ++snapshot.numComponents;
+    ++snapshot.componentsByType [popsicle::Helpers::demangleClassName (typeid (component).name())];
+
+    // Images are shared, their pixel data is only counted once
+    const auto addImage = [&] (const juce::Image& image)
+    {
+        const void* pixelData = image.getPixelData();
+
+        if (image.isValid() && countedPixelData.insert (pixelData).second)
+        {
+            snapshot.imageBytes += static_cast<juce::int64> (image.getWidth()) * image.getHeight() * getBytesPerPixel (image);
+            ++snapshot.numImages;
+        }
+    };
+
+    if (auto imageComponent = dynamic_cast<juce::ImageComponent*> (&component))
+    {
+        addImage (imageComponent->getImage());
+    }
+    else if (auto imageButton = dynamic_cast<juce::ImageButton*> (&component))
+    {
+        addImage (imageButton->getNormalImage());
+        addImage (imageButton->getOverImage());
+        addImage (imageButton->getDownImage());
+    }
+    else if (auto drawableImage = dynamic_cast<juce::DrawableImage*> (&component))
+    {
+        addImage (drawableImage->getImage());
+    }
+
+    for (auto child : component.getChildren())
+        addReachableMemory (*child, countedPixelData, snapshot);
+}
+
+juce::var makeComponentsByTypeVar (const std::map<juce::String, int>& componentsByType)
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+
+    for (const auto& [type, count] : componentsByType)
+        object->setProperty (type, count);
+
+    return object.get();
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::var MemorySnapshot::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("allocations", static_cast<juce::int64> (numAllocations));
+    object->setProperty ("deallocations", static_cast<juce::int64> (numDeallocations));
+    object->setProperty ("allocated_bytes", static_cast<juce::int64> (allocatedBytes));
+    object->setProperty ("live_bytes", liveBytes);
+    object->setProperty ("peak_live_bytes", peakLiveBytes);
+    object->setProperty ("image_bytes", imageBytes);
+    object->setProperty ("images", numImages);
+    object->setProperty ("components", numComponents);
+    object->setProperty ("components_by_type", makeComponentsByTypeVar (componentsByType));
+    return object.get();
+}
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (MemoryTracker)
+
+MemoryTracker::~MemoryTracker()
+{
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+bool MemoryTracker::isAllocationTrackingEnabled() noexcept
+{
+    return STRAW_ENABLE_ALLOCATION_TRACKING != 0;
+}
+
+MemorySnapshot MemoryTracker::capture()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    MemorySnapshot snapshot;
+    snapshot.numAllocations = totalAllocations.load (std::memory_order_relaxed);
+    snapshot.numDeallocations = totalDeallocations.load (std::memory_order_relaxed);
+    snapshot.allocatedBytes = totalAllocatedBytes.load (std::memory_order_relaxed);
+    snapshot.liveBytes = currentLiveBytes.load (std::memory_order_relaxed);
+    snapshot.peakLiveBytes = currentPeakLiveBytes.load (std::memory_order_relaxed);
+
+    std::unordered_set<const void*> countedPixelData;
+
+    auto& desktop = juce::Desktop::getInstance();
+    for (int index = 0; index < desktop.getNumComponents(); ++index)
+        addReachableMemory (*desktop.getComponent (index), countedPixelData, snapshot);
+
+    return snapshot;
+}
+
+juce::var MemoryTracker::makeReport (const MemorySnapshot& before, const MemorySnapshot& after)
+{
+    juce::DynamicObject::Ptr componentsByType = new juce::DynamicObject;
+
+    auto types = after.componentsByType;
+    for (const auto& [type, count] : before.componentsByType)
+        types.emplace (type, 0);
+
+    for (const auto& [type, count] : types)
+    {
+        const auto countBefore = before.componentsByType.count (type) > 0 ? before.componentsByType.at (type) : 0;
+        const auto countAfter = after.componentsByType.count (type) > 0 ? after.componentsByType.at (type) : 0;
+
+        if (countAfter != countBefore)
+            componentsByType->setProperty (type, countAfter - countBefore);
+    }
+
+    juce::DynamicObject::Ptr delta = new juce::DynamicObject;
+    delta->setProperty ("allocations", static_cast<juce::int64> (after.numAllocations - before.numAllocations));
+    delta->setProperty ("deallocations", static_cast<juce::int64> (after.numDeallocations - before.numDeallocations));
+    delta->setProperty ("allocated_bytes", static_cast<juce::int64> (after.allocatedBytes - before.allocatedBytes));
+    delta->setProperty ("live_bytes", after.liveBytes - before.liveBytes);
+    delta->setProperty ("peak_live_bytes", juce::jmax<juce::int64> (0, after.peakLiveBytes - before.liveBytes));
+    delta->setProperty ("image_bytes", after.imageBytes - before.imageBytes);
+    delta->setProperty ("images", after.numImages - before.numImages);
+    delta->setProperty ("components", after.numComponents - before.numComponents);
+    delta->setProperty ("components_by_type", componentsByType.get());
+
+    juce::DynamicObject::Ptr report = new juce::DynamicObject;
+    report->setProperty ("allocation_tracking", isAllocationTrackingEnabled());
+    report->setProperty ("before", before.toVar());
+    report->setProperty ("after", after.toVar());
+    report->setProperty ("delta", delta.get());
+    return report.get();
+}
+
+//=================================================================================================
+
+void MemoryTracker::beginReport()
+{
+    reportSnapshots.push_back (capture());
+
+    // The peak is measured from the beginning of the report, the enclosing reports get it back when it ends
+    currentPeakLiveBytes.store (currentLiveBytes.load (std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+juce::var MemoryTracker::endReport()
+{
+    if (reportSnapshots.empty())
+        return {};
+
+    const auto before = std::move (reportSnapshots.back());
+    reportSnapshots.pop_back();
+
+    const auto after = capture();
+    raisePeakLiveBytes (before.peakLiveBytes);
+
+    return makeReport (before, after);
+}
+
+} // namespace straw
+
+//=================================================================================================
+
+#if STRAW_ENABLE_ALLOCATION_TRACKING
+void* operator new (std::size_t size)
+{
+    return straw::trackedAllocate (size);
+}
+
+void* operator new[] (std::size_t size)
+{
+    return straw::trackedAllocate (size);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return straw::trackedAllocate (size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return straw::trackedAllocate (size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete (void* pointer) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+
+void operator delete[] (void* pointer) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+
+void operator delete (void* pointer, std::size_t) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+
+void operator delete[] (void* pointer, std::size_t) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+
+void operator delete (void* pointer, const std::nothrow_t&) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept
+{
+    straw::trackedDeallocate (pointer);
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The memory used by the application at a point in time.
+ *
+ * Allocation counters are only collected when the module is compiled with `STRAW_ENABLE_ALLOCATION_TRACKING`, which replaces
+ * the global `operator new` and `operator delete`. Allocations bypassing them, like `std::malloc`, aren't counted. Images and
+ * components are counted among the ones reachable from the windows on the desktop: the images shown by image components,
+ * image buttons and drawable images, and the components by their type.
+ */
+struct MemorySnapshot
+{
+    juce::uint64 numAllocations = 0;
+    juce::uint64 numDeallocations = 0;
+    juce::uint64 allocatedBytes = 0;     // cumulative, since the application started
+    juce::int64 liveBytes = 0;
+    juce::int64 peakLiveBytes = 0;       // since the application started, or since the current report began
+
+    juce::int64 imageBytes = 0;
+    int numImages = 0;
+
+    int numComponents = 0;
+    std::map<juce::String, int> componentsByType;
+
+    /**
+     * @brief Convert the snapshot to a var.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Accounts the allocations, image memory and live components of the application, for memory regression checks.
+ *
+ * Reports measure the difference between the beginning and the end of a scope, like a script or a test function, and can
+ * be nested. Must be used from the message thread, except for the allocation counters which can be read from any thread.
+ */
+class MemoryTracker : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Destructor for the MemoryTracker class.
+     */
+    ~MemoryTracker() override;
+
+    /**
+     * @brief Check if the module has been compiled with `STRAW_ENABLE_ALLOCATION_TRACKING`.
+     */
+    [[nodiscard]] static bool isAllocationTrackingEnabled() noexcept;
+
+    /**
+     * @brief Take a snapshot of the memory currently used.
+     */
+    [[nodiscard]] static MemorySnapshot capture();
+
+    /**
+     * @brief Make a report of the memory used between two snapshots.
+     *
+     * The report has the `before` and `after` snapshots and their `delta`, where the peak is the growth of the peak over the
+     * live bytes before, and only the component types whose count changed are listed.
+     */
+    [[nodiscard]] static juce::var makeReport (const MemorySnapshot& before, const MemorySnapshot& after);
+
+    /**
+     * @brief Begin a report, resetting the peak of the live bytes.
+     */
+    void beginReport();
+
+    /**
+     * @brief End the innermost report.
+     *
+     * @return The report, or a void var if no report has begun.
+     */
+    [[nodiscard]] juce::var endReport();
+
+    JUCE_DECLARE_SINGLETON (MemoryTracker, false)
+
+private:
+    MemoryTracker() = default;
+
+    std::vector<MemorySnapshot> reportSnapshots;
+};
+
+} // namespace straw
@@ -0,0 +1,321 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_MessageThreadTracer.h"
+#include "straw_ChromeTraceWriter.h"
+#include "straw_SessionTracer.h"
+
+#include <juce_events/juce_events.h>
+
+#include <cstring>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+double ticksToMilliseconds (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+}
+
+juce::var makeMessageThreadEventVar (const MessageThreadEvent& event)
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("name", event.getName());
+    object->setProperty ("enqueued_ms", ticksToMilliseconds (event.enqueueTicks));
+    object->setProperty ("wait_ms", ticksToMilliseconds (event.startTicks - event.enqueueTicks));
+
+    if (event.endTicks != 0)
+        object->setProperty ("duration_ms", ticksToMilliseconds (event.endTicks - event.startTicks));
+
+    return object.get();
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::String MessageThreadEvent::getName() const
+{
+    return juce::String::fromUTF8 (name.data());
+}
+
+void MessageThreadEvent::setName (juce::StringRef newName) noexcept
+{
+    name.fill (0);
+    juce::String (newName).copyToUTF8 (name.data(), name.size());
+}
+
+//=================================================================================================
+
+class MessageThreadTracer::Watchdog : public juce::Thread
+{
+public:
+    explicit Watchdog (MessageThreadTracer& tracerToWatch)
+        : juce::Thread ("Straw Stall Watchdog")
+        , tracer (tracerToWatch)
+    {
+    }
+
+    ~Watchdog() override
+    {
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            auto threshold = tracer.getStallThreshold();
+            if (threshold <= 0)
+                break;
+
+            auto heartbeat = std::make_shared<std::atomic<juce::int64>> (0);
+            auto postedTicks = juce::Time::getHighResolutionTicks();
+
+            if (juce::MessageManager::callAsync ([heartbeat] { heartbeat->store (juce::Time::getHighResolutionTicks()); }))
+                waitForHeartbeat (*heartbeat, postedTicks, threshold);
+
+            wait (juce::jmax (10, threshold / 2));
+        }
+    }
+
+private:
+    void waitForHeartbeat (const std::atomic<juce::int64>& heartbeat, juce::int64 postedTicks, int threshold)
+    {
+        MessageThreadEvent stall;
+        bool isStalled = false;
+
+        while (! threadShouldExit())
+        {
+            auto dispatchedTicks = heartbeat.load();
+            if (dispatchedTicks != 0)
+            {
+                if (isStalled)
+                {
+                    stall.endTicks = dispatchedTicks;
+                    tracer.recordStall (stall);
+                }
+
+                return;
+            }
+
+            auto currentTicks = juce::Time::getHighResolutionTicks();
+            if (! isStalled && ticksToMilliseconds (currentTicks - postedTicks) > threshold)
+            {
+                isStalled = true;
+
+                MessageThreadEvent hop;
+                stall.setName (tracer.getActiveHop (hop) ? hop.getName() : juce::String ("application"));
+                stall.enqueueTicks = postedTicks;
+                stall.startTicks = currentTicks;
+            }
+
+            wait (juce::jlimit (1, 10, threshold / 4));
+        }
+    }
+
+    MessageThreadTracer& tracer;
+};
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (MessageThreadTracer)
+
+MessageThreadTracer::MessageThreadTracer() = default;
+
+MessageThreadTracer::~MessageThreadTracer()
+{
+    // Deleted before the message manager, so the watchdog never posts heartbeats to a dead queue
+    setStallThreshold (0);
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+std::function<void()> MessageThreadTracer::wrap (juce::StringRef name, std::function<void()> function)
+{
+    MessageThreadEvent hop;
+    hop.setName (name);
+    hop.enqueueTicks = juce::Time::getHighResolutionTicks();
+
+    return [this, hop, function = std::move (function)]() mutable
+    {
+        hop.startTicks = juce::Time::getHighResolutionTicks();
+        beginHop (hop);
+
+        {
+            ScopedTraceSpan span ("message_thread", hop.name.data());
+            function();
+        }
+
+        hop.endTicks = juce::Time::getHighResolutionTicks();
+        endHop (hop);
+    };
+}
+
+//=================================================================================================
+
+void MessageThreadTracer::setStallThreshold (int thresholdMilliseconds)
+{
+    auto lock = juce::CriticalSection::ScopedLockType (watchdogLock);
+
+    stallThreshold.store (juce::jmax (0, thresholdMilliseconds));
+
+    if (thresholdMilliseconds <= 0)
+    {
+        watchdog.reset();
+        return;
+    }
+
+    if (watchdog == nullptr || ! watchdog->isThreadRunning())
+    {
+        watchdog = std::make_unique<Watchdog> (*this);
+        watchdog->startThread();
+    }
+}
+
+int MessageThreadTracer::getStallThreshold() const
+{
+    return stallThreshold.load();
+}
+
+//=================================================================================================
+
+std::vector<MessageThreadEvent> MessageThreadTracer::getHops() const
+{
+    return hops.snapshot();
+}
+
+std::vector<MessageThreadEvent> MessageThreadTracer::getStalls() const
+{
+    return stalls.snapshot();
+}
+
+bool MessageThreadTracer::getActiveHop (MessageThreadEvent& hop) const
+{
+    for (int attempt = 0; attempt < 16; ++attempt)
+    {
+        auto sequenceBefore = activeHopSequence.load (std::memory_order_acquire);
+        if ((sequenceBefore & 1) != 0)
+            continue;
+
+        std::memcpy (&hop, &activeHop, sizeof (MessageThreadEvent));
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+        if (activeHopSequence.load (std::memory_order_relaxed) == sequenceBefore)
+            return hop.startTicks != 0;
+    }
+
+    return false;
+}
+
+//=================================================================================================
+
+void MessageThreadTracer::beginHop (const MessageThreadEvent& hop) noexcept
+{
+    activeHopStack.push_back (hop);
+    publishActiveHop();
+}
+
+void MessageThreadTracer::endHop (const MessageThreadEvent& hop) noexcept
+{
+    if (! activeHopStack.empty())
+        activeHopStack.pop_back();
+
+    publishActiveHop();
+
+    hops.push (hop);
+}
+
+void MessageThreadTracer::publishActiveHop() noexcept
+{
+    auto sequence = activeHopSequence.load (std::memory_order_relaxed);
+    activeHopSequence.store (sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    if (activeHopStack.empty())
+        activeHop = {};
+    else
+        activeHop = activeHopStack.back();
+
+    activeHopSequence.store (sequence + 2, std::memory_order_release);
+}
+
+void MessageThreadTracer::recordStall (const MessageThreadEvent& stall) noexcept
+{
+    stalls.push (stall);
+}
+
+//=================================================================================================
+
+juce::var MessageThreadTracer::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("stall_threshold_ms", getStallThreshold());
+
+    MessageThreadEvent hop;
+    if (getActiveHop (hop))
+    {
+        juce::DynamicObject::Ptr active = new juce::DynamicObject;
+        active->setProperty ("name", hop.getName());
+        active->setProperty ("elapsed_ms", ticksToMilliseconds (juce::Time::getHighResolutionTicks() - hop.startTicks));
+        object->setProperty ("active", active.get());
+    }
+
+    juce::Array<juce::var> hopsArray;
+    for (const auto& event : getHops())
+        hopsArray.add (makeMessageThreadEventVar (event));
+    object->setProperty ("hops", std::move (hopsArray));
+
+    juce::Array<juce::var> stallsArray;
+    for (const auto& event : getStalls())
+        stallsArray.add (makeMessageThreadEventVar (event));
+    object->setProperty ("stalls", std::move (stallsArray));
+
+    return object.get();
+}
+
+juce::MemoryBlock MessageThreadTracer::toChromeTrace() const
+{
+    enum { queueTrack = 1, messageThreadTrack, stallsTrack };
+
+    ChromeTraceWriter writer;
+    writer.addThreadName (queueTrack, "Message Thread Queue");
+    writer.addThreadName (messageThreadTrack, "Message Thread");
+    writer.addThreadName (stallsTrack, "Message Thread Stalls");
+
+    for (const auto& hop : getHops())
+    {
+        auto name = hop.getName();
+        writer.addCompleteEvent (name, "straw.hop.wait", queueTrack, hop.enqueueTicks, hop.startTicks);
+        writer.addCompleteEvent (name, "straw.hop", messageThreadTrack, hop.startTicks, hop.endTicks);
+    }
+
+    for (const auto& stall : getStalls())
+        writer.addCompleteEvent (stall.getName(), "straw.stall", stallsTrack, stall.enqueueTicks, stall.endTicks);
+
+    return writer.finish();
+}
+
+} // namespace straw
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "straw_EventRing.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A message thread hop, or a message thread stall.
+ */
+struct MessageThreadEvent
+{
+    static constexpr std::size_t maxNameLength = 63;
+
+    std::array<char, maxNameLength + 1> name {};
+    juce::int64 enqueueTicks = 0;   // when the hop was posted, or when the stalled message thread was last seen alive
+    juce::int64 startTicks = 0;     // when the hop started executing, or when the stall was detected
+    juce::int64 endTicks = 0;       // when the hop finished executing, or when the message thread recovered
+
+    [[nodiscard]] juce::String getName() const;
+    void setName (juce::StringRef newName) noexcept;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Traces the automation messages posted to the message thread and detects message thread stalls.
+ *
+ * Every hop posted through `callOnMessageThread` is timestamped at enqueue, dispatch start and completion, and kept in a
+ * lock-free ring buffer that can be read from any thread, even while the message thread is stuck.
+ *
+ * When stall detection is enabled, a watchdog thread posts heartbeats to the message thread. A stall is recorded when a
+ * heartbeat or an automation handler is delayed more than the threshold, together with the name of the automation handler
+ * that was running at the time, or "application" when the message thread was busy with application code.
+ */
+class MessageThreadTracer : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Destructor for the MessageThreadTracer class, stops the stall watchdog.
+     */
+    ~MessageThreadTracer() override;
+
+    /**
+     * @brief Wrap a function so its execution on the message thread is traced.
+     *
+     * @param name The name of the hop, usually the endpoint being served.
+     * @param function The function that will be posted to the message thread.
+     *
+     * @return The wrapped function.
+     */
+    [[nodiscard]] std::function<void()> wrap (juce::StringRef name, std::function<void()> function);
+
+    /**
+     * @brief Enable or disable the stall detection.
+     *
+     * @param thresholdMilliseconds The stall threshold in milliseconds, zero or negative to disable stall detection.
+     */
+    void setStallThreshold (int thresholdMilliseconds);
+
+    /**
+     * @brief Get the stall threshold in milliseconds, zero when stall detection is disabled.
+     */
+    [[nodiscard]] int getStallThreshold() const;
+
+    /**
+     * @brief Get the most recent hops, oldest first.
+     */
+    [[nodiscard]] std::vector<MessageThreadEvent> getHops() const;
+
+    /**
+     * @brief Get the most recent stalls, oldest first.
+     */
+    [[nodiscard]] std::vector<MessageThreadEvent> getStalls() const;
+
+    /**
+     * @brief Get the hop currently executing on the message thread, if any.
+     *
+     * @param hop The hop to fill, its end ticks are zero.
+     *
+     * @return True if a hop is currently executing.
+     */
+    [[nodiscard]] bool getActiveHop (MessageThreadEvent& hop) const;
+
+    /**
+     * @brief Export the hops and stalls as a juce::var suitable for a JSON response.
+     */
+    [[nodiscard]] juce::var toVar() const;
+
+    /**
+     * @brief Export the hops and stalls in the Chrome trace event JSON format.
+     */
+    [[nodiscard]] juce::MemoryBlock toChromeTrace() const;
+
+    JUCE_DECLARE_SINGLETON (MessageThreadTracer, false)
+
+private:
+    MessageThreadTracer();
+
+    class Watchdog;
+
+    void beginHop (const MessageThreadEvent& hop) noexcept;
+    void endHop (const MessageThreadEvent& hop) noexcept;
+    void publishActiveHop() noexcept;
+    void recordStall (const MessageThreadEvent& stall) noexcept;
+
+    EventRing<MessageThreadEvent, 4096> hops;
+    EventRing<MessageThreadEvent, 256> stalls;
+
+    std::vector<MessageThreadEvent> activeHopStack;
+    std::atomic<juce::uint32> activeHopSequence { 0 };
+    MessageThreadEvent activeHop;
+
+    std::atomic<int> stallThreshold { 0 };
+    juce::CriticalSection watchdogLock;
+    std::unique_ptr<Watchdog> watchdog;
+
+    JUCE_DECLARE_NON_COPYABLE (MessageThreadTracer)
+};
+
+} // namespace straw
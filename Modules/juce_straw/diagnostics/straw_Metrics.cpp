@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Metrics.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+thread_local std::shared_ptr<EndpointMetrics> currentEndpointMetrics;
+
+//=================================================================================================
+
+juce::String escapeLabelValue (const juce::String& value)
+{
+    return value
+        .replace ("\\", "\\\\")
+        .replace ("\"", "\\\"")
+        .replace ("\n", "\\n");
+}
+
+juce::String makeEndpointLabel (const EndpointMetrics& metrics)
+{
+    return "endpoint=\"" + escapeLabelValue (metrics.path) + "\"";
+}
+
+void appendHeader (juce::String& output, juce::StringRef name, juce::StringRef type, juce::StringRef help)
+{
+    output << "# HELP " << name << " " << help << "\n"
+           << "# TYPE " << name << " " << type << "\n";
+}
+
+void appendValue (juce::String& output, juce::StringRef name, juce::StringRef labels, juce::uint64 value)
+{
+    output << name;
+
+    if (labels.isNotEmpty())
+        output << "{" << labels << "}";
+
+    output << " " << juce::String (value) << "\n";
+}
+
+} // namespace
+
+//=================================================================================================
+
+void Histogram::record (double seconds) noexcept
+{
+    std::size_t bucket = 0;
+    while (bucket < bucketBounds.size() && seconds > bucketBounds [bucket])
+        ++bucket;
+
+    buckets [bucket].fetch_add (1, std::memory_order_relaxed);
+    sumNanoseconds.fetch_add (static_cast<juce::uint64> (juce::jmax (0.0, seconds) * 1.0e9), std::memory_order_relaxed);
+    count.fetch_add (1, std::memory_order_relaxed);
+}
+
+void Histogram::recordSince (juce::int64 startTicks) noexcept
+{
+    record (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks));
+}
+
+void Histogram::appendPrometheus (juce::String& output, juce::StringRef name, juce::StringRef labels) const
+{
+    const auto prefix = juce::String (name) + "_bucket{" + juce::String (labels) + (labels.isNotEmpty() ? "," : "");
+
+    juce::uint64 cumulativeCount = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+    {
+        cumulativeCount += buckets [bucket].load (std::memory_order_relaxed);
+
+        output << prefix << "le=\"";
+
+        if (bucket < bucketBounds.size())
+            output << juce::String (bucketBounds [bucket]);
+        else
+            output << "+Inf";
+
+        output << "\"} " << juce::String (cumulativeCount) << "\n";
+    }
+
+    const auto sumLabels = labels.isNotEmpty() ? "{" + juce::String (labels) + "}" : juce::String();
+
+    output << name << "_sum" << sumLabels << " "
+           << juce::String (static_cast<double> (sumNanoseconds.load (std::memory_order_relaxed)) / 1.0e9, 9) << "\n";
+
+    output << name << "_count" << sumLabels << " "
+           << juce::String (count.load (std::memory_order_relaxed)) << "\n";
+}
+
+//=================================================================================================
+
+EndpointMetrics::EndpointMetrics (juce::String endpointPath)
+    : path (std::move (endpointPath))
+{
+}
+
+//=================================================================================================
+
+ScopedEndpointMetrics::ScopedEndpointMetrics (std::shared_ptr<EndpointMetrics> metrics)
+    : previousMetrics (std::exchange (currentEndpointMetrics, std::move (metrics)))
+{
+}
+
+ScopedEndpointMetrics::~ScopedEndpointMetrics()
+{
+    currentEndpointMetrics = std::move (previousMetrics);
+}
+
+std::shared_ptr<EndpointMetrics> ScopedEndpointMetrics::getCurrent()
+{
+    return currentEndpointMetrics;
+}
+
+//=================================================================================================
+
+std::shared_ptr<EndpointMetrics> ServerMetrics::getEndpointMetrics (const juce::String& path)
+{
+    auto lock = juce::CriticalSection::ScopedLockType (endpointsLock);
+
+    for (const auto& metrics : endpoints)
+    {
+        if (metrics->path == path)
+            return metrics;
+    }
+
+    return endpoints.emplace_back (std::make_shared<EndpointMetrics> (path));
+}
+
+juce::String ServerMetrics::toPrometheus (int queueDepth, int numPoolThreads) const
+{
+    std::vector<std::shared_ptr<EndpointMetrics>> endpointsToExport;
+
+    {
+        auto lock = juce::CriticalSection::ScopedLockType (endpointsLock);
+        endpointsToExport = endpoints;
+    }
+
+    juce::String output;
+    output.preallocateBytes (static_cast<std::size_t> (endpointsToExport.size()) * 8192);
+
+    appendHeader (output, "straw_connections_total", "counter", "Connections accepted by the server.");
+    appendValue (output, "straw_connections_total", {}, numConnections.load (std::memory_order_relaxed));
+
+    appendHeader (output, "straw_connections_rejected_total", "counter", "Connections rejected before reaching an endpoint.");
+    appendValue (output, "straw_connections_rejected_total", {}, numRejectedConnections.load (std::memory_order_relaxed));
+
+    appendHeader (output, "straw_received_bytes_total", "counter", "Bytes read from all connections.");
+    appendValue (output, "straw_received_bytes_total", {}, bytesIn.load (std::memory_order_relaxed));
+
+    appendHeader (output, "straw_pool_queue_depth", "gauge", "Jobs queued or running in the connection pool.");
+    appendValue (output, "straw_pool_queue_depth", {}, static_cast<juce::uint64> (juce::jmax (0, queueDepth)));
+
+    appendHeader (output, "straw_pool_threads", "gauge", "Threads in the connection pool.");
+    appendValue (output, "straw_pool_threads", {}, static_cast<juce::uint64> (juce::jmax (0, numPoolThreads)));
+
+    appendHeader (output, "straw_read_seconds", "histogram", "Time spent reading requests from the socket.");
+    readTime.appendPrometheus (output, "straw_read_seconds", {});
+
+    appendHeader (output, "straw_parse_seconds", "histogram", "Time spent parsing http requests and their payloads.");
+    parseTime.appendPrometheus (output, "straw_parse_seconds", {});
+
+    struct HistogramFamily
+    {
+        const char* name;
+        const char* help;
+        Histogram EndpointMetrics::* histogram;
+    };
+
+    static const HistogramFamily histogramFamilies[]
+    {
+        { "straw_endpoint_queue_wait_seconds", "Time spent waiting in the connection pool queue.", &EndpointMetrics::queueWait },
+        { "straw_endpoint_callback_seconds", "Time spent in the endpoint callback on the pool thread.", &EndpointMetrics::callbackTime },
+        { "straw_endpoint_message_thread_wait_seconds", "Time spent waiting for the message thread.", &EndpointMetrics::messageThreadWait },
+        { "straw_endpoint_message_thread_seconds", "Time spent in handlers on the message thread.", &EndpointMetrics::messageThreadTime },
+        { "straw_endpoint_serialization_seconds", "Time spent encoding responses.", &EndpointMetrics::serializationTime },
+        { "straw_endpoint_write_seconds", "Time spent writing responses to the socket.", &EndpointMetrics::writeTime }
+    };
+
+    for (const auto& family : histogramFamilies)
+    {
+        appendHeader (output, family.name, "histogram", family.help);
+
+        for (const auto& metrics : endpointsToExport)
+            ((*metrics).*(family.histogram)).appendPrometheus (output, family.name, makeEndpointLabel (*metrics));
+    }
+
+    struct CounterFamily
+    {
+        const char* name;
+        const char* help;
+        std::atomic<juce::uint64> EndpointMetrics::* counter;
+    };
+
+    static const CounterFamily counterFamilies[]
+    {
+        { "straw_endpoint_requests_total", "Requests dispatched to the endpoint.", &EndpointMetrics::numRequests },
+        { "straw_endpoint_errors_total", "Error responses sent by the endpoint.", &EndpointMetrics::numErrors },
+        { "straw_endpoint_received_bytes_total", "Request bytes received by the endpoint.", &EndpointMetrics::bytesIn },
+        { "straw_endpoint_sent_bytes_total", "Response bytes sent by the endpoint.", &EndpointMetrics::bytesOut }
+    };
+
+    for (const auto& family : counterFamilies)
+    {
+        appendHeader (output, family.name, "counter", family.help);
+
+        for (const auto& metrics : endpointsToExport)
+            appendValue (output, family.name, makeEndpointLabel (*metrics), ((*metrics).*(family.counter)).load (std::memory_order_relaxed));
+    }
+
+    return output;
+}
+
+} // namespace straw
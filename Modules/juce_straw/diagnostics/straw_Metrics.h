@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A lock-free latency histogram with fixed buckets.
+ *
+ * Samples are recorded with relaxed atomic increments, so recording is safe and cheap from any thread. Buckets follow the
+ * Prometheus convention of cumulative upper bounds expressed in seconds.
+ */
+class Histogram
+{
+public:
+    /**
+     * @brief Constructor for the Histogram class.
+     */
+    Histogram() = default;
+
+    /**
+     * @brief Record a sample.
+     *
+     * @param seconds The sample value in seconds.
+     */
+    void record (double seconds) noexcept;
+
+    /**
+     * @brief Record the time elapsed since a high resolution ticks value.
+     *
+     * @param startTicks The value of `juce::Time::getHighResolutionTicks()` at the start of the measured interval.
+     */
+    void recordSince (juce::int64 startTicks) noexcept;
+
+    /**
+     * @brief Append the histogram series in the Prometheus text format.
+     *
+     * @param output The string to append to.
+     * @param name The name of the metric family.
+     * @param labels The labels of the series, without braces (for example `endpoint="/straw/sleep"`).
+     */
+    void appendPrometheus (juce::String& output, juce::StringRef name, juce::StringRef labels) const;
+
+    static constexpr std::array<double, 16> bucketBounds
+    {
+        0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+        0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0
+    };
+
+private:
+    std::array<std::atomic<juce::uint64>, bucketBounds.size() + 1> buckets {};
+    std::atomic<juce::uint64> sumNanoseconds { 0 };
+    std::atomic<juce::uint64> count { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (Histogram)
+};
+
+//=================================================================================================
+
+/**
+ * @brief The metrics collected for a single endpoint.
+ */
+struct EndpointMetrics
+{
+    explicit EndpointMetrics (juce::String endpointPath);
+
+    const juce::String path;
+
+    Histogram queueWait;           // from the connection being queued in the pool to the endpoint callback starting
+    Histogram callbackTime;        // time spent in the endpoint callback on the pool thread
+    Histogram messageThreadWait;   // from posting to the message thread to the handler starting
+    Histogram messageThreadTime;   // time spent in the handler on the message thread
+    Histogram serializationTime;   // time spent encoding the response payload
+    Histogram writeTime;           // time spent writing the response to the socket
+
+    std::atomic<juce::uint64> numRequests { 0 };
+    std::atomic<juce::uint64> numErrors { 0 };
+    std::atomic<juce::uint64> bytesIn { 0 };
+    std::atomic<juce::uint64> bytesOut { 0 };
+};
+
+//=================================================================================================
+
+/**
+ * @brief Makes an endpoint the current one for the calling thread.
+ *
+ * Responses sent while an instance is alive are accounted to the endpoint metrics. `callOnMessageThread` propagates the
+ * current endpoint to the message thread, asynchronous completions can capture it with `getCurrent`.
+ */
+class ScopedEndpointMetrics
+{
+public:
+    explicit ScopedEndpointMetrics (std::shared_ptr<EndpointMetrics> metrics);
+    ~ScopedEndpointMetrics();
+
+    /**
+     * @brief Get the endpoint metrics current for the calling thread, if any.
+     */
+    [[nodiscard]] static std::shared_ptr<EndpointMetrics> getCurrent();
+
+private:
+    std::shared_ptr<EndpointMetrics> previousMetrics;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedEndpointMetrics)
+};
+
+//=================================================================================================
+
+/**
+ * @brief The metrics collected by an automation server.
+ */
+class ServerMetrics
+{
+public:
+    /**
+     * @brief Constructor for the ServerMetrics class.
+     */
+    ServerMetrics() = default;
+
+    /**
+     * @brief Get the metrics of an endpoint, creating them if needed.
+     *
+     * This takes a lock and is meant to be called when registering endpoints, not on the request path.
+     *
+     * @param path The path of the endpoint.
+     */
+    [[nodiscard]] std::shared_ptr<EndpointMetrics> getEndpointMetrics (const juce::String& path);
+
+    /**
+     * @brief Export all the metrics in the Prometheus text exposition format.
+     *
+     * @param queueDepth The current number of jobs in the connection pool.
+     * @param numPoolThreads The number of threads in the connection pool.
+     *
+     * @return The metrics as text.
+     */
+    [[nodiscard]] juce::String toPrometheus (int queueDepth, int numPoolThreads) const;
+
+    Histogram readTime;            // time spent reading the raw request from the socket
+    Histogram parseTime;           // time spent parsing the http request and its payload
+
+    std::atomic<juce::uint64> numConnections { 0 };
+    std::atomic<juce::uint64> numRejectedConnections { 0 };
+    std::atomic<juce::uint64> bytesIn { 0 };
+
+private:
+    juce::CriticalSection endpointsLock;
+    std::vector<std::shared_ptr<EndpointMetrics>> endpoints;
+
+    JUCE_DECLARE_NON_COPYABLE (ServerMetrics)
+};
+
+} // namespace straw
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <utility>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief An unbounded lock-free queue with any number of producers and a single consumer.
+ *
+ * This is Dmitry Vyukov's intrusive MPSC queue: pushing is a single atomic exchange and never blocks, popping never blocks
+ * either, but can transiently report the queue as empty while a producer is in the middle of a push. Each pushed item
+ * allocates a node.
+ */
+template <class T>
+class MpscQueue
+{
+public:
+    /**
+     * @brief Constructor for the MpscQueue class.
+     */
+    MpscQueue()
+    {
+        head.store (&stub, std::memory_order_relaxed);
+        tail = &stub;
+    }
+
+    /**
+     * @brief Destructor for the MpscQueue class, discards the items left in the queue.
+     */
+    ~MpscQueue()
+    {
+        T item;
+        while (pop (item))
+            ;
+    }
+
+    /**
+     * @brief Push an item. Can be called from any thread.
+     *
+     * @param item The item to push.
+     */
+    void push (T item)
+    {
+        pushNode (new Node (std::move (item)));
+    }
+
+    /**
+     * @brief Pop the oldest item, must only be called from the consumer thread.
+     *
+     * @param item The popped item.
+     *
+     * @return True if an item was popped.
+     */
+    bool pop (T& item)
+    {
+        auto currentTail = tail;
+        auto next = currentTail->next.load (std::memory_order_acquire);
+
+        // Skip the stub node, which only keeps the queue non empty
+        if (currentTail == &stub)
+        {
+            if (next == nullptr)
+                return false;
+
+            tail = next;
+            currentTail = next;
+            next = next->next.load (std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            tail = next;
+            item = std::move (currentTail->item);
+            delete currentTail;
+            return true;
+        }
+
+        // A producer exchanged the head but didn't link its node yet
+        if (currentTail != head.load (std::memory_order_acquire))
+            return false;
+
+        // The tail is the last node, push the stub behind it so the tail can be released
+        pushNode (&stub);
+
+        next = currentTail->next.load (std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            tail = next;
+            item = std::move (currentTail->item);
+            delete currentTail;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+
+        explicit Node (T&& value)
+            : item (std::move (value))
+        {
+        }
+
+        T item {};
+        std::atomic<Node*> next { nullptr };
+    };
+
+    void pushNode (Node* node)
+    {
+        node->next.store (nullptr, std::memory_order_relaxed);
+
+        auto previous = head.exchange (node, std::memory_order_acq_rel);
+        previous->next.store (node, std::memory_order_release);
+    }
+
+    alignas (64) std::atomic<Node*> head { nullptr };
+    alignas (64) Node* tail = nullptr;
+    Node stub;
+
+    JUCE_DECLARE_NON_COPYABLE (MpscQueue)
+};
+
+} // namespace straw
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_PaintProfiler.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+double paintTicksToMilliseconds (juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1000.0;
+}
+
+PaintProfile makePaintProfile (const juce::Component& component)
+{
+    PaintProfile profile;
+    profile.componentID = component.getComponentID();
+    profile.name = component.getName();
+    profile.type = popsicle::Helpers::demangleClassName (typeid (component).name());
+    return profile;
+}
+
+juce::int64 paintProfiledComponent (juce::Component& component, juce::Graphics& g, PaintProfile& profile, bool isMeasured)
+{
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    juce::int64 childrenTicks = 0;
+
+    {
+        juce::Graphics::ScopedSaveState state (g);
+        component.paint (g);
+    }
+
+    // Mirrors what Component::paintComponentAndChildren does with the clipping, the unclipped painting and the alpha of the
+    // children. Not mirrored: cached images and effects are bypassed, and a component also paints where its opaque children
+    // hide it, as only the children are clipped out by their opaque siblings
+    const auto& children = component.getChildren();
+    std::size_t childIndex = 0;
+
+    for (int index = 0; index < children.size(); ++index)
+    {
+        auto child = children.getUnchecked (index);
+        if (! child->isVisible())
+            continue;
+
+        if (childIndex == profile.children.size())
+            profile.children.push_back (makePaintProfile (*child));
+
+        auto& childProfile = profile.children [childIndex++];
+
+        juce::Graphics::ScopedSaveState state (g);
+
+        if (child->isTransformed())
+            g.addTransform (child->getTransform());
+
+        if (! child->isPaintingUnclipped())
+        {
+            if (! g.reduceClipRegion (child->getBounds()))
+                continue;
+
+            if (! child->isTransformed())
+            {
+                for (int siblingIndex = index + 1; siblingIndex < children.size(); ++siblingIndex)
+                {
+                    auto sibling = children.getUnchecked (siblingIndex);
+
+                    if (sibling->isOpaque() && sibling->isVisible() && ! sibling->isTransformed())
+                        g.excludeClipRegion (sibling->getBounds());
+                }
+
+                if (g.isClipEmpty())
+                    continue;
+            }
+        }
+
+        g.setOrigin (child->getPosition());
+
+        const auto alpha = child->getAlpha();
+        if (alpha < 1.0f)
+            g.beginTransparencyLayer (alpha);
+
+        childrenTicks += paintProfiledComponent (*child, g, childProfile, isMeasured);
+
+        if (alpha < 1.0f)
+            g.endTransparencyLayer();
+    }
+
+    {
+        juce::Graphics::ScopedSaveState state (g);
+        component.paintOverChildren (g);
+    }
+
+    const auto totalTicks = juce::Time::getHighResolutionTicks() - startTicks;
+
+    if (isMeasured)
+    {
+        const auto totalMilliseconds = paintTicksToMilliseconds (totalTicks);
+
+        profile.minTotalMilliseconds = profile.numPaints == 0
+            ? totalMilliseconds
+            : juce::jmin (profile.minTotalMilliseconds, totalMilliseconds);
+        profile.maxTotalMilliseconds = juce::jmax (profile.maxTotalMilliseconds, totalMilliseconds);
+        profile.selfMilliseconds += paintTicksToMilliseconds (totalTicks - childrenTicks);
+        profile.totalMilliseconds += totalMilliseconds;
+        ++profile.numPaints;
+    }
+
+    return totalTicks;
+}
+
+void averagePaintProfile (PaintProfile& profile)
+{
+    if (profile.numPaints > 0)
+    {
+        profile.selfMilliseconds /= profile.numPaints;
+        profile.totalMilliseconds /= profile.numPaints;
+    }
+
+    for (auto& childProfile : profile.children)
+        averagePaintProfile (childProfile);
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::var PaintProfile::toVar() const
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("id", componentID);
+    object->setProperty ("name", name);
+    object->setProperty ("type", type);
+    object->setProperty ("num_paints", numPaints);
+    object->setProperty ("self_ms", selfMilliseconds);
+    object->setProperty ("total_ms", totalMilliseconds);
+    object->setProperty ("min_total_ms", minTotalMilliseconds);
+    object->setProperty ("max_total_ms", maxTotalMilliseconds);
+
+    juce::Array<juce::var> childrenArray;
+    for (const auto& child : children)
+        childrenArray.add (child.toVar());
+    object->setProperty ("children", std::move (childrenArray));
+
+    return object.get();
+}
+
+//=================================================================================================
+
+PaintProfile PaintProfiler::profile (juce::Component& component, int numIterations)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    ScopedTraceSpan span ("diagnostics", "PaintProfiler::profile");
+
+    auto result = makePaintProfile (component);
+
+    if (component.getWidth() <= 0 || component.getHeight() <= 0)
+        return result;
+
+    auto image = juce::Image (juce::Image::ARGB, component.getWidth(), component.getHeight(), true);
+
+    for (int iteration = 0; iteration <= juce::jlimit (0, maxIterations, numIterations); ++iteration)
+    {
+        image.clear (image.getBounds());
+
+        juce::Graphics g (image);
+        paintProfiledComponent (component, g, result, iteration > 0);
+    }
+
+    averagePaintProfile (result);
+
+    return result;
+}
+
+} // namespace straw
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The paint timings of a component and its children, aggregated over the profiled iterations.
+ *
+ * The self time covers `paint` and `paintOverChildren` of the component, the total time adds the total time of the children.
+ * Timings are averaged over the iterations the component was painted in, children clipped out of the parent are not painted.
+ */
+struct PaintProfile
+{
+    juce::String componentID;
+    juce::String name;
+    juce::String type;
+
+    int numPaints = 0;
+    double selfMilliseconds = 0.0;
+    double totalMilliseconds = 0.0;
+    double minTotalMilliseconds = 0.0;
+    double maxTotalMilliseconds = 0.0;
+
+    std::vector<PaintProfile> children;
+
+    /**
+     * @brief Convert the profile to a var, recursively.
+     */
+    [[nodiscard]] juce::var toVar() const;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Profiles the paint time of each component in a hierarchy.
+ *
+ * The hierarchy is painted to an image like `renderComponentToImage` does with children, but the components are painted one
+ * by one, so each `paint` and `paintOverChildren` is timed. Cached component images and component effects are bypassed, so
+ * the actual cost of painting is measured even for components buffered to an image.
+ */
+class PaintProfiler
+{
+public:
+    /**
+     * @brief The maximum number of iterations to profile, the hierarchy is painted synchronously on the message thread.
+     */
+    static constexpr int maxIterations = 1000;
+
+    /**
+     * @brief Profile the paint of a component and its children.
+     *
+     * An additional warm up paint, which isn't measured, precedes the profiled iterations. Must be called from the message thread.
+     *
+     * @param component The component to profile.
+     * @param numIterations The number of times to paint the hierarchy, up to `maxIterations`.
+     *
+     * @return The aggregated timings of the component.
+     */
+    [[nodiscard]] static PaintProfile profile (juce::Component& component, int numIterations = 10);
+};
+
+} // namespace straw
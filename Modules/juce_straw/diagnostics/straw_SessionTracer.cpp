@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_SessionTracer.h"
+#include "straw_ChromeTraceWriter.h"
+
+#include <juce_events/juce_events.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace straw {
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (SessionTracer)
+
+SessionTracer::~SessionTracer()
+{
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void SessionTracer::start()
+{
+    sessionEndTicks.store (0);
+    sessionStartTicks.store (juce::Time::getHighResolutionTicks());
+    enabled.store (true);
+}
+
+void SessionTracer::stop()
+{
+    if (enabled.exchange (false))
+        sessionEndTicks.store (juce::Time::getHighResolutionTicks());
+}
+
+//=================================================================================================
+
+void SessionTracer::addSpan (const char* category, juce::StringRef name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+{
+    if (! isEnabled())
+        return;
+
+    TraceSpan span;
+    span.category = category;
+    span.startTicks = startTicks;
+    span.endTicks = endTicks;
+
+    // Truncate on a code point boundary, so the name is still valid UTF-8
+    const auto* text = name.text.getAddress();
+    auto length = std::min (std::strlen (text), TraceSpan::maxNameLength);
+    while (length > 0 && (static_cast<juce::uint8> (text [length]) & 0xc0) == 0x80)
+        --length;
+
+    std::memcpy (span.name.data(), text, length);
+
+    getThreadBuffer().spans.push (span);
+}
+
+SessionTracer::ThreadBuffer& SessionTracer::getThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> currentBuffer;
+
+    if (currentBuffer == nullptr)
+    {
+        currentBuffer = std::make_shared<ThreadBuffer>();
+
+        if (auto thread = juce::Thread::getCurrentThread())
+            currentBuffer->threadName = thread->getThreadName();
+        else if (juce::MessageManager::existsAndIsCurrentThread())
+            currentBuffer->threadName = "Message Thread";
+        else
+            currentBuffer->threadName = "Thread";
+
+        auto lock = juce::CriticalSection::ScopedLockType (buffersLock);
+
+        currentBuffer->threadId = static_cast<juce::int64> (buffers.size()) + 1;
+        buffers.push_back (currentBuffer);
+    }
+
+    return *currentBuffer;
+}
+
+//=================================================================================================
+
+juce::MemoryBlock SessionTracer::toChromeTrace() const
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+
+    {
+        auto lock = juce::CriticalSection::ScopedLockType (buffersLock);
+        threadBuffers = buffers;
+    }
+
+    const auto startTicks = sessionStartTicks.load();
+    const auto endTicks = sessionEndTicks.load();
+
+    auto isInSession = [startTicks, endTicks] (const TraceSpan& span)
+    {
+        return span.startTicks >= startTicks && (endTicks == 0 || span.startTicks <= endTicks);
+    };
+
+    ChromeTraceWriter writer;
+
+    for (const auto& buffer : threadBuffers)
+    {
+        auto spans = buffer->spans.snapshot();
+        if (std::none_of (spans.begin(), spans.end(), isInSession))
+            continue;
+
+        writer.addThreadName (buffer->threadId, buffer->threadName);
+
+        for (const auto& span : spans)
+        {
+            if (! isInSession (span))
+                continue;
+
+            auto name = juce::String::fromUTF8 (span.name.data());
+
+            if (span.endTicks == 0)
+                writer.addInstantEvent (name, span.category, buffer->threadId, span.startTicks);
+            else
+                writer.addCompleteEvent (name, span.category, buffer->threadId, span.startTicks, span.endTicks);
+        }
+    }
+
+    return writer.finish();
+}
+
+//=================================================================================================
+
+ScopedTraceSpan::ScopedTraceSpan (const char* spanCategory, juce::StringRef spanName) noexcept
+    : category (spanCategory)
+    , name (spanName)
+{
+    if (SessionTracer::getInstance()->isEnabled())
+        startTicks = juce::Time::getHighResolutionTicks();
+}
+
+ScopedTraceSpan::~ScopedTraceSpan()
+{
+    if (startTicks != 0)
+        SessionTracer::getInstance()->addSpan (category, name, startTicks, juce::Time::getHighResolutionTicks());
+}
+
+} // namespace straw
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "straw_EventRing.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A span recorded by the session tracer, an instant event when the end ticks are zero.
+ */
+struct TraceSpan
+{
+    static constexpr std::size_t maxNameLength = 63;
+
+    std::array<char, maxNameLength + 1> name {};
+    const char* category = "";
+    juce::int64 startTicks = 0;
+    juce::int64 endTicks = 0;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Opt-in tracer of whole automation sessions, exported in the Chrome trace event format.
+ *
+ * When enabled, spans are recorded across the server, pool and message threads into per thread lock-free ring buffers,
+ * each one written only by its owning thread. When disabled, recording a span costs a single relaxed atomic load.
+ *
+ * The trace of the last session can be dumped at any time and loaded in `chrome://tracing` or in the Perfetto UI.
+ */
+class SessionTracer : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Destructor for the SessionTracer class.
+     */
+    ~SessionTracer() override;
+
+    /**
+     * @brief Start a new tracing session, discarding the spans of the previous one.
+     */
+    void start();
+
+    /**
+     * @brief Stop the current tracing session, the recorded spans are kept until the next session starts.
+     */
+    void stop();
+
+    /**
+     * @brief Check if a tracing session is running.
+     */
+    [[nodiscard]] bool isEnabled() const noexcept
+    {
+        return enabled.load (std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record a span on the calling thread.
+     *
+     * @param category The category of the span, must be a string literal.
+     * @param name The name of the span, truncated to the maximum name length.
+     * @param startTicks The start of the span in high resolution ticks.
+     * @param endTicks The end of the span in high resolution ticks, zero to record an instant event.
+     */
+    void addSpan (const char* category, juce::StringRef name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+    /**
+     * @brief Export the spans of the current or last session in the Chrome trace event JSON format.
+     */
+    [[nodiscard]] juce::MemoryBlock toChromeTrace() const;
+
+    JUCE_DECLARE_SINGLETON (SessionTracer, false)
+
+private:
+    SessionTracer() = default;
+
+    struct ThreadBuffer
+    {
+        juce::int64 threadId = 0;
+        juce::String threadName;
+        EventRing<TraceSpan, 8192> spans;
+    };
+
+    ThreadBuffer& getThreadBuffer();
+
+    std::atomic<bool> enabled { false };
+    std::atomic<juce::int64> sessionStartTicks { 0 };
+    std::atomic<juce::int64> sessionEndTicks { 0 };
+
+    juce::CriticalSection buffersLock;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    JUCE_DECLARE_NON_COPYABLE (SessionTracer)
+};
+
+//=================================================================================================
+
+/**
+ * @brief Record a span on the calling thread covering the lifetime of this object, if a tracing session is running.
+ */
+class ScopedTraceSpan
+{
+public:
+    /**
+     * @brief Constructor for the ScopedTraceSpan class.
+     *
+     * @param spanCategory The category of the span, must be a string literal.
+     * @param spanName The name of the span, must outlive this object.
+     */
+    ScopedTraceSpan (const char* spanCategory, juce::StringRef spanName) noexcept;
+
+    /**
+     * @brief Destructor for the ScopedTraceSpan class.
+     */
+    ~ScopedTraceSpan();
+
+private:
+    const char* category;
+    juce::StringRef name;
+    juce::int64 startTicks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedTraceSpan)
+};
+
+} // namespace straw
@@ -21,10 +21,33 @@
 
 #include "straw_ComponentEndpoints.h"
 
+#include "../diagnostics/straw_AsyncLogger.h"
+#include "../diagnostics/straw_FrameMonitor.h"
+#include "../diagnostics/straw_MemoryTracker.h"
+#include "../diagnostics/straw_MessageThreadTracer.h"
+#include "../diagnostics/straw_PaintProfiler.h"
+#include "../diagnostics/straw_SessionTracer.h"
+#include "../helpers/straw_AccessibilityCache.h"
 #include "../helpers/straw_ComponentHelpers.h"
+#include "../helpers/straw_ComponentSpatialIndex.h"
+#include "../helpers/straw_ComponentTextIndex.h"
+#include "../input/straw_Gesture.h"
+#include "../input/straw_InputRecorder.h"
+#include "../state/straw_StateSnapshots.h"
+#include "../time/straw_VirtualClock.h"
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_events/juce_events.h>
+#include <juce_python/juce_python.h>
+
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+#include "../audio/straw_AudioAnalysis.h"
+#include "../audio/straw_AudioTap.h"
+#endif
+
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+#include "../audio/straw_OfflineRenderer.h"
+#endif
 
 namespace straw::Endpoints {
 
@@ -35,12 +58,76 @@ void sleep (Request request)
     auto sleepTime = static_cast<int> (request.data.getProperty ("time", 100));
     auto messageThread = static_cast<bool> (request.data.getProperty ("messageThread", false));
 
-    auto sleeperFunction = [sleepTime] { juce::Thread::sleep(sleepTime); };
+    // In virtual time mode sleeping fast forwards the clock instead, which needs the message thread
+    if (messageThread || VirtualClock::getInstance()->isVirtual())
+    {
+        callOnMessageThread ([sleepTime, connection = std::move (request.connection)]
+        {
+            auto& clock = *VirtualClock::getInstance();
 
-    if (messageThread)
-        juce::MessageManager::callAsync (sleeperFunction);
+            if (clock.isVirtual())
+                clock.advance (sleepTime);
+            else
+                juce::Thread::sleep (sleepTime);
+
+            sendHttpResultResponse (true, 200, *connection);
+        });
+    }
     else
-        sleeperFunction();
+    {
+        juce::Thread::sleep (sleepTime);
+
+        sendHttpResultResponse (true, 200, *request.connection);
+    }
+}
+
+//=================================================================================================
+
+void timeAdvance (Request request)
+{
+    auto advanceTime = static_cast<double> (request.data.getProperty ("time", 0.0));
+    if (advanceTime < 0.0)
+    {
+        sendHttpErrorResponse ("invalid time specified", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([advanceTime, connection = std::move (request.connection)]
+    {
+        auto& clock = *VirtualClock::getInstance();
+        clock.advance (advanceTime);
+
+        sendHttpResultResponse (clock.toVar(), 200, *connection);
+    });
+}
+
+void timeWarp (Request request)
+{
+    auto factor = static_cast<double> (request.data.getProperty ("factor", 1.0));
+    if (factor < 0.0)
+    {
+        sendHttpErrorResponse ("invalid warp factor specified", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([factor, connection = std::move (request.connection)]
+    {
+        auto& clock = *VirtualClock::getInstance();
+        clock.setWarpFactor (factor);
+
+        sendHttpResultResponse (clock.toVar(), 200, *connection);
+    });
+}
+
+void timeReal (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        auto& clock = *VirtualClock::getInstance();
+        clock.setVirtual (false);
+
+        sendHttpResultResponse (clock.toVar(), 200, *connection);
+    });
 }
 
 //=================================================================================================
@@ -54,7 +141,7 @@ void componentExists (Request request)
         return;
     }
 
-    juce::MessageManager::callAsync ([componentID, connection = std::move (request.connection)]
+    callOnMessageThread ([componentID, connection = std::move (request.connection)]
     {
         juce::Component* foundComponent = Helpers::findComponentById (componentID);
 
@@ -73,16 +160,152 @@ void componentVisible (Request request)
         return;
     }
 
-    juce::MessageManager::callAsync ([componentID, connection = std::move (request.connection)]
+    auto checkOcclusion = static_cast<bool> (request.data.getProperty ("occlusion", false));
+
+    callOnMessageThread ([componentID, checkOcclusion, connection = std::move (request.connection)]
     {
         juce::Component* foundComponent = Helpers::findComponentById (componentID);
 
+        if (foundComponent != nullptr && checkOcclusion)
+        {
+            sendHttpResultResponse (ComponentSpatialIndex::getInstance()->isVisibleAndUnoccluded (*foundComponent), 200, *connection);
+            return;
+        }
+
         sendHttpResultResponse (foundComponent != nullptr && foundComponent->isVisible(), 200, *connection);
     });
 }
 
 //=================================================================================================
 
+void componentAt (Request request)
+{
+    if (! request.data.hasProperty ("x") || ! request.data.hasProperty ("y"))
+    {
+        sendHttpErrorResponse ("invalid position specified", 500, *request.connection);
+        return;
+    }
+
+    auto screenPosition = juce::Point<int> (static_cast<int> (request.data.getProperty ("x", 0)),
+                                            static_cast<int> (request.data.getProperty ("y", 0)));
+    auto all = static_cast<bool> (request.data.getProperty ("all", false));
+
+    callOnMessageThread ([screenPosition, all, connection = std::move (request.connection)]
+    {
+        auto spatialIndex = ComponentSpatialIndex::getInstance();
+
+        if (all)
+        {
+            juce::Array<juce::var> components;
+            for (auto component : spatialIndex->findComponentsAt (screenPosition))
+                components.add (Helpers::makeComponentInfo (component));
+
+            sendHttpResultResponse (components, 200, *connection);
+            return;
+        }
+
+        auto component = spatialIndex->findComponentAt (screenPosition);
+        sendHttpResultResponse (component != nullptr ? Helpers::makeComponentInfo (component) : juce::var(), 200, *connection);
+    });
+}
+
+//=================================================================================================
+
+void componentFind (Request request)
+{
+    auto text = request.data.getProperty ("text", "").toString();
+    if (text.trim().isEmpty())
+    {
+        sendHttpErrorResponse ("invalid text specified", 500, *request.connection);
+        return;
+    }
+
+    auto mode = ComponentTextIndex::matchModeFromString (request.data.getProperty ("mode", "exact").toString());
+    if (! mode.has_value())
+    {
+        sendHttpErrorResponse ("invalid match mode specified", 500, *request.connection);
+        return;
+    }
+
+    auto limit = static_cast<int> (request.data.getProperty ("limit", 100));
+
+    callOnMessageThread ([text, mode, limit, connection = std::move (request.connection)]
+    {
+        juce::Array<juce::var> components;
+
+        for (const auto& match : ComponentTextIndex::getInstance()->findComponentsByText (text, *mode, limit))
+        {
+            auto componentInfo = Helpers::makeComponentInfo (match.component);
+
+            if (auto object = componentInfo.getDynamicObject())
+            {
+                object->setProperty ("text", match.text);
+                object->setProperty ("score", match.score);
+            }
+
+            components.add (componentInfo);
+        }
+
+        sendHttpResultResponse (components, 200, *connection);
+    });
+}
+
+//=================================================================================================
+
+void accessibilityFind (Request request)
+{
+    AccessibilityCache::Query query;
+
+    if (auto role = request.data.getProperty ("role", "").toString(); role.isNotEmpty())
+    {
+        query.role = AccessibilityCache::roleFromString (role);
+        if (! query.role.has_value())
+        {
+            sendHttpErrorResponse ("invalid accessibility role specified", 500, *request.connection);
+            return;
+        }
+    }
+
+    query.title = request.data.getProperty ("title", "").toString();
+    query.value = request.data.getProperty ("value", "").toString();
+
+    auto limit = static_cast<int> (request.data.getProperty ("limit", 100));
+
+    callOnMessageThread ([query, limit, connection = std::move (request.connection)]
+    {
+        juce::Array<juce::var> components;
+
+        for (auto component : AccessibilityCache::getInstance()->findComponents (query, limit))
+        {
+            auto componentInfo = Helpers::makeComponentInfo (component);
+
+            if (auto object = componentInfo.getDynamicObject())
+            {
+                if (auto handler = component->getAccessibilityHandler())
+                {
+                    object->setProperty ("role", AccessibilityCache::roleToString (handler->getRole()));
+                    object->setProperty ("title", handler->getTitle());
+                    object->setProperty ("value", AccessibilityCache::getAccessibleValue (*handler));
+                }
+            }
+
+            components.add (componentInfo);
+        }
+
+        sendHttpResultResponse (components, 200, *connection);
+    });
+}
+
+void accessibilitySnapshot (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        sendHttpResultResponse (AccessibilityCache::getInstance()->getSnapshot(), 200, *connection);
+    });
+}
+
+//=================================================================================================
+
 void componentInfo (Request request)
 {
     auto componentID = request.data.getProperty ("id", "").toString().trim();
@@ -94,7 +317,7 @@ void componentInfo (Request request)
 
     auto recursive = static_cast<bool> (request.data.getProperty ("recursive", false));
 
-    juce::MessageManager::callAsync ([componentID, recursive, connection = std::move (request.connection)]
+    callOnMessageThread ([componentID, recursive, connection = std::move (request.connection)]
     {
         juce::Component* foundComponent = Helpers::findComponentById (componentID);
 
@@ -115,13 +338,30 @@ void componentClick (Request request)
     }
 
     auto clickTime = static_cast<int> (request.data.getProperty ("time", 100));
+    auto force = static_cast<bool> (request.data.getProperty ("force", false));
 
-    juce::MessageManager::callAsync([componentID, clickTime, request = std::move (request)]
+    callOnMessageThread ([componentID, clickTime, force, request = std::move (request)]
     {
         if (juce::Component* component = Helpers::findComponentById (componentID))
         {
-            Helpers::clickComponent (component, juce::ModifierKeys(), [request = std::move (request)]
+            // Clicks are injected into the component, check that a real click would reach it
+            if (! force)
+            {
+                if (auto occludingComponent = ComponentSpatialIndex::getInstance()->findOccludingComponent (*component))
+                {
+                    auto occludingName = occludingComponent->getComponentID().isNotEmpty()
+                        ? occludingComponent->getComponentID()
+                        : popsicle::Helpers::demangleClassName (typeid (*occludingComponent).name());
+
+                    sendHttpErrorResponse ("component is covered by " + occludingName, 500, *request.connection);
+                    return;
+                }
+            }
+
+            Helpers::clickComponent (component, juce::ModifierKeys(), [request = std::move (request), endpointMetrics = ScopedEndpointMetrics::getCurrent()]
             {
+                ScopedEndpointMetrics scope (endpointMetrics);
+
                 sendHttpResultResponse (true, 200, *request.connection);
             }, juce::RelativeTime::milliseconds(clickTime));
         }
@@ -145,7 +385,7 @@ void componentRender (Request request)
 
     auto withChildren = static_cast<bool> (request.data.getProperty ("withChildren", false));
 
-    juce::MessageManager::callAsync([componentID, withChildren, request = std::move (request)]
+    callOnMessageThread ([componentID, withChildren, request = std::move (request)]
     {
         if (juce::Component* component = Helpers::findComponentById (componentID))
         {
@@ -159,4 +399,569 @@ void componentRender (Request request)
     });
 }
 
+//=================================================================================================
+
+void profilePaint (Request request)
+{
+    auto componentID = request.data.getProperty ("id", "").toString().trim();
+    if (componentID.isEmpty())
+    {
+        sendHttpErrorResponse ("invalid component id specified", 500, *request.connection);
+        return;
+    }
+
+    auto numIterations = static_cast<int> (request.data.getProperty ("iterations", 10));
+    if (numIterations <= 0 || numIterations > PaintProfiler::maxIterations)
+    {
+        sendHttpErrorResponse ("invalid number of iterations specified", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([componentID, numIterations, connection = std::move (request.connection)]
+    {
+        if (juce::Component* component = Helpers::findComponentById (componentID))
+        {
+            auto profile = PaintProfiler::profile (*component, numIterations);
+            sendHttpResultResponse (profile.toVar(), 200, *connection);
+        }
+        else
+        {
+            sendHttpErrorResponse ("component id not found", 500, *connection);
+        }
+    });
+}
+
+//=================================================================================================
+
+void framesStart (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        FrameMonitor::getInstance()->start();
+
+        sendHttpResultResponse (true, 200, *connection);
+    });
+}
+
+void framesStop (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        auto frameMonitor = FrameMonitor::getInstance();
+        frameMonitor->stop();
+
+        sendHttpResultResponse (frameMonitor->getStatistics(), 200, *connection);
+    });
+}
+
+void framesStats (Request request)
+{
+    auto maxComponents = static_cast<int> (request.data.getProperty ("top", 10));
+
+    callOnMessageThread ([maxComponents, connection = std::move (request.connection)]
+    {
+        sendHttpResultResponse (FrameMonitor::getInstance()->getStatistics (maxComponents), 200, *connection);
+    });
+}
+
+//=================================================================================================
+
+void gesturePlay (Request request)
+{
+    Gesture gesture;
+
+    auto result = Gesture::fromVar (request.data, gesture);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([gesture = std::move (gesture), connection = std::move (request.connection)]() mutable
+    {
+        auto numEvents = static_cast<int> (gesture.events.size());
+
+        GesturePlayer::play (std::move (gesture), [numEvents, connection, endpointMetrics = ScopedEndpointMetrics::getCurrent()] (juce::Result playbackResult)
+        {
+            ScopedEndpointMetrics scope (endpointMetrics);
+
+            if (playbackResult.failed())
+                sendHttpErrorResponse (playbackResult.getErrorMessage(), 500, *connection);
+            else
+                sendHttpResultResponse (numEvents, 200, *connection);
+        });
+    });
+}
+
+//=================================================================================================
+
+void recorderStart (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        InputRecorder::getInstance()->start();
+
+        sendHttpResultResponse (true, 200, *connection);
+    });
+}
+
+void recorderStop (Request request)
+{
+    auto file = request.data.getProperty ("file", "").toString().trim();
+
+    if (file.isNotEmpty() && ! juce::File::isAbsolutePath (file))
+    {
+        sendHttpErrorResponse ("recording file must be an absolute path", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([file, connection = std::move (request.connection)]
+    {
+        auto gesture = InputRecorder::getInstance()->stop();
+        auto data = InputRecorder::toBinary (gesture);
+
+        if (file.isEmpty())
+        {
+            sendHttpResponse (data, "application/octet-stream", 200, *connection);
+            return;
+        }
+
+        if (! juce::File (file).replaceWithData (data.getData(), data.getSize()))
+        {
+            sendHttpErrorResponse ("unable to write recording file", 500, *connection);
+            return;
+        }
+
+        sendHttpResultResponse (static_cast<int> (gesture.events.size()), 200, *connection);
+    });
+}
+
+void recorderReplay (Request request)
+{
+    juce::MemoryBlock data;
+
+    auto file = request.data.getProperty ("file", "").toString().trim();
+    if (file.isNotEmpty())
+    {
+        if (! juce::File::isAbsolutePath (file))
+        {
+            sendHttpErrorResponse ("recording file must be an absolute path", 500, *request.connection);
+            return;
+        }
+
+        if (! juce::File (file).loadFileAsData (data))
+        {
+            sendHttpErrorResponse ("unable to read recording file", 500, *request.connection);
+            return;
+        }
+    }
+    else
+    {
+        juce::MemoryOutputStream output (data, false);
+        if (! juce::Base64::convertFromBase64 (output, request.data.getProperty ("data", "").toString()))
+        {
+            sendHttpErrorResponse ("invalid base64 recording data", 500, *request.connection);
+            return;
+        }
+    }
+
+    Gesture gesture;
+
+    auto result = InputRecorder::fromBinary (data, gesture);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    auto speed = static_cast<double> (request.data.getProperty ("speed", 1.0));
+    if (speed <= 0.0)
+    {
+        sendHttpErrorResponse ("invalid replay speed specified", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([gesture = gesture.withSpeed (speed), connection = std::move (request.connection)]() mutable
+    {
+        auto numEvents = static_cast<int> (gesture.events.size());
+
+        GesturePlayer::play (std::move (gesture), [numEvents, connection, endpointMetrics = ScopedEndpointMetrics::getCurrent()] (juce::Result playbackResult)
+        {
+            ScopedEndpointMetrics scope (endpointMetrics);
+
+            if (playbackResult.failed())
+                sendHttpErrorResponse (playbackResult.getErrorMessage(), 500, *connection);
+            else
+                sendHttpResultResponse (numEvents, 200, *connection);
+        });
+    });
+}
+
+//=================================================================================================
+
+void traceHops (Request request)
+{
+    sendHttpResultResponse (MessageThreadTracer::getInstance()->toVar(), 200, *request.connection);
+}
+
+void traceHopsChrome (Request request)
+{
+    sendHttpResponse (MessageThreadTracer::getInstance()->toChromeTrace(), "application/json", 200, *request.connection);
+}
+
+void traceStallsConfigure (Request request)
+{
+    auto threshold = static_cast<int> (request.data.getProperty ("threshold", 0));
+    if (threshold < 0)
+    {
+        sendHttpErrorResponse ("invalid stall threshold specified", 500, *request.connection);
+        return;
+    }
+
+    MessageThreadTracer::getInstance()->setStallThreshold (threshold);
+
+    sendHttpResultResponse (threshold, 200, *request.connection);
+}
+
+void traceSessionStart (Request request)
+{
+    SessionTracer::getInstance()->start();
+
+    sendHttpResultResponse (true, 200, *request.connection);
+}
+
+void traceSessionStop (Request request)
+{
+    SessionTracer::getInstance()->stop();
+
+    sendHttpResultResponse (true, 200, *request.connection);
+}
+
+void traceSessionDump (Request request)
+{
+    auto data = SessionTracer::getInstance()->toChromeTrace();
+
+    auto file = request.data.getProperty ("file", "").toString().trim();
+    if (file.isEmpty())
+    {
+        sendHttpResponse (data, "application/json", 200, *request.connection);
+        return;
+    }
+
+    if (! juce::File::isAbsolutePath (file))
+    {
+        sendHttpErrorResponse ("trace file must be an absolute path", 500, *request.connection);
+        return;
+    }
+
+    if (! juce::File (file).replaceWithData (data.getData(), data.getSize()))
+    {
+        sendHttpErrorResponse ("unable to write trace file", 500, *request.connection);
+        return;
+    }
+
+    sendHttpResultResponse (file, 200, *request.connection);
+}
+
+void logConfigure (Request request)
+{
+    auto* logger = AsyncLogger::getInstance();
+
+    if (request.data.hasProperty ("level"))
+    {
+        auto level = AsyncLogger::levelFromString (request.data.getProperty ("level", "").toString());
+        if (! level.has_value())
+        {
+            sendHttpErrorResponse ("invalid log level specified", 500, *request.connection);
+            return;
+        }
+
+        logger->setLevel (*level);
+    }
+
+    if (request.data.hasProperty ("maxPayloadSize"))
+    {
+        auto maxPayloadSize = static_cast<juce::int64> (request.data.getProperty ("maxPayloadSize", 0));
+        if (maxPayloadSize < 0)
+        {
+            sendHttpErrorResponse ("invalid max payload size specified", 500, *request.connection);
+            return;
+        }
+
+        logger->setMaxPayloadSize (static_cast<std::size_t> (maxPayloadSize));
+    }
+
+    if (auto sampling = request.data.getProperty ("sampling", {}).getDynamicObject())
+    {
+        for (const auto& endpointSampling : sampling->getProperties())
+            logger->setEndpointSampling (endpointSampling.name.toString(), static_cast<int> (endpointSampling.value));
+    }
+
+    sendHttpResultResponse (logger->toVar(), 200, *request.connection);
+}
+
+//=================================================================================================
+
+void stateCapture (Request request)
+{
+    auto snapshotName = request.data.getProperty ("name", "baseline").toString();
+    auto fileName = request.data.getProperty ("file", "").toString();
+
+    if (fileName.isNotEmpty() && ! juce::File::isAbsolutePath (fileName))
+    {
+        sendHttpErrorResponse ("state snapshot file must be an absolute path", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([snapshotName, fileName, connection = std::move (request.connection)]
+    {
+        auto snapshots = StateSnapshots::getInstance();
+
+        auto result = snapshots->capture (snapshotName);
+        if (result.failed())
+        {
+            sendHttpErrorResponse (result.getErrorMessage(), 500, *connection);
+            return;
+        }
+
+        if (fileName.isNotEmpty())
+        {
+            auto data = snapshots->toBinary (snapshotName);
+
+            if (! juce::File (fileName).replaceWithData (data.getData(), data.getSize()))
+            {
+                sendHttpErrorResponse ("unable to write state snapshot file", 500, *connection);
+                return;
+            }
+        }
+
+        sendHttpResultResponse (snapshots->toVar(), 200, *connection);
+    });
+}
+
+void stateRestore (Request request)
+{
+    auto snapshotName = request.data.getProperty ("name", "baseline").toString();
+    auto fileName = request.data.getProperty ("file", "").toString();
+
+    if (fileName.isNotEmpty() && ! juce::File::isAbsolutePath (fileName))
+    {
+        sendHttpErrorResponse ("state snapshot file must be an absolute path", 500, *request.connection);
+        return;
+    }
+
+    callOnMessageThread ([snapshotName, fileName, connection = std::move (request.connection)]
+    {
+        auto snapshots = StateSnapshots::getInstance();
+
+        if (fileName.isNotEmpty())
+        {
+            juce::MemoryBlock data;
+            if (! juce::File (fileName).loadFileAsData (data))
+            {
+                sendHttpErrorResponse ("unable to read state snapshot file", 500, *connection);
+                return;
+            }
+
+            auto result = snapshots->fromBinary (snapshotName, data);
+            if (result.failed())
+            {
+                sendHttpErrorResponse (result.getErrorMessage(), 500, *connection);
+                return;
+            }
+        }
+
+        StateSnapshots::RestoreStats stats;
+
+        auto result = snapshots->restore (snapshotName, stats);
+        if (result.failed())
+        {
+            sendHttpErrorResponse (result.getErrorMessage(), 500, *connection);
+            return;
+        }
+
+        juce::DynamicObject::Ptr restoreResult = new juce::DynamicObject;
+        restoreResult->setProperty ("restored", stats.restoredProviders);
+        restoreResult->setProperty ("unchanged", stats.numUnchangedProviders);
+
+        sendHttpResultResponse (restoreResult.get(), 200, *connection);
+    });
+}
+
+void stateList (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        sendHttpResultResponse (StateSnapshots::getInstance()->toVar(), 200, *connection);
+    });
+}
+
+//=================================================================================================
+
+void memorySnapshot (Request request)
+{
+    callOnMessageThread ([connection = std::move (request.connection)]
+    {
+        auto snapshot = MemoryTracker::capture().toVar();
+
+        if (auto object = snapshot.getDynamicObject())
+            object->setProperty ("allocation_tracking", MemoryTracker::isAllocationTrackingEnabled());
+
+        sendHttpResultResponse (snapshot, 200, *connection);
+    });
+}
+
+//=================================================================================================
+
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+namespace {
+
+juce::Result readRequestedAudio (const juce::var& data,
+                                 const juce::Identifier& tapProperty,
+                                 const juce::Identifier& streamProperty,
+                                 AudioTap::Stream defaultStream,
+                                 juce::AudioBuffer<float>& buffer,
+                                 double& sampleRate)
+{
+    auto tapName = data.getProperty (tapProperty, "").toString().trim();
+    if (tapName.isEmpty())
+        return juce::Result::fail ("invalid audio tap specified");
+
+    auto stream = data.hasProperty (streamProperty)
+        ? AudioTap::streamFromString (data.getProperty (streamProperty, "").toString())
+        : std::make_optional (defaultStream);
+
+    if (! stream.has_value())
+        return juce::Result::fail ("invalid audio stream specified");
+
+    auto duration = juce::RelativeTime::milliseconds (static_cast<int> (data.getProperty ("duration", 1000)));
+    if (duration.inMilliseconds() <= 0)
+        return juce::Result::fail ("invalid duration specified");
+
+    return AudioTap::readTap (tapName, *stream, duration, buffer, sampleRate);
+}
+
+} // namespace
+
+void audioTaps (Request request)
+{
+    sendHttpResultResponse (AudioTap::getTapNames(), 200, *request.connection);
+}
+
+void audioLevels (Request request)
+{
+    // Analysis runs on the pool thread, the audio being read from the lock-free ring of the tap
+    juce::AudioBuffer<float> buffer;
+    double sampleRate = 0.0;
+
+    auto result = readRequestedAudio (request.data, "tap", "stream", AudioTap::Stream::output, buffer, sampleRate);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    sendHttpResultResponse (AudioAnalysis::measureLevels (buffer).toVar(), 200, *request.connection);
+}
+
+void audioSpectrum (Request request)
+{
+    juce::AudioBuffer<float> buffer;
+    double sampleRate = 0.0;
+
+    auto result = readRequestedAudio (request.data, "tap", "stream", AudioTap::Stream::output, buffer, sampleRate);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    auto fftOrder = static_cast<int> (request.data.getProperty ("order", 12));
+    auto maxPeaks = static_cast<int> (request.data.getProperty ("peaks", 5));
+
+    AudioSpectrum spectrum;
+
+    result = AudioAnalysis::computeSpectrum (buffer, sampleRate, fftOrder, maxPeaks, spectrum);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    sendHttpResultResponse (spectrum.toVar(), 200, *request.connection);
+}
+
+void audioLatency (Request request)
+{
+    // The reference defaults to the output of the tap, and the signal to its input, measuring the round trip latency
+    if (! request.data.hasProperty ("reference") && request.data.getDynamicObject() != nullptr)
+        request.data.getDynamicObject()->setProperty ("reference", request.data.getProperty ("tap", ""));
+
+    juce::AudioBuffer<float> reference;
+    double referenceSampleRate = 0.0;
+
+    auto result = readRequestedAudio (request.data, "reference", "referenceStream", AudioTap::Stream::output, reference, referenceSampleRate);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    juce::AudioBuffer<float> signal;
+    double sampleRate = 0.0;
+
+    result = readRequestedAudio (request.data, "tap", "stream", AudioTap::Stream::input, signal, sampleRate);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    if (! juce::approximatelyEqual (sampleRate, referenceSampleRate))
+    {
+        sendHttpErrorResponse ("sample rates of the signal and the reference differ", 500, *request.connection);
+        return;
+    }
+
+    auto maxLatency = static_cast<int> (request.data.getProperty ("maxLatency", 500));
+
+    AudioLatency latency;
+
+    result = AudioAnalysis::measureLatency (reference, signal, sampleRate, static_cast<int> (maxLatency * sampleRate / 1000.0), latency);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    sendHttpResultResponse (latency.toVar(), 200, *request.connection);
+}
+#endif
+
+//=================================================================================================
+
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+void audioProcessors (Request request)
+{
+    sendHttpResultResponse (OfflineRenderer::getInstance()->getProcessorNames(), 200, *request.connection);
+}
+
+void audioRender (Request request)
+{
+    // Parsing and waiting on the renders happen on the pool thread, the renders themselves run on the render threads
+    std::vector<OfflineRenderJob> jobs;
+
+    auto result = OfflineRenderer::parseJobs (request.data, jobs);
+    if (result.failed())
+    {
+        sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        return;
+    }
+
+    const auto results = OfflineRenderer::getInstance()->render (jobs);
+
+    sendHttpResultResponse (OfflineRenderer::resultsToVar (results), 200, *request.connection);
+}
+#endif
+
 } // namespace straw::Endpoints
@@ -26,13 +26,68 @@ namespace straw::Endpoints {
 //=================================================================================================
 
 void sleep (Request request);
+void timeAdvance (Request request);
+void timeWarp (Request request);
+void timeReal (Request request);
 
 //=================================================================================================
 
 void componentExists (Request request);
 void componentVisible (Request request);
+void componentAt (Request request);
+void componentFind (Request request);
+void accessibilityFind (Request request);
+void accessibilitySnapshot (Request request);
 void componentInfo (Request request);
 void componentClick (Request request);
 void componentRender (Request request);
 
+//=================================================================================================
+
+void gesturePlay (Request request);
+
+//=================================================================================================
+
+void recorderStart (Request request);
+void recorderStop (Request request);
+void recorderReplay (Request request);
+
+//=================================================================================================
+
+void profilePaint (Request request);
+void framesStart (Request request);
+void framesStop (Request request);
+void framesStats (Request request);
+void traceHops (Request request);
+void traceHopsChrome (Request request);
+void traceStallsConfigure (Request request);
+void traceSessionStart (Request request);
+void traceSessionStop (Request request);
+void traceSessionDump (Request request);
+void logConfigure (Request request);
+
+//=================================================================================================
+
+void stateCapture (Request request);
+void stateRestore (Request request);
+void stateList (Request request);
+
+//=================================================================================================
+
+void memorySnapshot (Request request);
+
+//=================================================================================================
+
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+void audioTaps (Request request);
+void audioLevels (Request request);
+void audioSpectrum (Request request);
+void audioLatency (Request request);
+#endif
+
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+void audioProcessors (Request request);
+void audioRender (Request request);
+#endif
+
 } // namespace straw::Endpoints
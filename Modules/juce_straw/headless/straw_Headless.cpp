@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Headless.h"
+
+#include <atomic>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+std::atomic<int> headlessModeOverride { -1 };
+
+bool isHeadlessModeRequested()
+{
+    auto environmentValue = juce::SystemStats::getEnvironmentVariable ("STRAW_HEADLESS", {}).trim().toLowerCase();
+    if (environmentValue.isNotEmpty())
+        return environmentValue != "0" && environmentValue != "false" && environmentValue != "no";
+
+    return juce::JUCEApplicationBase::getCommandLineParameterArray().contains ("--headless");
+}
+
+} // namespace
+
+//=================================================================================================
+
+bool isHeadlessModeEnabled()
+{
+    auto modeOverride = headlessModeOverride.load();
+    if (modeOverride >= 0)
+        return modeOverride != 0;
+
+    static const bool isRequested = isHeadlessModeRequested();
+    return isRequested;
+}
+
+void setHeadlessModeEnabled (bool shouldBeEnabled)
+{
+    headlessModeOverride.store (shouldBeEnabled ? 1 : 0);
+}
+
+juce::Component* findHeadlessWindow (juce::Component* component)
+{
+    if (component != nullptr)
+    {
+        if (auto topLevelComponent = component->getTopLevelComponent(); dynamic_cast<HeadlessPeer*> (topLevelComponent->getPeer()) != nullptr)
+            return topLevelComponent;
+    }
+
+    // Desktop components are ordered back to front
+    auto& desktop = juce::Desktop::getInstance();
+    for (int index = desktop.getNumComponents(); --index >= 0;)
+    {
+        auto desktopComponent = desktop.getComponent (index);
+
+        if (desktopComponent->isVisible() && dynamic_cast<HeadlessPeer*> (desktopComponent->getPeer()) != nullptr)
+            return desktopComponent;
+    }
+
+    return nullptr;
+}
+
+//=================================================================================================
+
+HeadlessPeer::HeadlessPeer (juce::Component& component, int styleFlags)
+    : juce::ComponentPeer (component, styleFlags)
+    , bounds (component.getBounds())
+{
+}
+
+HeadlessPeer::~HeadlessPeer()
+{
+    cancelPendingUpdate();
+}
+
+//=================================================================================================
+
+juce::Image HeadlessPeer::getImage()
+{
+    performAnyPendingRepaintsNow();
+
+    return image.createCopy();
+}
+
+//=================================================================================================
+
+void* HeadlessPeer::getNativeHandle() const
+{
+    return nullptr;
+}
+
+void HeadlessPeer::setVisible (bool shouldBeVisible)
+{
+    visible = shouldBeVisible;
+
+    if (visible)
+        repaint (bounds.withZeroOrigin());
+}
+
+void HeadlessPeer::setTitle (const juce::String& newTitle)
+{
+    title = newTitle;
+}
+
+void HeadlessPeer::setBounds (const juce::Rectangle<int>& newBounds, bool isNowFullScreen)
+{
+    const bool isResized = newBounds.getWidth() != bounds.getWidth() || newBounds.getHeight() != bounds.getHeight();
+
+    bounds = newBounds;
+    fullScreen = isNowFullScreen;
+
+    if (isResized)
+        image = {};
+
+    handleMovedOrResized();
+
+    if (isResized)
+        repaint (bounds.withZeroOrigin());
+}
+
+juce::Rectangle<int> HeadlessPeer::getBounds() const
+{
+    return bounds;
+}
+
+juce::Point<float> HeadlessPeer::localToGlobal (juce::Point<float> relativePosition)
+{
+    return relativePosition + bounds.getPosition().toFloat();
+}
+
+juce::Point<float> HeadlessPeer::globalToLocal (juce::Point<float> screenPosition)
+{
+    return screenPosition - bounds.getPosition().toFloat();
+}
+
+void HeadlessPeer::setMinimised (bool shouldBeMinimised)
+{
+    minimised = shouldBeMinimised;
+}
+
+bool HeadlessPeer::isMinimised() const
+{
+    return minimised;
+}
+
+bool HeadlessPeer::isShowing() const
+{
+    return visible && ! minimised;
+}
+
+void HeadlessPeer::setFullScreen (bool shouldBeFullScreen)
+{
+    fullScreen = shouldBeFullScreen;
+}
+
+bool HeadlessPeer::isFullScreen() const
+{
+    return fullScreen;
+}
+
+bool HeadlessPeer::contains (juce::Point<int> localPos, [[maybe_unused]] bool trueIfInAChildWindow) const
+{
+    return bounds.withZeroOrigin().contains (localPos);
+}
+
+juce::ComponentPeer::OptionalBorderSize HeadlessPeer::getFrameSizeIfPresent() const
+{
+    return OptionalBorderSize { juce::BorderSize<int>() };
+}
+
+juce::BorderSize<int> HeadlessPeer::getFrameSize() const
+{
+    return {};
+}
+
+bool HeadlessPeer::setAlwaysOnTop ([[maybe_unused]] bool alwaysOnTop)
+{
+    return true;
+}
+
+void HeadlessPeer::toFront (bool takeKeyboardFocus)
+{
+    if (takeKeyboardFocus)
+        grabFocus();
+
+    handleBroughtToFront();
+}
+
+void HeadlessPeer::toBehind ([[maybe_unused]] juce::ComponentPeer* other)
+{
+}
+
+bool HeadlessPeer::isFocused() const
+{
+    return focused;
+}
+
+void HeadlessPeer::grabFocus()
+{
+    if (focused)
+        return;
+
+    focused = true;
+    handleFocusGain();
+}
+
+void HeadlessPeer::textInputRequired ([[maybe_unused]] juce::Point<int> position, [[maybe_unused]] juce::TextInputTarget& target)
+{
+}
+
+void HeadlessPeer::repaint (const juce::Rectangle<int>& area)
+{
+    auto clippedArea = area.getIntersection (bounds.withZeroOrigin());
+    if (clippedArea.isEmpty())
+        return;
+
+    dirtyRegion.add (clippedArea);
+    triggerAsyncUpdate();
+}
+
+void HeadlessPeer::performAnyPendingRepaintsNow()
+{
+    cancelPendingUpdate();
+    handleAsyncUpdate();
+}
+
+void HeadlessPeer::setAlpha (float newAlpha)
+{
+    alpha = newAlpha;
+}
+
+juce::StringArray HeadlessPeer::getAvailableRenderingEngines()
+{
+    return { "Software Renderer" };
+}
+
+void HeadlessPeer::setIcon ([[maybe_unused]] const juce::Image& newIcon)
+{
+}
+
+//=================================================================================================
+
+void HeadlessPeer::handleAsyncUpdate()
+{
+    if (dirtyRegion.isEmpty() || ! visible || bounds.isEmpty())
+        return;
+
+    if (! image.isValid())
+    {
+        image = juce::Image (getComponent().isOpaque() ? juce::Image::RGB : juce::Image::ARGB, bounds.getWidth(), bounds.getHeight(), true);
+        dirtyRegion = juce::RectangleList<int> (bounds.withZeroOrigin());
+    }
+
+    if (! getComponent().isOpaque())
+    {
+        for (const auto& area : dirtyRegion)
+            image.clear (area);
+    }
+
+    juce::LowLevelGraphicsSoftwareRenderer context (image, {}, dirtyRegion);
+
+    dirtyRegion.clear();
+
+    handlePaint (context);
+}
+
+} // namespace straw
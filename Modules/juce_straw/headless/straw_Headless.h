@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <utility>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Check if the headless mode is enabled.
+ *
+ * Unless explicitly set with `setHeadlessModeEnabled`, the headless mode is enabled when the `STRAW_HEADLESS` environment
+ * variable is set to a truthy value, or when the application is launched with the `--headless` command line parameter.
+ */
+bool isHeadlessModeEnabled();
+
+/**
+ * @brief Enable or disable the headless mode, overriding the environment and the command line.
+ *
+ * Must be called before the top level components are added to the desktop.
+ *
+ * @param shouldBeEnabled True to create headless peers for the headless top level components.
+ */
+void setHeadlessModeEnabled (bool shouldBeEnabled);
+
+/**
+ * @brief Find the headless window that should host a window created by JUCE, like a popup menu or an alert window.
+ *
+ * @param component The component the window is created for, can be nullptr.
+ *
+ * @return The top level component of the component if it has a headless peer, otherwise the frontmost visible top level
+ *         component with a headless peer, or nullptr if there is none.
+ */
+juce::Component* findHeadlessWindow (juce::Component* component);
+
+//=================================================================================================
+
+/**
+ * @brief A component peer without a native window, rendering its component into an in-memory image.
+ *
+ * The component is registered on the `juce::Desktop` like any other top level component, so it's found by the desktop
+ * traversals, it's showing when visible, it receives mouse and keyboard events delivered through the peer, and it's repainted
+ * asynchronously into an image that can be inspected.
+ *
+ * This makes it possible to run many instances of the application under automation on hosts without a display server.
+ */
+class HeadlessPeer
+    : public juce::ComponentPeer
+    , private juce::AsyncUpdater
+{
+public:
+    /**
+     * @brief Constructor for the HeadlessPeer class.
+     *
+     * @param component The top level component owning the peer.
+     * @param styleFlags The window style flags, as passed to `juce::Component::addToDesktop`.
+     */
+    HeadlessPeer (juce::Component& component, int styleFlags);
+
+    /**
+     * @brief Destructor for the HeadlessPeer class.
+     */
+    ~HeadlessPeer() override;
+
+    /**
+     * @brief Get a copy of the in-memory framebuffer, after painting any pending repaints.
+     */
+    [[nodiscard]] juce::Image getImage();
+
+    /** @internal */
+    void* getNativeHandle() const override;
+    /** @internal */
+    void setVisible (bool shouldBeVisible) override;
+    /** @internal */
+    void setTitle (const juce::String& newTitle) override;
+    /** @internal */
+    void setBounds (const juce::Rectangle<int>& newBounds, bool isNowFullScreen) override;
+    /** @internal */
+    juce::Rectangle<int> getBounds() const override;
+    /** @internal */
+    juce::Point<float> localToGlobal (juce::Point<float> relativePosition) override;
+    /** @internal */
+    juce::Point<float> globalToLocal (juce::Point<float> screenPosition) override;
+    /** @internal */
+    using juce::ComponentPeer::localToGlobal;
+    /** @internal */
+    using juce::ComponentPeer::globalToLocal;
+    /** @internal */
+    void setMinimised (bool shouldBeMinimised) override;
+    /** @internal */
+    bool isMinimised() const override;
+    /** @internal */
+    bool isShowing() const override;
+    /** @internal */
+    void setFullScreen (bool shouldBeFullScreen) override;
+    /** @internal */
+    bool isFullScreen() const override;
+    /** @internal */
+    bool contains (juce::Point<int> localPos, bool trueIfInAChildWindow) const override;
+    /** @internal */
+    OptionalBorderSize getFrameSizeIfPresent() const override;
+    /** @internal */
+    juce::BorderSize<int> getFrameSize() const override;
+    /** @internal */
+    bool setAlwaysOnTop (bool alwaysOnTop) override;
+    /** @internal */
+    void toFront (bool takeKeyboardFocus) override;
+    /** @internal */
+    void toBehind (juce::ComponentPeer* other) override;
+    /** @internal */
+    bool isFocused() const override;
+    /** @internal */
+    void grabFocus() override;
+    /** @internal */
+    void textInputRequired (juce::Point<int> position, juce::TextInputTarget& target) override;
+    /** @internal */
+    void repaint (const juce::Rectangle<int>& area) override;
+    /** @internal */
+    void performAnyPendingRepaintsNow() override;
+    /** @internal */
+    void setAlpha (float newAlpha) override;
+    /** @internal */
+    juce::StringArray getAvailableRenderingEngines() override;
+    /** @internal */
+    void setIcon (const juce::Image& newIcon) override;
+
+private:
+    void handleAsyncUpdate() override;
+
+    juce::Rectangle<int> bounds;
+    juce::RectangleList<int> dirtyRegion;
+    juce::Image image;
+    juce::String title;
+    float alpha = 1.0f;
+    bool visible = false;
+    bool minimised = false;
+    bool fullScreen = false;
+    bool focused = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeadlessPeer)
+};
+
+//=================================================================================================
+
+/**
+ * @brief Make a top level component use a HeadlessPeer when the headless mode is enabled.
+ *
+ * When the headless mode is disabled, the native peer of the base component is created as usual. Windows adding themselves to
+ * the desktop in their constructor, like `juce::DocumentWindow`, get their peer replaced once constructed.
+ *
+ * @code
+ * class MainWindow : public straw::Headless<juce::DocumentWindow>
+ * {
+ * public:
+ *     MainWindow (const juce::String& name)
+ *         : straw::Headless<juce::DocumentWindow> (name, juce::Colours::black, juce::DocumentWindow::allButtons)
+ *     {
+ *     }
+ * };
+ * @endcode
+ */
+template <class Base>
+class Headless : public Base
+{
+public:
+    template <class... Args>
+    explicit Headless (Args&&... args)
+        : Base (std::forward<Args> (args)...)
+    {
+        // The base constructor can add the window to the desktop before this class is able to create its peer
+        if (isHeadlessModeEnabled() && Base::isOnDesktop() && dynamic_cast<HeadlessPeer*> (Base::getPeer()) == nullptr)
+        {
+            const auto styleFlags = Base::getPeer()->getStyleFlags();
+
+            Base::removeFromDesktop();
+            Base::addToDesktop (styleFlags);
+        }
+    }
+
+    /** @internal */
+    juce::ComponentPeer* createNewPeer (int styleFlags, void* nativeWindowToAttachTo) override
+    {
+        if (isHeadlessModeEnabled())
+            return new HeadlessPeer (*this, styleFlags);
+
+        return Base::createNewPeer (styleFlags, nativeWindowToAttachTo);
+    }
+};
+
+//=================================================================================================
+
+/**
+ * @brief Make the windows created by JUCE for the components using this look and feel live inside the headless windows.
+ *
+ * When the headless mode is enabled, popup menus (including the combo box popups) and alert windows become children of the
+ * headless window found by `findHeadlessWindow`, instead of creating native windows. When it's disabled, or when there is no
+ * headless window to host them, they are created as usual.
+ *
+ * Tooltip windows and call out boxes are created by the application, which should give them a headless window as parent
+ * component, or wrap the tooltip window in `straw::Headless`.
+ *
+ * @code
+ * straw::HeadlessLookAndFeel<> lookAndFeel;
+ * juce::LookAndFeel::setDefaultLookAndFeel (&lookAndFeel);
+ * @endcode
+ */
+template <class Base = juce::LookAndFeel_V4>
+class HeadlessLookAndFeel : public Base
+{
+public:
+    using Base::Base;
+
+    /** @internal */
+    juce::Component* getParentComponentForMenuOptions (const juce::PopupMenu::Options& options) override
+    {
+        if (auto parentComponent = Base::getParentComponentForMenuOptions (options))
+            return parentComponent;
+
+        return isHeadlessModeEnabled() ? findHeadlessWindow (options.getTargetComponent()) : nullptr;
+    }
+
+    /** @internal */
+    juce::AlertWindow* createAlertWindow (const juce::String& title,
+                                          const juce::String& message,
+                                          const juce::String& button1,
+                                          const juce::String& button2,
+                                          const juce::String& button3,
+                                          juce::MessageBoxIconType iconType,
+                                          int numButtons,
+                                          juce::Component* associatedComponent) override
+    {
+        auto alertWindow = Base::createAlertWindow (title, message, button1, button2, button3, iconType, numButtons, associatedComponent);
+
+        // Adding the alert window as a child removes the native peer it created for itself
+        if (alertWindow != nullptr && isHeadlessModeEnabled())
+        {
+            if (auto headlessWindow = findHeadlessWindow (associatedComponent))
+                headlessWindow->addChildComponent (alertWindow);
+        }
+
+        return alertWindow;
+    }
+};
+
+} // namespace straw
@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_AccessibilityCache.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr juce::AccessibilityRole allAccessibilityRoles[] =
+{
+    juce::AccessibilityRole::button,
+    juce::AccessibilityRole::toggleButton,
+    juce::AccessibilityRole::radioButton,
+    juce::AccessibilityRole::comboBox,
+    juce::AccessibilityRole::image,
+    juce::AccessibilityRole::slider,
+    juce::AccessibilityRole::label,
+    juce::AccessibilityRole::staticText,
+    juce::AccessibilityRole::editableText,
+    juce::AccessibilityRole::menuItem,
+    juce::AccessibilityRole::menuBar,
+    juce::AccessibilityRole::popupMenu,
+    juce::AccessibilityRole::table,
+    juce::AccessibilityRole::tableHeader,
+    juce::AccessibilityRole::column,
+    juce::AccessibilityRole::row,
+    juce::AccessibilityRole::cell,
+    juce::AccessibilityRole::hyperlink,
+    juce::AccessibilityRole::list,
+    juce::AccessibilityRole::listItem,
+    juce::AccessibilityRole::tree,
+    juce::AccessibilityRole::treeItem,
+    juce::AccessibilityRole::progressBar,
+    juce::AccessibilityRole::group,
+    juce::AccessibilityRole::dialogWindow,
+    juce::AccessibilityRole::window,
+    juce::AccessibilityRole::scrollBar,
+    juce::AccessibilityRole::tooltip,
+    juce::AccessibilityRole::splashScreen,
+    juce::AccessibilityRole::ignored,
+    juce::AccessibilityRole::unspecified
+};
+
+juce::var makeAccessibleStateVar (const juce::AccessibleState& state)
+{
+    juce::Array<juce::var> flags;
+
+    if (state.isFocused())
+        flags.add ("focused");
+
+    if (state.isChecked())
+        flags.add ("checked");
+
+    if (state.isSelected())
+        flags.add ("selected");
+
+    if (state.isExpanded())
+        flags.add ("expanded");
+
+    if (state.isCollapsed())
+        flags.add ("collapsed");
+
+    return flags;
+}
+
+void setOrRemoveProperty (juce::DynamicObject& object, const juce::Identifier& name, const juce::var& value, bool isSet)
+{
+    if (isSet)
+        object.setProperty (name, value);
+    else
+        object.removeProperty (name);
+}
+
+} // namespace
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (AccessibilityCache)
+
+AccessibilityCache::~AccessibilityCache()
+{
+    untrackAll();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+juce::Array<juce::Component*> AccessibilityCache::findComponents (const Query& query, int maxResults)
+{
+    update();
+
+    if (! isCacheValid)
+        rebuild();
+
+    juce::Array<juce::Component*> result;
+
+    const std::vector<juce::Component*>* candidates = &accessibleComponents;
+    if (query.role.has_value())
+    {
+        auto roleComponents = componentsByRole.find (static_cast<int> (*query.role));
+        if (roleComponents == componentsByRole.end())
+            return result;
+
+        candidates = &roleComponents->second;
+    }
+
+    // Titles and values change without notifications, they are read from the handlers of the candidates
+    for (auto component : *candidates)
+    {
+        if (result.size() >= maxResults)
+            break;
+
+        auto handler = component->getAccessibilityHandler();
+        if (handler == nullptr)
+            continue;
+
+        if (query.title.isNotEmpty() && ! handler->getTitle().equalsIgnoreCase (query.title))
+            continue;
+
+        if (query.value.isNotEmpty() && ! getAccessibleValue (*handler).equalsIgnoreCase (query.value))
+            continue;
+
+        result.add (component);
+    }
+
+    return result;
+}
+
+juce::var AccessibilityCache::getSnapshot()
+{
+    update();
+
+    if (! isCacheValid)
+        rebuild();
+
+    for (const auto& node : snapshotNodes)
+    {
+        auto handler = node.component->getAccessibilityHandler();
+        if (handler == nullptr)
+            continue;
+
+        const auto title = handler->getTitle();
+        setOrRemoveProperty (*node.object, "title", title, title.isNotEmpty());
+
+        const auto value = getAccessibleValue (*handler);
+        setOrRemoveProperty (*node.object, "value", value, value.isNotEmpty());
+
+        const auto state = makeAccessibleStateVar (handler->getCurrentState());
+        setOrRemoveProperty (*node.object, "state", state, state.size() > 0);
+    }
+
+    // Cloned, as the cached nodes are refreshed in place by the next snapshot
+    return juce::var (snapshotWindows).clone();
+}
+
+//=================================================================================================
+
+juce::String AccessibilityCache::roleToString (juce::AccessibilityRole role)
+{
+    switch (role)
+    {
+        case juce::AccessibilityRole::button: return "button";
+        case juce::AccessibilityRole::toggleButton: return "toggleButton";
+        case juce::AccessibilityRole::radioButton: return "radioButton";
+        case juce::AccessibilityRole::comboBox: return "comboBox";
+        case juce::AccessibilityRole::image: return "image";
+        case juce::AccessibilityRole::slider: return "slider";
+        case juce::AccessibilityRole::label: return "label";
+        case juce::AccessibilityRole::staticText: return "staticText";
+        case juce::AccessibilityRole::editableText: return "editableText";
+        case juce::AccessibilityRole::menuItem: return "menuItem";
+        case juce::AccessibilityRole::menuBar: return "menuBar";
+        case juce::AccessibilityRole::popupMenu: return "popupMenu";
+        case juce::AccessibilityRole::table: return "table";
+        case juce::AccessibilityRole::tableHeader: return "tableHeader";
+        case juce::AccessibilityRole::column: return "column";
+        case juce::AccessibilityRole::row: return "row";
+        case juce::AccessibilityRole::cell: return "cell";
+        case juce::AccessibilityRole::hyperlink: return "hyperlink";
+        case juce::AccessibilityRole::list: return "list";
+        case juce::AccessibilityRole::listItem: return "listItem";
+        case juce::AccessibilityRole::tree: return "tree";
+        case juce::AccessibilityRole::treeItem: return "treeItem";
+        case juce::AccessibilityRole::progressBar: return "progressBar";
+        case juce::AccessibilityRole::group: return "group";
+        case juce::AccessibilityRole::dialogWindow: return "dialogWindow";
+        case juce::AccessibilityRole::window: return "window";
+        case juce::AccessibilityRole::scrollBar: return "scrollBar";
+        case juce::AccessibilityRole::tooltip: return "tooltip";
+        case juce::AccessibilityRole::splashScreen: return "splashScreen";
+        case juce::AccessibilityRole::ignored: return "ignored";
+        case juce::AccessibilityRole::unspecified:
+        default: break;
+    }
+
+    return "unspecified";
+}
+
+std::optional<juce::AccessibilityRole> AccessibilityCache::roleFromString (juce::StringRef name)
+{
+    for (auto role : allAccessibilityRoles)
+    {
+        if (roleToString (role).equalsIgnoreCase (name))
+            return role;
+    }
+
+    return std::nullopt;
+}
+
+juce::String AccessibilityCache::getAccessibleValue (const juce::AccessibilityHandler& handler)
+{
+    if (auto valueInterface = handler.getValueInterface())
+        return valueInterface->getCurrentValueAsString();
+
+    if (auto textInterface = handler.getTextInterface())
+        return textInterface->getText ({ 0, textInterface->getTotalNumCharacters() });
+
+    return {};
+}
+
+//=================================================================================================
+
+void AccessibilityCache::componentUntracked (juce::Component&, bool)
+{
+    // The cached components might be deleted
+    isCacheValid = false;
+    accessibleComponents.clear();
+    componentsByRole.clear();
+    snapshotNodes.clear();
+    snapshotWindows.clear();
+}
+
+void AccessibilityCache::componentsChanged (const std::unordered_set<juce::Component*>&)
+{
+    isCacheValid = false;
+}
+
+//=================================================================================================
+
+void AccessibilityCache::rebuild()
+{
+    accessibleComponents.clear();
+    componentsByRole.clear();
+    snapshotNodes.clear();
+    snapshotWindows.clear();
+
+    for (auto topLevelComponent : getTopLevelComponents())
+        addAccessibleComponents (*topLevelComponent, snapshotWindows);
+
+    isCacheValid = true;
+}
+
+void AccessibilityCache::addAccessibleComponents (juce::Component& component, juce::Array<juce::var>& siblings)
+{
+    if (! component.isVisible())
+        return;
+
+    // Descendants of inaccessible components are inaccessible as well
+    auto handler = component.getAccessibilityHandler();
+    if (handler == nullptr)
+        return;
+
+    // Ignored components are collapsed, their accessible descendants become children of their accessible ancestor
+    if (handler->isIgnored())
+    {
+        for (auto child : component.getChildren())
+            addAccessibleComponents (*child, siblings);
+
+        return;
+    }
+
+    const auto role = handler->getRole();
+
+    accessibleComponents.push_back (&component);
+    componentsByRole [static_cast<int> (role)].push_back (&component);
+
+    juce::DynamicObject::Ptr node = new juce::DynamicObject;
+    node->setProperty ("role", roleToString (role));
+
+    if (const auto componentID = component.getComponentID(); componentID.isNotEmpty())
+        node->setProperty ("id", componentID);
+
+    juce::Array<juce::var> children;
+    for (auto child : component.getChildren())
+        addAccessibleComponents (*child, children);
+
+    if (! children.isEmpty())
+        node->setProperty ("children", children);
+
+    snapshotNodes.push_back ({ &component, node });
+    siblings.add (node.get());
+}
+
+} // namespace straw
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_ComponentTracker.h"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A cache of the accessibility tree JUCE maintains for the components on the desktop, for semantic lookups.
+ *
+ * Components are looked up by their accessibility role, title and value, the same properties screen readers use, so tests
+ * don't depend on component IDs. The accessible components are cached by role, and the accessibility tree, where components
+ * ignored by accessibility are collapsed into their accessible descendants, is cached as well.
+ *
+ * JUCE doesn't expose its accessibility notifications, so the cache is invalidated by the notifications of the components
+ * instead, which are the ones causing structural changes of the accessibility tree. Titles, values and states change without
+ * any structural change, they are always read from the accessibility handlers, for the cached candidates only.
+ *
+ * The cache is built on the first query, and must be used from the message thread.
+ */
+class AccessibilityCache
+    : public juce::DeletedAtShutdown
+    , private ComponentTracker
+{
+public:
+    /**
+     * @brief The properties to look up components by, empty properties match any component.
+     */
+    struct Query
+    {
+        std::optional<juce::AccessibilityRole> role;
+        juce::String title;
+        juce::String value;
+    };
+
+    /**
+     * @brief Destructor for the AccessibilityCache class.
+     */
+    ~AccessibilityCache() override;
+
+    /**
+     * @brief Find the accessible components matching a query, comparing titles and values ignoring the case.
+     *
+     * @param query The properties to look up.
+     * @param maxResults The maximum number of components to return.
+     *
+     * @return The matching components, in the order of the accessibility tree.
+     */
+    [[nodiscard]] juce::Array<juce::Component*> findComponents (const Query& query, int maxResults = 100);
+
+    /**
+     * @brief Get a compact snapshot of the accessibility tree of all the windows.
+     *
+     * Each node has the `role` of the component, and only when set, its `id`, `title`, `value`, `state` flags and `children`.
+     *
+     * @return The array of windows.
+     */
+    [[nodiscard]] juce::var getSnapshot();
+
+    /**
+     * @brief Get the name of an accessibility role, like `button` or `slider`.
+     */
+    [[nodiscard]] static juce::String roleToString (juce::AccessibilityRole role);
+
+    /**
+     * @brief Parse the name of an accessibility role.
+     */
+    [[nodiscard]] static std::optional<juce::AccessibilityRole> roleFromString (juce::StringRef name);
+
+    /**
+     * @brief Get the value of an accessible component, from its value interface or else its text interface.
+     */
+    [[nodiscard]] static juce::String getAccessibleValue (const juce::AccessibilityHandler& handler);
+
+    JUCE_DECLARE_SINGLETON (AccessibilityCache, false)
+
+private:
+    AccessibilityCache() = default;
+
+    struct SnapshotNode
+    {
+        juce::Component* component = nullptr;
+        juce::DynamicObject::Ptr object;
+    };
+
+    void componentUntracked (juce::Component& component, bool isBeingDeleted) override;
+    void componentsChanged (const std::unordered_set<juce::Component*>& components) override;
+
+    void rebuild();
+    void addAccessibleComponents (juce::Component& component, juce::Array<juce::var>& siblings);
+
+    std::vector<juce::Component*> accessibleComponents;
+    std::unordered_map<int, std::vector<juce::Component*>> componentsByRole;
+    std::vector<SnapshotNode> snapshotNodes;
+    juce::Array<juce::var> snapshotWindows;
+    bool isCacheValid = false;
+};
+
+} // namespace straw
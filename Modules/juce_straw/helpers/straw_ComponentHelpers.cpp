@@ -21,6 +21,9 @@
 
 #include "straw_ComponentHelpers.h"
 
+#include "../diagnostics/straw_SessionTracer.h"
+#include "../input/straw_InputInjector.h"
+#include "../time/straw_VirtualClock.h"
 #include "../values/straw_VariantConverter.h"
 
 namespace straw::Helpers {
@@ -50,6 +53,8 @@ juce::Component* findComponentById (juce::Component* component, juce::StringRef
 
 juce::Component* findComponentById (juce::StringRef id)
 {
+    ScopedTraceSpan span ("helpers", "findComponentById");
+
     for (int i = 0; i < juce::Desktop::getInstance().getNumComponents(); ++i)
     {
         auto component = findComponentById (juce::Desktop::getInstance().getComponent (i), id);
@@ -90,6 +95,8 @@ juce::Array<juce::Component*> findComponentsByType (juce::Component* component,
 
 juce::Array<juce::Component*> findComponentsByType (juce::StringRef typeName)
 {
+    ScopedTraceSpan span ("helpers", "findComponentsByType");
+
     juce::Array<juce::Component*> result;
 
     for (int i = 0; i < juce::Desktop::getInstance().getNumComponents(); ++i)
@@ -105,6 +112,8 @@ juce::Array<juce::Component*> findComponentsByType (juce::StringRef typeName)
 
 juce::var makeComponentInfo (juce::Component* component, bool recursive)
 {
+    ScopedTraceSpan span ("helpers", "makeComponentInfo");
+
     juce::DynamicObject::Ptr object = new juce::DynamicObject;
 
     if (component != nullptr)
@@ -160,6 +169,8 @@ juce::Image renderComponentToImage (juce::Component* component, bool withChildre
     jassert (component->getWidth() > 0);
     jassert (component->getHeight() > 0);
 
+    ScopedTraceSpan span ("helpers", "renderComponentToImage");
+
     auto image = juce::Image (juce::Image::ARGB, component->getWidth(), component->getHeight(), true);
 
     juce::Graphics graphics (image);
@@ -182,61 +193,58 @@ void clickComponent (juce::Component* component,
     jassert (component != nullptr);
     jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
 
-    auto mouseDownTime = juce::Time::getCurrentTime();
-    auto mouseDownPos = component->getScreenBounds().getCentre().toFloat();
+    ScopedTraceSpan span ("helpers", "clickComponent");
+
+    auto mouseDownTime = VirtualClock::getInstance()->getMillisecondCounterHiRes();
 
-    juce::MouseEvent ev1
+    InputEvent event;
+    event.type = InputEvent::Type::mouseDown;
+    event.position = component->getLocalBounds().toFloat().getCentre();
+    event.modifiers = modifiersKeys;
+
+    auto injector = std::make_shared<InputInjector>();
+    injector->inject (*component, event);
+
+    auto mouseUpCallback = [safeComponent = juce::Component::SafePointer<juce::Component> (component),
+                            injector,
+                            event,
+                            finishCallback = std::move (finishCallback)]() mutable
     {
-        juce::Desktop::getInstance().getMainMouseSource(),
-        mouseDownPos,
-        modifiersKeys,
-        1.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        component,
-        component,
-        mouseDownTime,
-        mouseDownPos,
-        mouseDownTime,
-        1,
-        false
-    };
+        if (auto targetComponent = safeComponent.getComponent())
+        {
+            event.type = InputEvent::Type::mouseUp;
+            injector->inject (*targetComponent, event);
+        }
 
-    component->mouseDown (ev1);
+        // A component closing its own window on mouse down is gone by now, the source must be released regardless
+        injector->releaseAllSources();
 
-    auto elapsedMouseDownTime = juce::Time::getCurrentTime() - mouseDownTime;
+        if (finishCallback != nullptr)
+            finishCallback();
+    };
+
+    auto elapsedMouseDownTime = VirtualClock::getInstance()->getMillisecondCounterHiRes() - mouseDownTime;
 
-    int clickTimeMilliseconds = juce::jmax(0, static_cast<int> (timeBetweenMouseDownAndUp.inMilliseconds() - elapsedMouseDownTime.inMilliseconds()));
+    int clickTimeMilliseconds = juce::jmax (0, static_cast<int> (timeBetweenMouseDownAndUp.inMilliseconds() - static_cast<juce::int64> (elapsedMouseDownTime)));
     if (clickTimeMilliseconds > 0)
-        juce::MessageManager::getInstance()->runDispatchLoopUntil(clickTimeMilliseconds);
+        callAfterDelay (clickTimeMilliseconds, std::move (mouseUpCallback));
+    else
+        juce::MessageManager::callAsync (std::move (mouseUpCallback));
+}
 
-    juce::MouseEvent ev2
-    {
-        juce::Desktop::getInstance().getMainMouseSource(),
-        mouseDownPos,
-        modifiersKeys,
-        1.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        component,
-        component,
-        juce::Time::getCurrentTime(),
-        mouseDownPos,
-        mouseDownTime,
-        1,
-        false
-    };
+void clickComponentAndWait (juce::Component* component,
+                            const juce::ModifierKeys& modifiersKeys,
+                            juce::RelativeTime timeBetweenMouseDownAndUp)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
 
-    component->mouseUp (ev2);
+    ScopedTraceSpan span ("helpers", "clickComponentAndWait");
 
-    if (finishCallback != nullptr)
-        finishCallback();
+    auto finished = std::make_shared<bool> (false);
 
-    juce::MessageManager::getInstance()->runDispatchLoopUntil(1);
+    clickComponent (component, modifiersKeys, [finished] { *finished = true; }, timeBetweenMouseDownAndUp);
+
+    VirtualClock::getInstance()->dispatchUntil ([finished] { return *finished; });
 }
 
 //=================================================================================================
@@ -249,6 +257,8 @@ juce::var invokeComponentCustomMethod (juce::Component* component,
     if (component == nullptr)
         return juce::var();
 
+    ScopedTraceSpan span ("helpers", "invokeComponentCustomMethod");
+
     auto method = component->getProperties().getVarPointer (juce::String (methodName));
     if (method == nullptr)
         return errorCallback ? errorCallback("Method to invoke not found in object") : void(), juce::var();
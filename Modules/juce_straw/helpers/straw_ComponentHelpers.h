@@ -98,6 +98,11 @@ juce::Image renderComponentToImage (juce::Component* component, bool withChildre
  * This function simulates a mouse click event on a component. It allows you to specify modifier keys, a callback to
  * execute after the click, and the time delay between mouse down and up events.
  *
+ * The click is delivered at the centre of the component through the `InputInjector`, the same path used by gestures.
+ * The mouse down is delivered immediately, while the mouse up and the finish callback are scheduled with a timer, so the
+ * message thread is never blocked for the duration of the press and multiple clicks can overlap. The finish callback is
+ * invoked even if the component is deleted before the mouse up.
+ *
  * @param component The component to click.
  * @param modifiersKeys The modifier keys to hold while clicking.
  * @param finishCallback A callback function to execute after the click.
@@ -108,6 +113,21 @@ void clickComponent (juce::Component* component,
                      std::function<void()> finishCallback,
                      juce::RelativeTime timeBetweenMouseDownAndUp = juce::RelativeTime::milliseconds(100));
 
+/**
+ * @brief Simulate a click event on a component and wait for it to complete.
+ *
+ * This function behaves like `clickComponent`, but it doesn't return until the mouse up has been delivered, dispatching
+ * messages in the meantime. It is meant for synchronous callers like python scripts, which expect the effects of the click
+ * to be visible as soon as the call returns.
+ *
+ * @param component The component to click.
+ * @param modifiersKeys The modifier keys to hold while clicking.
+ * @param timeBetweenMouseDownAndUp The time delay between mouse down and up events.
+ */
+void clickComponentAndWait (juce::Component* component,
+                            const juce::ModifierKeys& modifiersKeys,
+                            juce::RelativeTime timeBetweenMouseDownAndUp = juce::RelativeTime::milliseconds(100));
+
 //=================================================================================================
 
 juce::var invokeComponentCustomMethod (juce::Component* component,
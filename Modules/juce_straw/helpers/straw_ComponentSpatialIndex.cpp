@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_ComponentSpatialIndex.h"
+
+#include <algorithm>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr int spatialIndexCellSize = 128;
+
+int getCellIndex (int coordinate)
+{
+    // Rounds towards negative infinity, windows on secondary displays can have negative coordinates
+    return coordinate >= 0 ? coordinate / spatialIndexCellSize : (coordinate - spatialIndexCellSize + 1) / spatialIndexCellSize;
+}
+
+juce::int64 makeCellKey (int column, int row)
+{
+    return (static_cast<juce::int64> (column) << 32) | static_cast<juce::uint32> (row);
+}
+
+std::vector<juce::Component*> getPathFromRoot (juce::Component* component)
+{
+    std::vector<juce::Component*> result;
+
+    for (; component != nullptr; component = component->getParentComponent())
+        result.push_back (component);
+
+    std::reverse (result.begin(), result.end());
+    return result;
+}
+
+bool doesReceiveClicksAt (juce::Component& component, juce::Point<int> screenPosition)
+{
+    for (auto parent = component.getParentComponent(); parent != nullptr; parent = parent->getParentComponent())
+    {
+        bool allowsClicksOnParent = false, allowsClicksOnChildren = false;
+        parent->getInterceptsMouseClicks (allowsClicksOnParent, allowsClicksOnChildren);
+
+        if (! allowsClicksOnChildren)
+            return false;
+    }
+
+    const auto localPosition = component.getLocalPoint (nullptr, screenPosition);
+    return component.hitTest (localPosition.x, localPosition.y);
+}
+
+} // namespace
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (ComponentSpatialIndex)
+
+ComponentSpatialIndex::~ComponentSpatialIndex()
+{
+    untrackAll();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+juce::Array<juce::Component*> ComponentSpatialIndex::findComponentsAt (juce::Point<int> screenPosition)
+{
+    juce::Array<juce::Component*> result;
+
+    for (auto component : getCandidatesAt (screenPosition, nullptr))
+        result.add (component);
+
+    return result;
+}
+
+juce::Component* ComponentSpatialIndex::findComponentAt (juce::Point<int> screenPosition)
+{
+    auto candidates = getCandidatesAt (screenPosition, nullptr);
+    return candidates.empty() ? nullptr : candidates.front();
+}
+
+juce::Component* ComponentSpatialIndex::findClickTargetAt (juce::Point<int> screenPosition, juce::Component* topLevelComponent)
+{
+    // Front most first, so children are hit tested before the parents they would intercept clicks for
+    for (auto component : getCandidatesAt (screenPosition, topLevelComponent))
+    {
+        if (doesReceiveClicksAt (*component, screenPosition))
+            return component;
+    }
+
+    return nullptr;
+}
+
+juce::Component* ComponentSpatialIndex::findOccludingComponent (juce::Component& component)
+{
+    auto target = findClickTargetAt (component.getScreenBounds().getCentre(), component.getTopLevelComponent());
+
+    if (target == nullptr || target == &component || component.isParentOf (target) || target->isParentOf (&component))
+        return nullptr;
+
+    return target;
+}
+
+bool ComponentSpatialIndex::isVisibleAndUnoccluded (juce::Component& component)
+{
+    return component.isShowing() && findOccludingComponent (component) == nullptr;
+}
+
+//=================================================================================================
+
+void ComponentSpatialIndex::componentTracked (juce::Component& component)
+{
+    entries.emplace (&component, Entry{});
+}
+
+void ComponentSpatialIndex::componentUntracked (juce::Component& component, bool)
+{
+    auto entry = entries.find (&component);
+    if (entry == entries.end())
+        return;
+
+    setBounds (component, entry->second, {});
+    entries.erase (entry);
+}
+
+void ComponentSpatialIndex::componentsChanged (const std::unordered_set<juce::Component*>& components)
+{
+    for (auto component : components)
+    {
+        // Updated together with the subtree of a changed ancestor
+        auto parent = component->getParentComponent();
+
+        bool hasChangedAncestor = false;
+        for (auto ancestor = parent; ancestor != nullptr && ! hasChangedAncestor; ancestor = ancestor->getParentComponent())
+            hasChangedAncestor = components.find (ancestor) != components.end();
+
+        if (hasChangedAncestor)
+            continue;
+
+        if (parent == nullptr)
+        {
+            updateBounds (*component, component->isOnDesktop() ? component->getScreenBounds() : juce::Rectangle<int>());
+        }
+        else if (auto parentEntry = entries.find (parent); parentEntry != entries.end())
+        {
+            updateBounds (*component, parentEntry->second.bounds);
+        }
+    }
+}
+
+void ComponentSpatialIndex::updateBounds (juce::Component& component, juce::Rectangle<int> clipBounds)
+{
+    auto entry = entries.find (&component);
+    if (entry == entries.end())
+        return;
+
+    // Children are clipped by their parents, hidden components hide their whole subtree
+    const auto bounds = component.isVisible() ? component.getScreenBounds().getIntersection (clipBounds) : juce::Rectangle<int>();
+
+    setBounds (component, entry->second, bounds);
+
+    for (auto child : component.getChildren())
+        updateBounds (*child, bounds);
+}
+
+void ComponentSpatialIndex::setBounds (juce::Component& component, Entry& entry, juce::Rectangle<int> bounds)
+{
+    if (bounds.isEmpty())
+        bounds = {};
+
+    if (entry.bounds == bounds)
+        return;
+
+    auto cellRange = bounds.isEmpty()
+        ? juce::Rectangle<int>()
+        : juce::Rectangle<int>::leftTopRightBottom (getCellIndex (bounds.getX()),
+                                                    getCellIndex (bounds.getY()),
+                                                    getCellIndex (bounds.getRight() - 1) + 1,
+                                                    getCellIndex (bounds.getBottom() - 1) + 1);
+
+    if (cellRange != entry.cellRange)
+    {
+        for (int column = entry.cellRange.getX(); column < entry.cellRange.getRight(); ++column)
+        {
+            for (int row = entry.cellRange.getY(); row < entry.cellRange.getBottom(); ++row)
+            {
+                auto cell = cells.find (makeCellKey (column, row));
+                if (cell == cells.end())
+                    continue;
+
+                cell->second.erase (std::remove (cell->second.begin(), cell->second.end(), &component), cell->second.end());
+
+                if (cell->second.empty())
+                    cells.erase (cell);
+            }
+        }
+
+        for (int column = cellRange.getX(); column < cellRange.getRight(); ++column)
+        {
+            for (int row = cellRange.getY(); row < cellRange.getBottom(); ++row)
+                cells [makeCellKey (column, row)].push_back (&component);
+        }
+    }
+
+    entry.bounds = bounds;
+    entry.cellRange = cellRange;
+}
+
+//=================================================================================================
+
+std::vector<juce::Component*> ComponentSpatialIndex::getCandidatesAt (juce::Point<int> screenPosition, juce::Component* topLevelComponent)
+{
+    update();
+
+    std::vector<juce::Component*> result;
+
+    auto cell = cells.find (makeCellKey (getCellIndex (screenPosition.x), getCellIndex (screenPosition.y)));
+    if (cell == cells.end())
+        return result;
+
+    for (auto component : cell->second)
+    {
+        if (! entries [component].bounds.contains (screenPosition))
+            continue;
+
+        if (topLevelComponent == nullptr || component->getTopLevelComponent() == topLevelComponent)
+            result.push_back (component);
+    }
+
+    std::sort (result.begin(), result.end(), [this] (auto* component, auto* otherComponent) { return isInFrontOf (component, otherComponent); });
+
+    return result;
+}
+
+bool ComponentSpatialIndex::isInFrontOf (juce::Component* component, juce::Component* otherComponent) const
+{
+    const auto path = getPathFromRoot (component);
+    const auto otherPath = getPathFromRoot (otherComponent);
+
+    // Windows brought to front are moved at the end of the desktop components
+    if (path.front() != otherPath.front())
+    {
+        const auto& topLevelComponents = getTopLevelComponents();
+        const auto index = std::find (topLevelComponents.begin(), topLevelComponents.end(), path.front());
+        const auto otherIndex = std::find (topLevelComponents.begin(), topLevelComponents.end(), otherPath.front());
+        return index > otherIndex;
+    }
+
+    std::size_t depth = 0;
+    while (depth < path.size() && depth < otherPath.size() && path [depth] == otherPath [depth])
+        ++depth;
+
+    if (depth == path.size())
+        return false;
+
+    if (depth == otherPath.size())
+        return true;
+
+    // Siblings are painted in order, always on top components are kept at the end
+    const auto parent = path [depth - 1];
+    return parent->getIndexOfChildComponent (path [depth]) > parent->getIndexOfChildComponent (otherPath [depth]);
+}
+
+} // namespace straw
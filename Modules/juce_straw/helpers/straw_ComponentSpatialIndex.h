@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_ComponentTracker.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A spatial index of the screen bounds of all the components on the desktop, for hit testing and occlusion queries.
+ *
+ * Components are bucketed in a uniform grid of screen cells by their visible bounds, which are their screen bounds clipped
+ * by their ancestors. Only the components moved, resized, shown, hidden or reparented since the last query are updated, so queries on dense user interfaces only look at the few components
+ * overlapping a single cell instead of walking the whole hierarchy.
+ *
+ * Components overlapping at a point are ordered front to back like they are painted: descendants above their ancestors,
+ * siblings by their z-order, and top level windows by their order on the desktop.
+ *
+ * The index is built on the first query, and must be used from the message thread.
+ */
+class ComponentSpatialIndex
+    : public juce::DeletedAtShutdown
+    , private ComponentTracker
+{
+public:
+    /**
+     * @brief Destructor for the ComponentSpatialIndex class.
+     */
+    ~ComponentSpatialIndex() override;
+
+    /**
+     * @brief Find all the showing components overlapping a point.
+     *
+     * @param screenPosition The point in screen coordinates.
+     *
+     * @return The components overlapping the point, the front most first.
+     */
+    [[nodiscard]] juce::Array<juce::Component*> findComponentsAt (juce::Point<int> screenPosition);
+
+    /**
+     * @brief Find the front most showing component overlapping a point.
+     *
+     * @param screenPosition The point in screen coordinates.
+     *
+     * @return The component, or nullptr if there's no component at that point.
+     */
+    [[nodiscard]] juce::Component* findComponentAt (juce::Point<int> screenPosition);
+
+    /**
+     * @brief Find the component that would receive a mouse click at a point, honouring hit tests and intercepted clicks.
+     *
+     * @param screenPosition The point in screen coordinates.
+     * @param topLevelComponent If not null, only components in this window are considered.
+     *
+     * @return The component receiving the click, or nullptr if no component would receive it.
+     */
+    [[nodiscard]] juce::Component* findClickTargetAt (juce::Point<int> screenPosition, juce::Component* topLevelComponent = nullptr);
+
+    /**
+     * @brief Find the component covering the centre of a component, where clicks are delivered.
+     *
+     * Components inside the component, and ancestors receiving the click because the component doesn't intercept clicks,
+     * don't cover it. Only components of the same window are considered, as windows of headless instances commonly overlap.
+     *
+     * @param component The component to check.
+     *
+     * @return The covering component, or nullptr if the component is not covered.
+     */
+    [[nodiscard]] juce::Component* findOccludingComponent (juce::Component& component);
+
+    /**
+     * @brief Check if a component is showing and not covered by another component at its centre.
+     *
+     * @param component The component to check.
+     */
+    [[nodiscard]] bool isVisibleAndUnoccluded (juce::Component& component);
+
+    using ComponentTracker::getNumTrackedComponents;
+
+    JUCE_DECLARE_SINGLETON (ComponentSpatialIndex, false)
+
+private:
+    ComponentSpatialIndex() = default;
+
+    struct Entry
+    {
+        juce::Rectangle<int> bounds;
+        juce::Rectangle<int> cellRange;
+    };
+
+    void componentTracked (juce::Component& component) override;
+    void componentUntracked (juce::Component& component, bool isBeingDeleted) override;
+    void componentsChanged (const std::unordered_set<juce::Component*>& components) override;
+
+    void updateBounds (juce::Component& component, juce::Rectangle<int> clipBounds);
+    void setBounds (juce::Component& component, Entry& entry, juce::Rectangle<int> bounds);
+
+    std::vector<juce::Component*> getCandidatesAt (juce::Point<int> screenPosition, juce::Component* topLevelComponent);
+    bool isInFrontOf (juce::Component* component, juce::Component* otherComponent) const;
+
+    std::unordered_map<juce::Component*, Entry> entries;
+    std::unordered_map<juce::int64, std::vector<juce::Component*>> cells;
+};
+
+} // namespace straw
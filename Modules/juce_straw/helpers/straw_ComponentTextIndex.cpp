@@ -0,0 +1,300 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_ComponentTextIndex.h"
+
+#include <algorithm>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr juce::juce_wchar trigramStartMarker = 0x02;
+constexpr juce::juce_wchar trigramEndMarker = 0x03;
+constexpr float minimumFuzzyScore = 0.3f;
+
+juce::StringArray getComponentTexts (juce::Component& component)
+{
+    juce::StringArray result;
+    result.add (component.getName());
+    result.add (component.getTitle());
+    result.add (component.getDescription());
+    result.add (component.getHelpText());
+
+    if (auto button = dynamic_cast<juce::Button*> (&component))
+        result.add (button->getButtonText());
+    else if (auto label = dynamic_cast<juce::Label*> (&component))
+        result.add (label->getText());
+
+    result.trim();
+    result.removeEmptyStrings();
+    result.removeDuplicates (false);
+    return result;
+}
+
+juce::String foldText (const juce::String& text)
+{
+    return text.trim().toLowerCase();
+}
+
+void addTrigrams (const juce::String& foldedText, bool isPaddedAtEnd, std::vector<juce::uint64>& trigrams)
+{
+    std::vector<juce::juce_wchar> characters { trigramStartMarker };
+
+    for (auto text = foldedText.getCharPointer(); ! text.isEmpty();)
+        characters.push_back (text.getAndAdvance());
+
+    if (isPaddedAtEnd)
+        characters.push_back (trigramEndMarker);
+
+    // Code points fit in 21 bits, so three of them are packed in a single key
+    for (std::size_t index = 0; index + 2 < characters.size(); ++index)
+    {
+        trigrams.push_back ((static_cast<juce::uint64> (characters [index] & 0x1fffff) << 42)
+                            | (static_cast<juce::uint64> (characters [index + 1] & 0x1fffff) << 21)
+                            | static_cast<juce::uint64> (characters [index + 2] & 0x1fffff));
+    }
+}
+
+std::vector<juce::uint64> makeTrigrams (const juce::String& foldedText, bool isPaddedAtEnd)
+{
+    std::vector<juce::uint64> trigrams;
+    addTrigrams (foldedText, isPaddedAtEnd, trigrams);
+
+    std::sort (trigrams.begin(), trigrams.end());
+    trigrams.erase (std::unique (trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+float getTrigramSimilarity (const std::vector<juce::uint64>& trigrams, const std::vector<juce::uint64>& otherTrigrams)
+{
+    if (trigrams.empty() || otherTrigrams.empty())
+        return 0.0f;
+
+    std::size_t numShared = 0;
+    for (auto it = trigrams.begin(), otherIt = otherTrigrams.begin(); it != trigrams.end() && otherIt != otherTrigrams.end();)
+    {
+        if (*it < *otherIt)
+            ++it;
+        else if (*otherIt < *it)
+            ++otherIt;
+        else
+            ++numShared, ++it, ++otherIt;
+    }
+
+    return static_cast<float> (2 * numShared) / static_cast<float> (trigrams.size() + otherTrigrams.size());
+}
+
+} // namespace
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (ComponentTextIndex)
+
+ComponentTextIndex::~ComponentTextIndex()
+{
+    untrackAll();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+std::vector<ComponentTextIndex::Match> ComponentTextIndex::findComponentsByText (const juce::String& text, MatchMode mode, int maxResults)
+{
+    // Buttons repaint without notifying when their text changes
+    for (const auto& [component, entry] : entries)
+    {
+        if (entry.isButton && static_cast<juce::Button*> (component)->getButtonText() != entry.buttonText)
+            invalidate (*component);
+    }
+
+    update();
+
+    std::vector<Match> result;
+
+    const auto foldedText = foldText (text);
+    if (foldedText.isEmpty() || maxResults <= 0)
+        return result;
+
+    const auto queryTrigrams = makeTrigrams (foldedText, mode != MatchMode::prefix);
+
+    // Components sharing trigrams with the searched text, single character prefixes have none and look at all components
+    std::unordered_map<juce::Component*, std::size_t> candidates;
+
+    if (queryTrigrams.empty())
+    {
+        for (const auto& entry : entries)
+            candidates [entry.first] = 0;
+    }
+    else
+    {
+        for (auto trigram : queryTrigrams)
+        {
+            if (auto posting = postings.find (trigram); posting != postings.end())
+            {
+                for (auto component : posting->second)
+                    ++candidates [component];
+            }
+        }
+    }
+
+    for (const auto& [component, numSharedTrigrams] : candidates)
+    {
+        // Exact and prefix matches contain all the trigrams of the searched text
+        if (mode != MatchMode::fuzzy && numSharedTrigrams < queryTrigrams.size())
+            continue;
+
+        const auto& entry = entries [component];
+
+        Match bestMatch;
+
+        for (int index = 0; index < entry.foldedTexts.size(); ++index)
+        {
+            const auto& foldedComponentText = entry.foldedTexts [index];
+
+            float score = 0.0f;
+            switch (mode)
+            {
+                case MatchMode::exact: score = foldedComponentText == foldedText ? 1.0f : 0.0f; break;
+                case MatchMode::prefix: score = foldedComponentText.startsWith (foldedText) ? 1.0f : 0.0f; break;
+                case MatchMode::fuzzy: score = getTrigramSimilarity (makeTrigrams (foldedComponentText, true), queryTrigrams); break;
+                default: break;
+            }
+
+            if (score > bestMatch.score)
+                bestMatch = { component, entry.texts [index], score };
+        }
+
+        if (bestMatch.component != nullptr && (mode != MatchMode::fuzzy || bestMatch.score >= minimumFuzzyScore))
+            result.push_back (std::move (bestMatch));
+    }
+
+    std::sort (result.begin(), result.end(), [] (const Match& match, const Match& otherMatch)
+    {
+        if (match.score != otherMatch.score)
+            return match.score > otherMatch.score;
+
+        return match.text.length() < otherMatch.text.length();
+    });
+
+    if (result.size() > static_cast<std::size_t> (maxResults))
+        result.resize (static_cast<std::size_t> (maxResults));
+
+    return result;
+}
+
+std::optional<ComponentTextIndex::MatchMode> ComponentTextIndex::matchModeFromString (juce::StringRef name)
+{
+    if (name == juce::StringRef ("exact"))
+        return MatchMode::exact;
+
+    if (name == juce::StringRef ("prefix"))
+        return MatchMode::prefix;
+
+    if (name == juce::StringRef ("fuzzy"))
+        return MatchMode::fuzzy;
+
+    return std::nullopt;
+}
+
+//=================================================================================================
+
+void ComponentTextIndex::componentTracked (juce::Component& component)
+{
+    auto& entry = entries [&component];
+    entry.isButton = dynamic_cast<juce::Button*> (&component) != nullptr;
+
+    if (auto label = dynamic_cast<juce::Label*> (&component))
+        label->addListener (this);
+}
+
+void ComponentTextIndex::componentUntracked (juce::Component& component, bool isBeingDeleted)
+{
+    auto entry = entries.find (&component);
+    if (entry == entries.end())
+        return;
+
+    removePostings (component, entry->second);
+    entries.erase (entry);
+
+    // The listeners of a label being deleted are already destroyed
+    if (! isBeingDeleted)
+    {
+        if (auto label = dynamic_cast<juce::Label*> (&component))
+            label->removeListener (this);
+    }
+}
+
+void ComponentTextIndex::componentsChanged (const std::unordered_set<juce::Component*>& components)
+{
+    for (auto component : components)
+        reindex (*component, entries [component]);
+}
+
+void ComponentTextIndex::labelTextChanged (juce::Label* label)
+{
+    invalidate (*label);
+}
+
+//=================================================================================================
+
+void ComponentTextIndex::reindex (juce::Component& component, Entry& entry)
+{
+    removePostings (component, entry);
+
+    entry.texts = getComponentTexts (component);
+    entry.foldedTexts.clearQuick();
+    entry.trigrams.clear();
+
+    for (const auto& text : entry.texts)
+    {
+        entry.foldedTexts.add (foldText (text));
+        addTrigrams (entry.foldedTexts.strings.getLast(), true, entry.trigrams);
+    }
+
+    if (entry.isButton)
+        entry.buttonText = static_cast<juce::Button&> (component).getButtonText();
+
+    std::sort (entry.trigrams.begin(), entry.trigrams.end());
+    entry.trigrams.erase (std::unique (entry.trigrams.begin(), entry.trigrams.end()), entry.trigrams.end());
+
+    for (auto trigram : entry.trigrams)
+        postings [trigram].push_back (&component);
+}
+
+void ComponentTextIndex::removePostings (juce::Component& component, const Entry& entry)
+{
+    for (auto trigram : entry.trigrams)
+    {
+        auto posting = postings.find (trigram);
+        if (posting == postings.end())
+            continue;
+
+        posting->second.erase (std::remove (posting->second.begin(), posting->second.end(), &component), posting->second.end());
+
+        if (posting->second.empty())
+            postings.erase (posting);
+    }
+}
+
+} // namespace straw
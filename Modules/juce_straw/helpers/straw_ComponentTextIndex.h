@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_ComponentTracker.h"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A full text index of the texts shown by the components on the desktop, to find components by what users read.
+ *
+ * Each component is indexed by its name, title, description, help text, and the text of buttons and labels. Texts are
+ * case folded and split into trigrams, padded at both ends, and an inverted index maps each trigram to the components
+ * containing it, so a search only looks at the components sharing trigrams with the searched text.
+ *
+ * The index listens to component names and hierarchies and to label texts, and compares the texts of the buttons on each
+ * search, as buttons don't notify text changes. Titles, descriptions and help texts don't notify changes either: they are
+ * indexed again when the component is moved, resized, shown, hidden or reparented, or explicitly invalidated.
+ *
+ * The index is built on the first search, and must be used from the message thread.
+ */
+class ComponentTextIndex
+    : public juce::DeletedAtShutdown
+    , private ComponentTracker
+    , private juce::Label::Listener
+{
+public:
+    /**
+     * @brief How the searched text is matched against the component texts, always ignoring the case.
+     */
+    enum class MatchMode
+    {
+        exact,      ///< A component text equals the searched text.
+        prefix,     ///< A component text starts with the searched text.
+        fuzzy       ///< A component text shares most of its trigrams with the searched text, ranked by similarity.
+    };
+
+    /**
+     * @brief A component matching a search.
+     */
+    struct Match
+    {
+        juce::Component* component = nullptr;
+        juce::String text;
+        float score = 0.0f;
+    };
+
+    /**
+     * @brief Destructor for the ComponentTextIndex class.
+     */
+    ~ComponentTextIndex() override;
+
+    /**
+     * @brief Find the components showing a text.
+     *
+     * @param text The text to search.
+     * @param mode How the text is matched.
+     * @param maxResults The maximum number of matches to return.
+     *
+     * @return The matching components, the best matches first.
+     */
+    [[nodiscard]] std::vector<Match> findComponentsByText (const juce::String& text, MatchMode mode = MatchMode::exact, int maxResults = 100);
+
+    /**
+     * @brief Index the texts of a component again, after changing texts that don't notify their changes.
+     */
+    using ComponentTracker::invalidate;
+
+    /**
+     * @brief Parse a match mode name, like `exact`, `prefix` or `fuzzy`.
+     */
+    [[nodiscard]] static std::optional<MatchMode> matchModeFromString (juce::StringRef name);
+
+    JUCE_DECLARE_SINGLETON (ComponentTextIndex, false)
+
+private:
+    ComponentTextIndex() = default;
+
+    struct Entry
+    {
+        juce::StringArray texts;
+        juce::StringArray foldedTexts;
+        juce::String buttonText;
+        std::vector<juce::uint64> trigrams;
+        bool isButton = false;
+    };
+
+    void componentTracked (juce::Component& component) override;
+    void componentUntracked (juce::Component& component, bool isBeingDeleted) override;
+    void componentsChanged (const std::unordered_set<juce::Component*>& components) override;
+    void labelTextChanged (juce::Label* label) override;
+
+    void reindex (juce::Component& component, Entry& entry);
+    void removePostings (juce::Component& component, const Entry& entry);
+
+    std::unordered_map<juce::Component*, Entry> entries;
+    std::unordered_map<juce::uint64, std::vector<juce::Component*>> postings;
+};
+
+} // namespace straw
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_ComponentTracker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace straw {
+
+//=================================================================================================
+
+ComponentTracker::~ComponentTracker()
+{
+    // Derived classes are already destroyed, they must untrack the components while they can still be notified
+    jassert (trackedComponents.empty());
+}
+
+//=================================================================================================
+
+void ComponentTracker::invalidate (juce::Component& component)
+{
+    if (isTracked (&component))
+        changedComponents.insert (&component);
+}
+
+int ComponentTracker::getNumTrackedComponents() const
+{
+    return static_cast<int> (trackedComponents.size());
+}
+
+//=================================================================================================
+
+void ComponentTracker::update()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    auto& desktop = juce::Desktop::getInstance();
+
+    std::vector<juce::Component*> currentTopLevelComponents;
+    for (int index = 0; index < desktop.getNumComponents(); ++index)
+        currentTopLevelComponents.push_back (desktop.getComponent (index));
+
+    for (auto topLevelComponent : topLevelComponents)
+    {
+        const bool isStillOnDesktop = std::find (currentTopLevelComponents.begin(), currentTopLevelComponents.end(), topLevelComponent) != currentTopLevelComponents.end();
+
+        // Windows deleted since the last update are already untracked, don't touch them
+        if (! isStillOnDesktop && isTracked (topLevelComponent) && topLevelComponent->getParentComponent() == nullptr)
+            untrack (*topLevelComponent, false);
+    }
+
+    topLevelComponents = std::move (currentTopLevelComponents);
+
+    for (auto topLevelComponent : topLevelComponents)
+        track (*topLevelComponent);
+
+    if (changedComponents.empty())
+        return;
+
+    componentsChanged (std::exchange (changedComponents, {}));
+}
+
+void ComponentTracker::untrackAll()
+{
+    while (! trackedComponents.empty())
+    {
+        // Untracking a component also untracks its subtree
+        auto component = *trackedComponents.begin();
+
+        while (isTracked (component->getParentComponent()))
+            component = component->getParentComponent();
+
+        untrack (*component, false);
+    }
+
+    topLevelComponents.clear();
+}
+
+bool ComponentTracker::isTracked (juce::Component* component) const
+{
+    return component != nullptr && trackedComponents.find (component) != trackedComponents.end();
+}
+
+const std::vector<juce::Component*>& ComponentTracker::getTopLevelComponents() const
+{
+    return topLevelComponents;
+}
+
+void ComponentTracker::componentTracked (juce::Component&)
+{
+}
+
+void ComponentTracker::componentUntracked (juce::Component&, bool)
+{
+}
+
+//=================================================================================================
+
+void ComponentTracker::componentMovedOrResized (juce::Component& component, bool, bool)
+{
+    invalidate (component);
+}
+
+void ComponentTracker::componentVisibilityChanged (juce::Component& component)
+{
+    invalidate (component);
+}
+
+void ComponentTracker::componentNameChanged (juce::Component& component)
+{
+    invalidate (component);
+}
+
+void ComponentTracker::componentChildrenChanged (juce::Component& component)
+{
+    // Removed children are untracked when notified of their new hierarchy
+    for (auto child : component.getChildren())
+        track (*child);
+}
+
+void ComponentTracker::componentParentHierarchyChanged (juce::Component& component)
+{
+    auto topLevelComponent = component.getTopLevelComponent();
+
+    if (topLevelComponent->isOnDesktop() && isTracked (topLevelComponent))
+        invalidate (component);
+    else
+        untrack (component, false);
+}
+
+void ComponentTracker::componentBeingDeleted (juce::Component& component)
+{
+    untrack (component, true);
+}
+
+//=================================================================================================
+
+void ComponentTracker::track (juce::Component& component)
+{
+    if (! trackedComponents.insert (&component).second)
+        return;
+
+    component.addComponentListener (this);
+    changedComponents.insert (&component);
+
+    componentTracked (component);
+
+    for (auto child : component.getChildren())
+        track (*child);
+}
+
+void ComponentTracker::untrack (juce::Component& component, bool isBeingDeleted)
+{
+    if (trackedComponents.erase (&component) == 0)
+        return;
+
+    component.removeComponentListener (this);
+    changedComponents.erase (&component);
+
+    componentUntracked (component, isBeingDeleted);
+
+    // Children of a deleted component are still alive, they are only detached from it
+    for (auto child : component.getChildren())
+        untrack (*child, false);
+}
+
+} // namespace straw
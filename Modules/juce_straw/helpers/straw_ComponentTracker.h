@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Tracks all the components on the desktop, for indexes kept up to date incrementally.
+ *
+ * The tracker listens to every component of every desktop window, tracking components as they are added and untracking
+ * them as they are removed or deleted. Components moved, resized, shown, hidden, renamed or reparented are marked as
+ * changed, and handed over to the derived class in batch on the next update, so bursts of notifications, like a window
+ * being laid out, are only processed once and only when the index is queried.
+ *
+ * Windows added to or removed from the desktop don't notify their listeners, so the desktop is checked on every update.
+ * Must be used from the message thread.
+ */
+class ComponentTracker : private juce::ComponentListener
+{
+public:
+    /**
+     * @brief Constructor for the ComponentTracker class.
+     */
+    ComponentTracker() = default;
+
+    /**
+     * @brief Destructor for the ComponentTracker class.
+     *
+     * Derived classes must call `untrackAll` in their destructor.
+     */
+    ~ComponentTracker() override;
+
+    /**
+     * @brief Mark a component as changed, after changing properties that don't notify their changes.
+     *
+     * @param component The changed component.
+     */
+    void invalidate (juce::Component& component);
+
+    /**
+     * @brief Get the number of tracked components.
+     */
+    [[nodiscard]] int getNumTrackedComponents() const;
+
+protected:
+    /**
+     * @brief Track the windows on the desktop, and hand over the components changed since the last update.
+     */
+    void update();
+
+    /**
+     * @brief Untrack all the components.
+     */
+    void untrackAll();
+
+    /**
+     * @brief Check if a component is tracked.
+     */
+    [[nodiscard]] bool isTracked (juce::Component* component) const;
+
+    /**
+     * @brief Get the windows on the desktop, in their desktop order, as of the last update.
+     */
+    [[nodiscard]] const std::vector<juce::Component*>& getTopLevelComponents() const;
+
+    /**
+     * @brief Invoked when a component starts being tracked, it's also handed over as changed on the next update.
+     */
+    virtual void componentTracked (juce::Component& component);
+
+    /**
+     * @brief Invoked when a component stops being tracked.
+     *
+     * @param component The untracked component.
+     * @param isBeingDeleted True if the component is being deleted, only its `juce::Component` part is still alive.
+     */
+    virtual void componentUntracked (juce::Component& component, bool isBeingDeleted);
+
+    /**
+     * @brief Invoked on update with the components tracked or changed since the last update.
+     */
+    virtual void componentsChanged (const std::unordered_set<juce::Component*>& components) = 0;
+
+private:
+    void componentMovedOrResized (juce::Component& component, bool wasMoved, bool wasResized) override;
+    void componentVisibilityChanged (juce::Component& component) override;
+    void componentNameChanged (juce::Component& component) override;
+    void componentChildrenChanged (juce::Component& component) override;
+    void componentParentHierarchyChanged (juce::Component& component) override;
+    void componentBeingDeleted (juce::Component& component) override;
+
+    void track (juce::Component& component);
+    void untrack (juce::Component& component, bool isBeingDeleted);
+
+    std::unordered_set<juce::Component*> trackedComponents;
+    std::unordered_set<juce::Component*> changedComponents;
+    std::vector<juce::Component*> topLevelComponents;
+
+    JUCE_DECLARE_NON_COPYABLE (ComponentTracker)
+};
+
+} // namespace straw
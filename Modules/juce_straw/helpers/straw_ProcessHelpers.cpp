@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_ProcessHelpers.h"
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#pragma comment (lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace straw::Helpers {
+
+//=================================================================================================
+
+juce::int32 getCurrentProcessId()
+{
+#if JUCE_WINDOWS
+    return static_cast<juce::int32> (GetCurrentProcessId());
+#else
+    return static_cast<juce::int32> (::getpid());
+#endif
+}
+
+juce::int64 getPeakResidentMemorySize()
+{
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (! GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)))
+        return 0;
+
+    return static_cast<juce::int64> (counters.PeakWorkingSetSize);
+#else
+    struct rusage usage {};
+    if (::getrusage (RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+   #if JUCE_MAC || JUCE_IOS
+    return static_cast<juce::int64> (usage.ru_maxrss); // Already in bytes
+   #else
+    return static_cast<juce::int64> (usage.ru_maxrss) * 1024;
+   #endif
+#endif
+}
+
+} // namespace straw::Helpers
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace straw::Helpers {
+
+//=================================================================================================
+
+/**
+ * @brief Get the identifier of the current process.
+ *
+ * @return The process identifier.
+ */
+juce::int32 getCurrentProcessId();
+
+/**
+ * @brief Get the peak resident set size of the current process.
+ *
+ * @return The peak resident memory in bytes, or zero if not available on the platform.
+ */
+juce::int64 getPeakResidentMemorySize();
+
+} // namespace straw::Helpers
@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Gesture.h"
+
+#include "../helpers/straw_ComponentHelpers.h"
+#include "../values/straw_VariantConverter.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+juce::ModifierKeys parseModifiers (const juce::var& value)
+{
+    if (value.isInt() || value.isInt64())
+        return juce::ModifierKeys (static_cast<int> (value));
+
+    int flags = juce::ModifierKeys::noModifiers;
+
+    if (auto modifiers = value.getArray())
+    {
+        for (const auto& modifier : *modifiers)
+        {
+            auto name = modifier.toString().trim().toLowerCase();
+
+            if (name == "shift")
+                flags |= juce::ModifierKeys::shiftModifier;
+            else if (name == "ctrl" || name == "control")
+                flags |= juce::ModifierKeys::ctrlModifier;
+            else if (name == "alt" || name == "option")
+                flags |= juce::ModifierKeys::altModifier;
+            else if (name == "cmd" || name == "command")
+                flags |= juce::ModifierKeys::commandModifier;
+            else if (name == "right")
+                flags |= juce::ModifierKeys::rightButtonModifier;
+            else if (name == "middle")
+                flags |= juce::ModifierKeys::middleButtonModifier;
+        }
+    }
+
+    return juce::ModifierKeys (flags);
+}
+
+//=================================================================================================
+
+InputEvent makeEvent (const juce::var& description, InputEvent::Type type)
+{
+    InputEvent event;
+    event.type = type;
+    event.timestamp = static_cast<double> (description.getProperty ("t", 0.0));
+    event.componentID = description.getProperty ("id", "").toString().trim();
+    event.position = { static_cast<float> (description.getProperty ("x", 0.0)),
+                       static_cast<float> (description.getProperty ("y", 0.0)) };
+    event.relativePosition = static_cast<bool> (description.getProperty ("relative", false));
+    event.modifiers = parseModifiers (description.getProperty ("modifiers", juce::var()));
+    event.pressure = static_cast<float> (description.getProperty ("pressure", juce::MouseInputSource::defaultPressure));
+
+    if (description.hasProperty ("touch"))
+    {
+        event.sourceType = juce::MouseInputSource::InputSourceType::touch;
+        event.touchIndex = static_cast<int> (description.getProperty ("touch", 0));
+    }
+    else if (description.getProperty ("source", "").toString() == "pen")
+    {
+        event.sourceType = juce::MouseInputSource::InputSourceType::pen;
+    }
+
+    return event;
+}
+
+//=================================================================================================
+
+void addDragEvents (const juce::var& description, std::vector<InputEvent>& events)
+{
+    auto from = fromVar<juce::Point<float>> (description.getProperty ("from", juce::var()));
+    auto to = fromVar<juce::Point<float>> (description.getProperty ("to", juce::var()));
+    auto duration = juce::jmax (0.0, static_cast<double> (description.getProperty ("duration", 250.0)));
+    auto rate = juce::jmax (1.0, static_cast<double> (description.getProperty ("rate", 120.0)));
+    auto numSteps = juce::jmax (1, juce::roundToInt (duration * rate / 1000.0));
+
+    auto event = makeEvent (description, InputEvent::Type::mouseDown);
+    auto startTime = event.timestamp;
+
+    event.position = from;
+    events.push_back (event);
+
+    event.type = InputEvent::Type::mouseDrag;
+    for (int step = 1; step <= numSteps; ++step)
+    {
+        auto proportion = static_cast<float> (step) / static_cast<float> (numSteps);
+
+        event.timestamp = startTime + duration * proportion;
+        event.position = from + (to - from) * proportion;
+        events.push_back (event);
+    }
+
+    event.type = InputEvent::Type::mouseUp;
+    event.timestamp = startTime + duration;
+    event.position = to;
+    events.push_back (event);
+}
+
+//=================================================================================================
+
+juce::Result addEvents (const juce::var& description, std::vector<InputEvent>& events)
+{
+    if (! description.isObject())
+        return juce::Result::fail ("gesture event is not an object");
+
+    auto type = description.getProperty ("type", "").toString().trim().toLowerCase();
+
+    if (type == "move")
+    {
+        events.push_back (makeEvent (description, InputEvent::Type::mouseMove));
+    }
+    else if (type == "down")
+    {
+        events.push_back (makeEvent (description, InputEvent::Type::mouseDown));
+    }
+    else if (type == "up")
+    {
+        events.push_back (makeEvent (description, InputEvent::Type::mouseUp));
+    }
+    else if (type == "drag")
+    {
+        if (description.hasProperty ("from") && description.hasProperty ("to"))
+            addDragEvents (description, events);
+        else
+            events.push_back (makeEvent (description, InputEvent::Type::mouseDrag));
+    }
+    else if (type == "click")
+    {
+        auto event = makeEvent (description, InputEvent::Type::mouseDown);
+        events.push_back (event);
+
+        event.type = InputEvent::Type::mouseUp;
+        event.timestamp += juce::jmax (0.0, static_cast<double> (description.getProperty ("duration", 100.0)));
+        events.push_back (event);
+    }
+    else if (type == "wheel")
+    {
+        auto event = makeEvent (description, InputEvent::Type::mouseWheel);
+        event.wheel.deltaX = static_cast<float> (description.getProperty ("deltaX", 0.0));
+        event.wheel.deltaY = static_cast<float> (description.getProperty ("deltaY", 0.0));
+        event.wheel.isReversed = static_cast<bool> (description.getProperty ("reversed", false));
+        event.wheel.isSmooth = static_cast<bool> (description.getProperty ("smooth", false));
+        event.wheel.isInertial = false;
+        events.push_back (event);
+    }
+    else if (type == "key")
+    {
+        auto event = makeEvent (description, InputEvent::Type::keyPress);
+        event.key = juce::KeyPress::createFromDescription (description.getProperty ("key", "").toString());
+        if (! event.key.isValid())
+            return juce::Result::fail ("invalid key in gesture event: " + description.getProperty ("key", "").toString());
+
+        events.push_back (event);
+    }
+    else if (type == "text")
+    {
+        auto event = makeEvent (description, InputEvent::Type::keyPress);
+        auto text = description.getProperty ("text", "").toString();
+        auto interval = juce::jmax (0.0, static_cast<double> (description.getProperty ("interval", 0.0)));
+
+        for (auto character = text.getCharPointer(); ! character.isEmpty(); ++character)
+        {
+            event.key = juce::KeyPress (static_cast<int> (*character), event.modifiers, *character);
+            events.push_back (event);
+
+            event.timestamp += interval;
+        }
+    }
+    else
+    {
+        return juce::Result::fail ("unknown gesture event type: " + type);
+    }
+
+    return juce::Result::ok();
+}
+
+//=================================================================================================
+
+// Owns the players still playing, so they're deleted before the message manager at shutdown
+class ActiveGesturePlayers : public juce::DeletedAtShutdown
+{
+public:
+    ~ActiveGesturePlayers() override
+    {
+        players.clear();
+
+        clearSingletonInstance();
+    }
+
+    juce::OwnedArray<GesturePlayer> players;
+
+    JUCE_DECLARE_SINGLETON (ActiveGesturePlayers, false)
+};
+
+JUCE_IMPLEMENT_SINGLETON (ActiveGesturePlayers)
+
+} // namespace
+
+//=================================================================================================
+
+juce::Result Gesture::fromVar (const juce::var& description, Gesture& gesture)
+{
+    gesture = {};
+    gesture.componentID = description.getProperty ("id", "").toString().trim();
+
+    auto events = description.getProperty ("events", juce::var());
+    if (! events.isArray())
+        return juce::Result::fail ("missing events array in gesture");
+
+    for (const auto& event : *events.getArray())
+    {
+        auto result = addEvents (event, gesture.events);
+        if (result.failed())
+            return result;
+    }
+
+    std::stable_sort (gesture.events.begin(), gesture.events.end(), [](const auto& a, const auto& b)
+    {
+        return a.timestamp < b.timestamp;
+    });
+
+    return juce::Result::ok();
+}
+
+double Gesture::getDuration() const
+{
+    return events.empty() ? 0.0 : events.back().timestamp;
+}
+
+Gesture Gesture::withSpeed (double speed) const
+{
+    jassert (speed > 0.0);
+
+    Gesture result (*this);
+
+    for (auto& event : result.events)
+        event.timestamp /= speed;
+
+    return result;
+}
+
+//=================================================================================================
+
+GesturePlayer::GesturePlayer (Gesture gestureToPlay, FinishCallback callback)
+    : gesture (std::move (gestureToPlay))
+    , finishCallback (std::move (callback))
+    , startTime (VirtualClock::getInstance()->getMillisecondCounterHiRes())
+{
+}
+
+//=================================================================================================
+
+void GesturePlayer::play (Gesture gesture, FinishCallback finishCallback)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    auto player = ActiveGesturePlayers::getInstance()->players.add (new GesturePlayer (std::move (gesture), std::move (finishCallback)));
+
+    if (! player->dispatchPendingEvents())
+        player->startTimer (1);
+}
+
+juce::Result GesturePlayer::playAndWait (Gesture gesture)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    auto result = std::make_shared<std::optional<juce::Result>>();
+
+    play (std::move (gesture), [result] (juce::Result playbackResult) { *result = std::move (playbackResult); });
+
+    VirtualClock::getInstance()->dispatchUntil ([result] { return result->has_value(); });
+
+    return **result;
+}
+
+//=================================================================================================
+
+void GesturePlayer::timerCallback()
+{
+    dispatchPendingEvents();
+}
+
+bool GesturePlayer::dispatchPendingEvents()
+{
+    auto elapsedTime = VirtualClock::getInstance()->getMillisecondCounterHiRes() - startTime;
+
+    while (nextEvent < gesture.events.size() && gesture.events [nextEvent].timestamp <= elapsedTime)
+    {
+        const auto& event = gesture.events [nextEvent++];
+
+        auto target = findTarget (event);
+        if (target == nullptr)
+        {
+            finish (juce::Result::fail ("component id not found: " + (event.componentID.isNotEmpty() ? event.componentID : gesture.componentID)));
+            return true;
+        }
+
+        injector.inject (*target, event);
+    }
+
+    if (nextEvent < gesture.events.size())
+        return false;
+
+    finish (juce::Result::ok());
+    return true;
+}
+
+juce::Component* GesturePlayer::findTarget (const InputEvent& event)
+{
+    const auto& componentID = event.componentID.isNotEmpty() ? event.componentID : gesture.componentID;
+    if (componentID.isEmpty())
+        return nullptr;
+
+    auto& target = targets [componentID];
+    if (target == nullptr)
+        target = Helpers::findComponentById (componentID);
+
+    return target.getComponent();
+}
+
+void GesturePlayer::finish (juce::Result result)
+{
+    stopTimer();
+
+    // A gesture failing midway must not leave its buttons pressed
+    injector.releaseAllSources();
+
+    auto callback = std::move (finishCallback);
+
+    if (auto activePlayers = ActiveGesturePlayers::getInstanceWithoutCreating())
+        activePlayers->players.removeObject (this);
+
+    if (callback != nullptr)
+        callback (std::move (result));
+}
+
+} // namespace straw
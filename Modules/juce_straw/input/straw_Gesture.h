@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_InputInjector.h"
+#include "../time/straw_VirtualClock.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A timeline of synthetic input events.
+ *
+ * A gesture is compiled once from its description and can then be played back any number of times. The description is an
+ * object with an optional default target `id` and an `events` array, each entry having a `type` and a timestamp `t` in
+ * milliseconds:
+ *
+ * - `move`, `down`, `drag`, `up`: a single mouse or touch event at `x`, `y`.
+ * - `click`: a mouse down at `x`, `y` followed by a mouse up after `duration` milliseconds.
+ * - `drag` with `from` and `to`: a full press, drag and release, sampled at `rate` events per second over `duration`.
+ * - `wheel`: a wheel event at `x`, `y` with `deltaX` and `deltaY`.
+ * - `key`: a key press described by `key` (for example "ctrl + a" or "return").
+ * - `text`: a key press for each character of `text`, spaced by `interval` milliseconds.
+ *
+ * Every event accepts an `id` overriding the default target, `modifiers` (an array of "shift", "ctrl", "alt", "cmd"),
+ * `relative` to express positions as proportions of the target size, `pressure` and `touch` to use a touch source with the
+ * given index, which allows multi-touch sequences.
+ */
+struct Gesture
+{
+    /**
+     * @brief Compile a gesture from its description.
+     *
+     * @param description The description of the gesture.
+     * @param gesture The gesture to fill with the compiled events.
+     *
+     * @return A juce::Result indicating the success or failure of the compilation.
+     */
+    [[nodiscard]] static juce::Result fromVar (const juce::var& description, Gesture& gesture);
+
+    /**
+     * @brief Get the duration of the gesture in milliseconds.
+     */
+    [[nodiscard]] double getDuration() const;
+
+    /**
+     * @brief Make a copy of the gesture played back at a different speed.
+     *
+     * @param speed The speed factor, for example 10 to play the gesture ten times faster.
+     *
+     * @return The gesture with the timestamps of all the events scaled accordingly.
+     */
+    [[nodiscard]] Gesture withSpeed (double speed) const;
+
+    juce::String componentID;
+    std::vector<InputEvent> events;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Plays back a gesture on the message thread.
+ *
+ * The player wakes up with a high rate timer and delivers all the events that are due since the start of the playback, in
+ * order, so high rate event streams are delivered faithfully even when the timer resolution is coarser than the stream.
+ * Playback follows the `VirtualClock`, so recorded gestures can be fast forwarded in virtual time mode.
+ */
+class GesturePlayer : private WarpableTimer
+{
+public:
+    /**
+     * @brief Callback type invoked when a playback finishes.
+     *
+     * @param result The outcome of the playback, failing when a target component could not be found.
+     */
+    using FinishCallback = std::function<void (juce::Result)>;
+
+    /**
+     * @brief Start the playback of a gesture.
+     *
+     * The playback is asynchronous, multiple gestures can be played back at the same time. Players still playing at shutdown
+     * are deleted with the other singletons of the module, releasing the sources they pressed. Must be called from the
+     * message thread.
+     *
+     * @param gesture The gesture to play.
+     * @param finishCallback The callback to invoke when the playback finishes.
+     */
+    static void play (Gesture gesture, FinishCallback finishCallback);
+
+    /**
+     * @brief Play a gesture and wait for it to complete.
+     *
+     * This dispatches messages while waiting, it is meant for synchronous callers like python scripts.
+     *
+     * @param gesture The gesture to play.
+     *
+     * @return The outcome of the playback.
+     */
+    [[nodiscard]] static juce::Result playAndWait (Gesture gesture);
+
+private:
+    GesturePlayer (Gesture gesture, FinishCallback finishCallback);
+
+    void timerCallback() override;
+
+    bool dispatchPendingEvents();
+    juce::Component* findTarget (const InputEvent& event);
+    void finish (juce::Result result);
+
+    Gesture gesture;
+    FinishCallback finishCallback;
+    InputInjector injector;
+    std::unordered_map<juce::String, juce::Component::SafePointer<juce::Component>> targets;
+    std::size_t nextEvent = 0;
+    double startTime = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GesturePlayer)
+};
+
+} // namespace straw
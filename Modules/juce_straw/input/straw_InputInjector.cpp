@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_InputInjector.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+bool isMouseButtonEvent (InputEvent::Type type)
+{
+    return type == InputEvent::Type::mouseDown || type == InputEvent::Type::mouseDrag;
+}
+
+juce::ModifierKeys makeEventModifiers (const InputEvent& event)
+{
+    if (isMouseButtonEvent (event.type))
+    {
+        if (event.modifiers.isAnyMouseButtonDown())
+            return event.modifiers;
+
+        return event.modifiers.withFlags (juce::ModifierKeys::leftButtonModifier);
+    }
+
+    return event.modifiers.withoutMouseButtons();
+}
+
+juce::MouseInputSource getMouseInputSource (const InputEvent& event)
+{
+    auto& desktop = juce::Desktop::getInstance();
+
+    for (const auto& source : desktop.getMouseSources())
+    {
+        if (source.getType() == event.sourceType && source.getIndex() == event.touchIndex)
+            return source;
+    }
+
+    return desktop.getMainMouseSource();
+}
+
+} // namespace
+
+//=================================================================================================
+
+InputInjector::~InputInjector()
+{
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        releaseAllSources();
+}
+
+//=================================================================================================
+
+juce::Point<float> InputInjector::getLocalPosition (const juce::Component& target, const InputEvent& event)
+{
+    if (! event.relativePosition)
+        return event.position;
+
+    return { event.position.x * static_cast<float> (target.getWidth()),
+             event.position.y * static_cast<float> (target.getHeight()) };
+}
+
+//=================================================================================================
+
+void InputInjector::inject (juce::Component& target, const InputEvent& event)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (auto peer = target.getPeer())
+        injectThroughPeer (*peer, target, event);
+    else
+        injectDirectly (target, event);
+}
+
+//=================================================================================================
+
+void InputInjector::injectThroughPeer (juce::ComponentPeer& peer, juce::Component& target, const InputEvent& event)
+{
+    auto time = juce::Time::currentTimeMillis();
+    auto peerPosition = peer.getComponent().getLocalPoint (&target, getLocalPosition (target, event));
+
+    if (event.type == InputEvent::Type::keyPress)
+    {
+        if (target.getWantsKeyboardFocus() && ! target.hasKeyboardFocus (true))
+            target.grabKeyboardFocus();
+
+        juce::ModifierKeys::currentModifiers = event.key.getModifiers().withoutMouseButtons();
+        peer.handleKeyPress (event.key.getKeyCode(), event.key.getTextCharacter());
+        return;
+    }
+
+    if (event.type == InputEvent::Type::mouseWheel)
+    {
+        peer.handleMouseWheel (event.sourceType, peerPosition, time, event.wheel, event.touchIndex);
+        return;
+    }
+
+    auto modifiers = makeEventModifiers (event);
+    juce::ModifierKeys::currentModifiers = modifiers;
+
+    const auto sourceKey = std::make_pair (static_cast<int> (event.sourceType), event.touchIndex);
+
+    if (isMouseButtonEvent (event.type))
+        pressedSources [sourceKey] = { &peer, peer.localToGlobal (peerPosition), event.sourceType, event.touchIndex };
+    else if (event.type == InputEvent::Type::mouseUp)
+        pressedSources.erase (sourceKey);
+
+    peer.handleMouseEvent (event.sourceType,
+                           peerPosition,
+                           modifiers,
+                           event.pressure,
+                           juce::MouseInputSource::defaultOrientation,
+                           time,
+                           {},
+                           event.touchIndex);
+}
+
+//=================================================================================================
+
+void InputInjector::releaseAllSources()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    for (const auto& [sourceKey, pressedSource] : std::exchange (pressedSources, {}))
+    {
+        // Any peer can release the source when the window it was pressed on has been deleted
+        auto peer = juce::ComponentPeer::isValidPeer (pressedSource.peer) ? pressedSource.peer : nullptr;
+        if (peer == nullptr && juce::ComponentPeer::getNumPeers() > 0)
+            peer = juce::ComponentPeer::getPeer (0);
+
+        if (peer == nullptr)
+            continue;
+
+        auto modifiers = juce::ModifierKeys::currentModifiers.withoutMouseButtons();
+        juce::ModifierKeys::currentModifiers = modifiers;
+
+        peer->handleMouseEvent (pressedSource.sourceType,
+                                peer->globalToLocal (pressedSource.screenPosition),
+                                modifiers,
+                                juce::MouseInputSource::defaultPressure,
+                                juce::MouseInputSource::defaultOrientation,
+                                juce::Time::currentTimeMillis(),
+                                {},
+                                pressedSource.touchIndex);
+    }
+
+    for (const auto& [touchIndex, state] : std::exchange (sources, {}))
+    {
+        if (auto component = state.mouseDownComponent.getComponent())
+        {
+            InputEvent event;
+            event.type = InputEvent::Type::mouseUp;
+            event.touchIndex = touchIndex;
+            event.position = state.mouseDownPosition;
+
+            injectDirectly (*component, event);
+        }
+    }
+
+    sources.clear();
+}
+
+//=================================================================================================
+
+void InputInjector::injectDirectly (juce::Component& target, const InputEvent& event)
+{
+    if (event.type == InputEvent::Type::keyPress)
+    {
+        for (auto component = &target; component != nullptr; component = component->getParentComponent())
+        {
+            if (component->keyPressed (event.key))
+                break;
+        }
+
+        return;
+    }
+
+    auto eventTime = juce::Time::getCurrentTime();
+    auto position = getLocalPosition (target, event);
+
+    auto& state = sources [event.touchIndex];
+    if (event.type == InputEvent::Type::mouseDown)
+    {
+        state.mouseDownComponent = &target;
+        state.mouseDownPosition = position;
+        state.mouseDownTime = eventTime;
+    }
+
+    auto mouseDownPosition = state.mouseDownComponent != nullptr ? state.mouseDownPosition : position;
+    auto mouseDownTime = state.mouseDownComponent != nullptr ? state.mouseDownTime : eventTime;
+
+    juce::MouseEvent mouseEvent
+    {
+        getMouseInputSource (event),
+        position,
+        makeEventModifiers (event),
+        event.pressure,
+        juce::MouseInputSource::defaultOrientation,
+        juce::MouseInputSource::defaultRotation,
+        juce::MouseInputSource::defaultTiltX,
+        juce::MouseInputSource::defaultTiltY,
+        &target,
+        &target,
+        eventTime,
+        mouseDownPosition,
+        mouseDownTime,
+        1,
+        position != mouseDownPosition && event.type != InputEvent::Type::mouseDown
+    };
+
+    switch (event.type)
+    {
+        case InputEvent::Type::mouseMove:   target.mouseMove (mouseEvent); break;
+        case InputEvent::Type::mouseDown:   target.mouseDown (mouseEvent); break;
+        case InputEvent::Type::mouseDrag:   target.mouseDrag (mouseEvent); break;
+        case InputEvent::Type::mouseWheel:  target.mouseWheelMove (mouseEvent, event.wheel); break;
+        case InputEvent::Type::mouseUp:     target.mouseUp (mouseEvent); state = {}; break;
+        case InputEvent::Type::keyPress:    break;
+    }
+}
+
+} // namespace straw
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <map>
+#include <utility>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A single synthetic input event.
+ *
+ * Input events are the unit of work of the input injection path: clicks, gestures and replayed sessions are all expressed as
+ * sequences of them. Positions are expressed relative to the target component.
+ */
+struct InputEvent
+{
+    enum class Type
+    {
+        mouseMove,
+        mouseDown,
+        mouseDrag,
+        mouseUp,
+        mouseWheel,
+        keyPress
+    };
+
+    Type type = Type::mouseMove;
+    juce::MouseInputSource::InputSourceType sourceType = juce::MouseInputSource::InputSourceType::mouse;
+    int touchIndex = 0;
+
+    double timestamp = 0.0; // milliseconds from the start of the sequence
+    juce::String componentID; // overrides the default target of the sequence when not empty
+
+    juce::Point<float> position;
+    bool relativePosition = false; // when true, position is a proportion of the target component size
+    juce::ModifierKeys modifiers;
+    float pressure = juce::MouseInputSource::defaultPressure;
+
+    juce::MouseWheelDetails wheel {};
+    juce::KeyPress key;
+};
+
+//=================================================================================================
+
+/**
+ * @brief Delivers synthetic input events to components.
+ *
+ * When the target component is attached to a peer, events are injected through the peer exactly like native events are, so
+ * hit-testing, mouse enter/exit, drags, multi-touch sources and keyboard focus behave as with real input. Components without a
+ * peer get the mouse and key callbacks invoked directly.
+ *
+ * An injector keeps track of the mouse down state of each input source, so a sequence of events belonging to the same gesture
+ * must be injected through the same instance. All methods must be called from the message thread.
+ */
+class InputInjector
+{
+public:
+    /**
+     * @brief Constructor for the InputInjector class.
+     */
+    InputInjector() = default;
+
+    /**
+     * @brief Destructor for the InputInjector class, releases the sources still pressed.
+     */
+    ~InputInjector();
+
+    /**
+     * @brief Inject an event into a component.
+     *
+     * @param target The component the event position is relative to.
+     * @param event The event to inject.
+     */
+    void inject (juce::Component& target, const InputEvent& event);
+
+    /**
+     * @brief Resolve the position of an event in the target component coordinate space.
+     *
+     * @param target The component the event position is relative to.
+     * @param event The event to resolve the position of.
+     *
+     * @return The position local to the target component.
+     */
+    static juce::Point<float> getLocalPosition (const juce::Component& target, const InputEvent& event);
+
+    /**
+     * @brief Release every input source pressed by this injector and not released yet.
+     *
+     * Sources pressed through a peer are released at the position they were pressed, through the same peer or any other
+     * one when it's gone, so the mouse input sources never stay in the button down state after the target component or its
+     * window is deleted. Components pressed directly get their mouse up callback if they still exist.
+     */
+    void releaseAllSources();
+
+private:
+    struct SourceState
+    {
+        juce::Component::SafePointer<juce::Component> mouseDownComponent;
+        juce::Point<float> mouseDownPosition;
+        juce::Time mouseDownTime;
+    };
+
+    struct PressedSource
+    {
+        juce::ComponentPeer* peer = nullptr;
+        juce::Point<float> screenPosition;
+        juce::MouseInputSource::InputSourceType sourceType = juce::MouseInputSource::InputSourceType::mouse;
+        int touchIndex = 0;
+    };
+
+    void injectThroughPeer (juce::ComponentPeer& peer, juce::Component& target, const InputEvent& event);
+    void injectDirectly (juce::Component& target, const InputEvent& event);
+
+    std::map<int, SourceState> sources;
+    std::map<std::pair<int, int>, PressedSource> pressedSources;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InputInjector)
+};
+
+} // namespace straw
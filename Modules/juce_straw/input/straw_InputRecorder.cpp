@@ -0,0 +1,344 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_InputRecorder.h"
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr juce::int32 recordingMagic = 0x57525453; // STRW
+constexpr juce::int32 recordingVersion = 1;
+
+// A key press without modifiers: the type byte and five single byte compressed ints
+constexpr int minEncodedEventSize = 6;
+
+//=================================================================================================
+
+juce::Component* findIdentifiedComponent (juce::Component* component)
+{
+    while (component != nullptr && component->getComponentID().isEmpty())
+        component = component->getParentComponent();
+
+    return component;
+}
+
+} // namespace
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (InputRecorder)
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void InputRecorder::start()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    stop();
+
+    recordedGesture = {};
+    numDroppedEvents = 0;
+    startTime = juce::Time::getMillisecondCounterHiRes();
+    recording = true;
+
+    auto& desktop = juce::Desktop::getInstance();
+    desktop.addGlobalMouseListener (this);
+    desktop.addFocusChangeListener (this);
+
+    listenToKeysOf (juce::Component::getCurrentlyFocusedComponent());
+}
+
+Gesture InputRecorder::stop()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (! recording)
+        return recordedGesture;
+
+    recording = false;
+
+    auto& desktop = juce::Desktop::getInstance();
+    desktop.removeGlobalMouseListener (this);
+    desktop.removeFocusChangeListener (this);
+
+    listenToKeysOf (nullptr);
+
+    if (! recordedGesture.events.empty())
+    {
+        auto firstTimestamp = recordedGesture.events.front().timestamp;
+
+        for (auto& event : recordedGesture.events)
+            event.timestamp -= firstTimestamp;
+    }
+
+    return recordedGesture;
+}
+
+bool InputRecorder::isRecording() const
+{
+    return recording;
+}
+
+int InputRecorder::getNumDroppedEvents() const
+{
+    return numDroppedEvents;
+}
+
+//=================================================================================================
+
+void InputRecorder::mouseMove (const juce::MouseEvent& event)
+{
+    recordMouseEvent (event, InputEvent::Type::mouseMove);
+}
+
+void InputRecorder::mouseDown (const juce::MouseEvent& event)
+{
+    recordMouseEvent (event, InputEvent::Type::mouseDown);
+}
+
+void InputRecorder::mouseDrag (const juce::MouseEvent& event)
+{
+    recordMouseEvent (event, InputEvent::Type::mouseDrag);
+}
+
+void InputRecorder::mouseUp (const juce::MouseEvent& event)
+{
+    recordMouseEvent (event, InputEvent::Type::mouseUp);
+}
+
+void InputRecorder::mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
+{
+    recordMouseEvent (event, InputEvent::Type::mouseWheel, wheel);
+}
+
+void InputRecorder::globalFocusChanged (juce::Component* focusedComponent)
+{
+    listenToKeysOf (focusedComponent);
+}
+
+void InputRecorder::listenToKeysOf (juce::Component* component)
+{
+    // Key listeners of a component are called before the component itself, so keys consumed by the focused component are
+    // recorded too, while listeners of its parents would only see the keys nobody consumed
+    if (keyListenedComponent.getComponent() == component)
+        return;
+
+    if (keyListenedComponent != nullptr)
+        keyListenedComponent->removeKeyListener (this);
+
+    keyListenedComponent = component;
+
+    if (component != nullptr)
+        component->addKeyListener (this);
+}
+
+bool InputRecorder::keyPressed (const juce::KeyPress& key, juce::Component* originatingComponent)
+{
+    if (! recording)
+        return false;
+
+    auto component = findIdentifiedComponent (originatingComponent);
+    if (component == nullptr)
+    {
+        ++numDroppedEvents;
+        return false;
+    }
+
+    InputEvent inputEvent;
+    inputEvent.type = InputEvent::Type::keyPress;
+    inputEvent.timestamp = juce::Time::getMillisecondCounterHiRes() - startTime;
+    inputEvent.componentID = component->getComponentID();
+    inputEvent.modifiers = key.getModifiers();
+    inputEvent.key = key;
+
+    recordedGesture.events.push_back (std::move (inputEvent));
+
+    return false;
+}
+
+void InputRecorder::recordMouseEvent (const juce::MouseEvent& event, InputEvent::Type type, const juce::MouseWheelDetails& wheel)
+{
+    if (! recording)
+        return;
+
+    auto component = findIdentifiedComponent (event.eventComponent);
+    if (component == nullptr)
+    {
+        ++numDroppedEvents;
+        return;
+    }
+
+    InputEvent inputEvent;
+    inputEvent.type = type;
+    inputEvent.sourceType = event.source.getType();
+    inputEvent.touchIndex = event.source.getIndex();
+    inputEvent.timestamp = juce::Time::getMillisecondCounterHiRes() - startTime;
+    inputEvent.componentID = component->getComponentID();
+    inputEvent.position = event.getEventRelativeTo (component).position;
+    inputEvent.modifiers = event.mods;
+    inputEvent.pressure = event.pressure;
+    inputEvent.wheel = wheel;
+
+    recordedGesture.events.push_back (std::move (inputEvent));
+}
+
+//=================================================================================================
+
+juce::MemoryBlock InputRecorder::toBinary (const Gesture& gesture)
+{
+    juce::StringArray componentIDs;
+    for (const auto& event : gesture.events)
+        componentIDs.addIfNotAlreadyThere (event.componentID);
+
+    juce::MemoryBlock data;
+    juce::MemoryOutputStream output (data, false);
+
+    output.writeInt (recordingMagic);
+    output.writeByte (static_cast<char> (recordingVersion));
+    output.writeString (gesture.componentID);
+
+    output.writeCompressedInt (componentIDs.size());
+    for (const auto& componentID : componentIDs)
+        output.writeString (componentID);
+
+    output.writeCompressedInt (static_cast<int> (gesture.events.size()));
+
+    double lastTimestamp = 0.0;
+    for (const auto& event : gesture.events)
+    {
+        output.writeByte (static_cast<char> ((static_cast<int> (event.sourceType) << 4) | static_cast<int> (event.type)));
+        output.writeCompressedInt (juce::roundToInt ((event.timestamp - lastTimestamp) * 1000.0));
+        output.writeCompressedInt (componentIDs.indexOf (event.componentID));
+        output.writeCompressedInt (event.modifiers.getRawFlags());
+
+        lastTimestamp = event.timestamp;
+
+        if (event.type == InputEvent::Type::keyPress)
+        {
+            output.writeCompressedInt (event.key.getKeyCode());
+            output.writeCompressedInt (static_cast<int> (event.key.getTextCharacter()));
+            continue;
+        }
+
+        output.writeCompressedInt (event.touchIndex);
+        output.writeFloat (event.position.x);
+        output.writeFloat (event.position.y);
+        output.writeFloat (event.pressure);
+
+        if (event.type == InputEvent::Type::mouseWheel)
+        {
+            output.writeFloat (event.wheel.deltaX);
+            output.writeFloat (event.wheel.deltaY);
+            output.writeByte (static_cast<char> ((event.wheel.isReversed ? 1 : 0)
+                                               | (event.wheel.isSmooth ? 2 : 0)
+                                               | (event.wheel.isInertial ? 4 : 0)));
+        }
+    }
+
+    output.flush();
+    return data;
+}
+
+juce::Result InputRecorder::fromBinary (const juce::MemoryBlock& data, Gesture& gesture)
+{
+    gesture = {};
+
+    juce::MemoryInputStream input (data, false);
+
+    if (input.readInt() != recordingMagic)
+        return juce::Result::fail ("invalid input recording");
+
+    if (input.readByte() != static_cast<char> (recordingVersion))
+        return juce::Result::fail ("unsupported input recording version");
+
+    gesture.componentID = input.readString();
+
+    juce::StringArray componentIDs;
+    for (int i = input.readCompressedInt(); i > 0 && ! input.isExhausted(); --i)
+        componentIDs.add (input.readString());
+
+    const auto numEvents = input.readCompressedInt();
+    if (numEvents < 0 || numEvents > input.getNumBytesRemaining() / minEncodedEventSize)
+        return juce::Result::fail ("corrupted input recording");
+
+    gesture.events.reserve (static_cast<std::size_t> (numEvents));
+
+    double timestamp = 0.0;
+    for (int i = 0; i < numEvents; ++i)
+    {
+        if (input.isExhausted())
+            return juce::Result::fail ("truncated input recording");
+
+        const auto typeAndSource = static_cast<int> (static_cast<juce::uint8> (input.readByte()));
+        if ((typeAndSource & 0x0f) > static_cast<int> (InputEvent::Type::keyPress))
+            return juce::Result::fail ("corrupted input recording");
+
+        InputEvent event;
+        event.type = static_cast<InputEvent::Type> (typeAndSource & 0x0f);
+        event.sourceType = static_cast<juce::MouseInputSource::InputSourceType> (typeAndSource >> 4);
+
+        timestamp += input.readCompressedInt() / 1000.0;
+        event.timestamp = timestamp;
+        event.componentID = componentIDs [input.readCompressedInt()];
+        event.modifiers = juce::ModifierKeys (input.readCompressedInt());
+
+        if (event.type == InputEvent::Type::keyPress)
+        {
+            auto keyCode = input.readCompressedInt();
+            auto textCharacter = static_cast<juce::juce_wchar> (input.readCompressedInt());
+
+            event.key = juce::KeyPress (keyCode, event.modifiers, textCharacter);
+        }
+        else
+        {
+            event.touchIndex = input.readCompressedInt();
+            event.position.x = input.readFloat();
+            event.position.y = input.readFloat();
+            event.pressure = input.readFloat();
+
+            if (event.type == InputEvent::Type::mouseWheel)
+            {
+                event.wheel.deltaX = input.readFloat();
+                event.wheel.deltaY = input.readFloat();
+
+                const auto flags = input.readByte();
+                event.wheel.isReversed = (flags & 1) != 0;
+                event.wheel.isSmooth = (flags & 2) != 0;
+                event.wheel.isInertial = (flags & 4) != 0;
+            }
+        }
+
+        gesture.events.push_back (std::move (event));
+    }
+
+    return juce::Result::ok();
+}
+
+} // namespace straw
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "straw_Gesture.h"
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Records real user input into a gesture that can be replayed later.
+ *
+ * The recorder listens to all mouse events through a global mouse listener, and to key presses through a key listener following
+ * the keyboard focus, so keys consumed by the focused component and keys typed in windows opened later are recorded too.
+ * Each event is stored relative to the nearest component (or ancestor) having a component ID, so a recording can be replayed
+ * on windows with different positions or sizes. Events on components without any identified ancestor are dropped.
+ *
+ * Recordings are serialised into a compact binary log, and replayed through the `GesturePlayer`, which uses the same
+ * injection path as `Helpers::clickComponent`.
+ */
+class InputRecorder
+    : public juce::DeletedAtShutdown
+    , private juce::MouseListener
+    , private juce::KeyListener
+    , private juce::FocusChangeListener
+{
+public:
+    /**
+     * @brief Destructor for the InputRecorder class.
+     */
+    ~InputRecorder() override;
+
+    /**
+     * @brief Start recording, discarding any previous recording.
+     */
+    void start();
+
+    /**
+     * @brief Stop recording.
+     *
+     * @return The recorded gesture, with timestamps rebased to the first recorded event.
+     */
+    Gesture stop();
+
+    /**
+     * @brief Check if the recorder is currently recording.
+     */
+    [[nodiscard]] bool isRecording() const;
+
+    /**
+     * @brief Get the number of events dropped because they couldn't be resolved to a component ID.
+     */
+    [[nodiscard]] int getNumDroppedEvents() const;
+
+    /**
+     * @brief Serialise a gesture into the compact binary log format.
+     *
+     * @param gesture The gesture to serialise.
+     *
+     * @return The binary log.
+     */
+    [[nodiscard]] static juce::MemoryBlock toBinary (const Gesture& gesture);
+
+    /**
+     * @brief Deserialise a gesture from the compact binary log format.
+     *
+     * @param data The binary log.
+     * @param gesture The gesture to fill with the deserialised events.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    [[nodiscard]] static juce::Result fromBinary (const juce::MemoryBlock& data, Gesture& gesture);
+
+    JUCE_DECLARE_SINGLETON (InputRecorder, false)
+
+private:
+    InputRecorder() = default;
+
+    void mouseMove (const juce::MouseEvent& event) override;
+    void mouseDown (const juce::MouseEvent& event) override;
+    void mouseDrag (const juce::MouseEvent& event) override;
+    void mouseUp (const juce::MouseEvent& event) override;
+    void mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+    bool keyPressed (const juce::KeyPress& key, juce::Component* originatingComponent) override;
+    void globalFocusChanged (juce::Component* focusedComponent) override;
+
+    void listenToKeysOf (juce::Component* component);
+
+    void recordMouseEvent (const juce::MouseEvent& event, InputEvent::Type type, const juce::MouseWheelDetails& wheel = {});
+
+    Gesture recordedGesture;
+    juce::Component::SafePointer<juce::Component> keyListenedComponent;
+    double startTime = 0.0;
+    bool recording = false;
+    int numDroppedEvents = 0;
+};
+
+} // namespace straw
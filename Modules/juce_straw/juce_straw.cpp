@@ -21,8 +21,40 @@
 
 #include <juce_straw/juce_straw.h>
 
+#include "diagnostics/straw_Metrics.cpp"
+#include "diagnostics/straw_ChromeTraceWriter.cpp"
+#include "diagnostics/straw_MessageThreadTracer.cpp"
+#include "diagnostics/straw_SessionTracer.cpp"
+#include "diagnostics/straw_AsyncLogger.cpp"
+#include "diagnostics/straw_PaintProfiler.cpp"
+#include "time/straw_VirtualClock.cpp"
+#include "state/straw_StateSnapshots.cpp"
+#include "server/straw_Connection.cpp"
+#include "server/straw_UnixSocket.cpp"
+#include "server/straw_SharedMemoryRing.cpp"
+#include "server/straw_Http.cpp"
+#include "server/straw_Router.cpp"
 #include "server/straw_AutomationServer.cpp"
 #include "scripting/straw_ScriptBindings.cpp"
+#include "headless/straw_Headless.cpp"
 #include "helpers/straw_ComponentHelpers.cpp"
+#include "helpers/straw_ProcessHelpers.cpp"
+#include "helpers/straw_ComponentTracker.cpp"
+#include "helpers/straw_ComponentSpatialIndex.cpp"
+#include "helpers/straw_ComponentTextIndex.cpp"
+#include "helpers/straw_AccessibilityCache.cpp"
+#include "diagnostics/straw_FrameMonitor.cpp"
+#include "diagnostics/straw_MemoryTracker.cpp"
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+ #include "audio/straw_AudioTap.cpp"
+ #include "audio/straw_AudioAnalysis.cpp"
+#endif
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+ #include "audio/straw_OfflineRenderer.cpp"
+#endif
+#include "input/straw_InputInjector.cpp"
+#include "input/straw_Gesture.cpp"
+#include "input/straw_InputRecorder.cpp"
 #include "endpoints/straw_ComponentEndpoints.cpp"
+#include "values/straw_WireFormat.cpp"
 #include "center/straw_TestCenter.cpp"
@@ -38,10 +38,65 @@
  END_JUCE_MODULE_DECLARATION
 */
 
+//=================================================================================================
+/** Config: STRAW_ENABLE_ALLOCATION_TRACKING
+    Replaces the global operator new and delete to count the allocations, the allocated bytes and the peak of the live
+    bytes, reported by the memory endpoints. Meant for test builds, as every allocation pays for the accounting.
+*/
+#ifndef STRAW_ENABLE_ALLOCATION_TRACKING
+ #define STRAW_ENABLE_ALLOCATION_TRACKING 0
+#endif
+
 #include <juce_python/juce_python.h>
 
+#if JUCE_MODULE_AVAILABLE_juce_audio_devices && JUCE_MODULE_AVAILABLE_juce_dsp
+ #define STRAW_AUDIO_ANALYSIS_AVAILABLE 1
+#else
+ #define STRAW_AUDIO_ANALYSIS_AVAILABLE 0
+#endif
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors && JUCE_MODULE_AVAILABLE_juce_audio_formats
+ #define STRAW_OFFLINE_RENDERING_AVAILABLE 1
+#else
+ #define STRAW_OFFLINE_RENDERING_AVAILABLE 0
+#endif
+
+#include "diagnostics/straw_Metrics.h"
+#include "diagnostics/straw_EventRing.h"
+#include "diagnostics/straw_ChromeTraceWriter.h"
+#include "diagnostics/straw_MessageThreadTracer.h"
+#include "diagnostics/straw_SessionTracer.h"
+#include "diagnostics/straw_MpscQueue.h"
+#include "diagnostics/straw_AsyncLogger.h"
+#include "diagnostics/straw_PaintProfiler.h"
+#include "time/straw_VirtualClock.h"
+#include "state/straw_StateSnapshots.h"
+#include "server/straw_Connection.h"
+#include "server/straw_UnixSocket.h"
+#include "server/straw_SharedMemoryRing.h"
 #include "server/straw_Request.h"
+#include "server/straw_Http.h"
+#include "server/straw_Router.h"
 #include "server/straw_AutomationServer.h"
+#include "headless/straw_Headless.h"
 #include "helpers/straw_ComponentHelpers.h"
+#include "helpers/straw_ProcessHelpers.h"
+#include "helpers/straw_ComponentTracker.h"
+#include "helpers/straw_ComponentSpatialIndex.h"
+#include "helpers/straw_ComponentTextIndex.h"
+#include "helpers/straw_AccessibilityCache.h"
+#include "diagnostics/straw_FrameMonitor.h"
+#include "diagnostics/straw_MemoryTracker.h"
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+ #include "audio/straw_AudioTap.h"
+ #include "audio/straw_AudioAnalysis.h"
+#endif
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+ #include "audio/straw_OfflineRenderer.h"
+#endif
+#include "input/straw_InputInjector.h"
+#include "input/straw_Gesture.h"
+#include "input/straw_InputRecorder.h"
 #include "values/straw_VariantConverter.h"
+#include "values/straw_WireFormat.h"
 #include "center/straw_TestCenter.h"
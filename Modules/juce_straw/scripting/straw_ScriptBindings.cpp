@@ -22,7 +22,28 @@
 #include <juce_python/juce_python.h>
 
 #include "../values/straw_VariantConverter.h"
+#include "../diagnostics/straw_AsyncLogger.h"
+#include "../diagnostics/straw_FrameMonitor.h"
+#include "../diagnostics/straw_MemoryTracker.h"
+#include "../diagnostics/straw_PaintProfiler.h"
+#include "../diagnostics/straw_SessionTracer.h"
+#include "../helpers/straw_AccessibilityCache.h"
 #include "../helpers/straw_ComponentHelpers.h"
+#include "../helpers/straw_ComponentSpatialIndex.h"
+#include "../helpers/straw_ComponentTextIndex.h"
+#include "../input/straw_Gesture.h"
+#include "../input/straw_InputRecorder.h"
+#include "../state/straw_StateSnapshots.h"
+#include "../time/straw_VirtualClock.h"
+
+#if STRAW_AUDIO_ANALYSIS_AVAILABLE
+#include "../audio/straw_AudioAnalysis.h"
+#include "../audio/straw_AudioTap.h"
+#endif
+
+#if STRAW_OFFLINE_RENDERING_AVAILABLE
+#include "../audio/straw_OfflineRenderer.h"
+#endif
 
 #include <functional>
 #include <string_view>
@@ -43,6 +64,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("findComponentById", [](py::args args) -> Component*
     {
+        ScopedTraceSpan span ("python", "straw.findComponentById");
+
         if (args.size() != 1)
             throw popsicle::ScriptException ("Missing argument componentId when calling findComponentById");
 
@@ -56,8 +79,20 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
         return {};
     }, py::return_value_policy::reference);
 
+    m.def ("findComponentAt", [](py::args args) -> Component*
+    {
+        ScopedTraceSpan span ("python", "straw.findComponentAt");
+
+        if (args.size() != 2)
+            throw popsicle::ScriptException ("Missing arguments x and y when calling findComponentAt");
+
+        return ComponentSpatialIndex::getInstance()->findComponentAt ({ args [0].cast<int>(), args [1].cast<int>() });
+    }, py::return_value_policy::reference);
+
     m.def ("findComponentsByType", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.findComponentsByType");
+
         if (args.size() != 1)
             throw popsicle::ScriptException ("Missing argument typeName when calling findComponentByType");
 
@@ -69,8 +104,61 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
         return list;
     });
 
+    m.def ("findComponentsByText", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.findComponentsByText");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument text when calling findComponentsByText");
+
+        auto mode = ComponentTextIndex::MatchMode::exact;
+        if (args.size() > 1)
+        {
+            auto parsedMode = ComponentTextIndex::matchModeFromString (String (py::str (args [1])));
+            if (! parsedMode.has_value())
+                throw popsicle::ScriptException ("Invalid mode when calling findComponentsByText");
+
+            mode = *parsedMode;
+        }
+
+        py::list list;
+        for (const auto& match : ComponentTextIndex::getInstance()->findComponentsByText (String (py::str (args [0])), mode))
+            list.append (match.component);
+        return list;
+    });
+
+    m.def ("findComponentsByAccessibility", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.findComponentsByAccessibility");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument role when calling findComponentsByAccessibility");
+
+        AccessibilityCache::Query query;
+
+        if (auto role = String (py::str (args [0])); role.isNotEmpty())
+        {
+            query.role = AccessibilityCache::roleFromString (role);
+            if (! query.role.has_value())
+                throw popsicle::ScriptException ("Invalid role when calling findComponentsByAccessibility");
+        }
+
+        if (args.size() > 1)
+            query.title = String (py::str (args [1]));
+
+        if (args.size() > 2)
+            query.value = String (py::str (args [2]));
+
+        py::list list;
+        for (auto component : AccessibilityCache::getInstance()->findComponents (query))
+            list.append (component);
+        return list;
+    });
+
     m.def ("clickComponent", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.clickComponent");
+
         if (args.size() != 1)
             throw popsicle::ScriptException ("Missing argument componentId when calling clickComponent");
 
@@ -80,13 +168,157 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
         if (component != nullptr)
         {
-            Helpers::clickComponent (component, {}, nullptr);
+            Helpers::clickComponentAndWait (component, {});
             return;
         }
     });
 
+    m.def ("playGesture", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.playGesture");
+
+        if (args.size() != 1)
+            throw popsicle::ScriptException ("Missing argument gesture when calling playGesture");
+
+        Gesture gesture;
+
+        auto result = Gesture::fromVar (args [0].cast<var>(), gesture);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        result = GesturePlayer::playAndWait (std::move (gesture));
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+    });
+
+    m.def ("startRecording", []
+    {
+        ScopedTraceSpan span ("python", "straw.startRecording");
+
+        InputRecorder::getInstance()->start();
+    });
+
+    m.def ("stopRecording", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.stopRecording");
+
+        if (args.size() > 0 && ! File::isAbsolutePath (String (py::str (args [0]))))
+            throw popsicle::ScriptException ("Recording file must be an absolute path when calling stopRecording");
+
+        auto gesture = InputRecorder::getInstance()->stop();
+
+        if (args.size() > 0)
+        {
+            auto data = InputRecorder::toBinary (gesture);
+
+            if (! File (String (py::str (args [0]))).replaceWithData (data.getData(), data.getSize()))
+                throw popsicle::ScriptException ("Unable to write recording file when calling stopRecording");
+        }
+
+        return static_cast<int> (gesture.events.size());
+    });
+
+    m.def ("replayRecording", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.replayRecording");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument fileName when calling replayRecording");
+
+        double speed = 1.0;
+        if (args.size() > 1)
+            speed = args [1].cast<double>();
+
+        if (speed <= 0.0)
+            throw popsicle::ScriptException ("Invalid speed when calling replayRecording");
+
+        if (! File::isAbsolutePath (String (py::str (args [0]))))
+            throw popsicle::ScriptException ("Recording file must be an absolute path when calling replayRecording");
+
+        MemoryBlock data;
+        if (! File (String (py::str (args [0]))).loadFileAsData (data))
+            throw popsicle::ScriptException ("Unable to read recording file when calling replayRecording");
+
+        Gesture gesture;
+
+        auto result = InputRecorder::fromBinary (data, gesture);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        result = GesturePlayer::playAndWait (gesture.withSpeed (speed));
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+    });
+
+    m.def ("advanceTime", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.advanceTime");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument milliseconds when calling advanceTime");
+
+        auto milliseconds = args [0].cast<double>();
+        if (milliseconds < 0.0)
+            throw popsicle::ScriptException ("Invalid milliseconds when calling advanceTime");
+
+        VirtualClock::getInstance()->advance (milliseconds);
+    });
+
+    m.def ("warpTime", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.warpTime");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument factor when calling warpTime");
+
+        auto factor = args [0].cast<double>();
+        if (factor < 0.0)
+            throw popsicle::ScriptException ("Invalid factor when calling warpTime");
+
+        VirtualClock::getInstance()->setWarpFactor (factor);
+    });
+
+    m.def ("realTime", []
+    {
+        ScopedTraceSpan span ("python", "straw.realTime");
+
+        VirtualClock::getInstance()->setVirtual (false);
+    });
+
+    m.def ("captureState", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.captureState");
+
+        String snapshotName = "baseline";
+        if (args.size() > 0)
+            snapshotName = String (py::str (args [0]));
+
+        auto result = StateSnapshots::getInstance()->capture (snapshotName);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+    });
+
+    m.def ("restoreState", [](py::args args)
+    {
+        ScopedTraceSpan span ("python", "straw.restoreState");
+
+        String snapshotName = "baseline";
+        if (args.size() > 0)
+            snapshotName = String (py::str (args [0]));
+
+        StateSnapshots::RestoreStats stats;
+
+        auto result = StateSnapshots::getInstance()->restore (snapshotName, stats);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        return stats.restoredProviders.size();
+    });
+
     m.def ("renderComponent", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.renderComponent");
+
         if (args.size() == 0)
             throw popsicle::ScriptException ("Missing argument componentId when calling renderComponent");
 
@@ -104,8 +336,185 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
         return Image();
     });
 
+    m.def ("profilePaint", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.profilePaint");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument componentId when calling profilePaint");
+
+        int numIterations = 10;
+        if (args.size() > 1)
+            numIterations = args [1].cast<int>();
+
+        if (numIterations <= 0 || numIterations > PaintProfiler::maxIterations)
+            throw popsicle::ScriptException ("Invalid number of iterations when calling profilePaint");
+
+        auto component = popsicle::python_cast<Component*> (args [0]).value_or (nullptr);
+        if (component == nullptr)
+            component = Helpers::findComponentById (String (py::str (args [0])));
+
+        if (component != nullptr)
+            return PaintProfiler::profile (*component, numIterations).toVar();
+
+        return juce::var();
+    });
+
+    m.def ("startFrameMonitor", []
+    {
+        ScopedTraceSpan span ("python", "straw.startFrameMonitor");
+
+        FrameMonitor::getInstance()->start();
+    });
+
+    m.def ("stopFrameMonitor", []() -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.stopFrameMonitor");
+
+        auto frameMonitor = FrameMonitor::getInstance();
+        frameMonitor->stop();
+
+        return frameMonitor->getStatistics();
+    });
+
+    m.def ("getFrameStatistics", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.getFrameStatistics");
+
+        int maxComponents = 10;
+        if (args.size() > 0)
+            maxComponents = args [0].cast<int>();
+
+        return FrameMonitor::getInstance()->getStatistics (maxComponents);
+    });
+
+    m.def ("beginMemoryReport", []
+    {
+        ScopedTraceSpan span ("python", "straw.beginMemoryReport");
+
+        MemoryTracker::getInstance()->beginReport();
+    });
+
+    m.def ("endMemoryReport", []() -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.endMemoryReport");
+
+        auto report = MemoryTracker::getInstance()->endReport();
+        if (report.isVoid())
+            throw popsicle::ScriptException ("No memory report has begun when calling endMemoryReport");
+
+        return report;
+    });
+
+   #if STRAW_AUDIO_ANALYSIS_AVAILABLE
+    m.def ("audioLevels", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.audioLevels");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument tap when calling audioLevels");
+
+        const auto duration = RelativeTime::milliseconds (args.size() > 1 ? args [1].cast<int>() : 1000);
+
+        AudioBuffer<float> buffer;
+        double sampleRate = 0.0;
+
+        auto result = AudioTap::readTap (String (py::str (args [0])), AudioTap::Stream::output, duration, buffer, sampleRate);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        return AudioAnalysis::measureLevels (buffer).toVar();
+    });
+
+    m.def ("audioSpectrum", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.audioSpectrum");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument tap when calling audioSpectrum");
+
+        const auto duration = RelativeTime::milliseconds (args.size() > 1 ? args [1].cast<int>() : 1000);
+
+        AudioBuffer<float> buffer;
+        double sampleRate = 0.0;
+
+        auto result = AudioTap::readTap (String (py::str (args [0])), AudioTap::Stream::output, duration, buffer, sampleRate);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        AudioSpectrum spectrum;
+
+        result = AudioAnalysis::computeSpectrum (buffer, sampleRate, 12, 5, spectrum);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        return spectrum.toVar();
+    });
+
+    m.def ("audioLatency", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.audioLatency");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument tap when calling audioLatency");
+
+        const auto tapName = String (py::str (args [0]));
+        const auto referenceName = args.size() > 1 ? String (py::str (args [1])) : tapName;
+        const auto maxLatency = args.size() > 2 ? args [2].cast<int>() : 500;
+        const auto duration = RelativeTime::seconds (1.0);
+
+        AudioBuffer<float> reference;
+        AudioBuffer<float> signal;
+        double referenceSampleRate = 0.0;
+        double sampleRate = 0.0;
+
+        auto result = AudioTap::readTap (referenceName, AudioTap::Stream::output, duration, reference, referenceSampleRate);
+        if (result.wasOk())
+            result = AudioTap::readTap (tapName, AudioTap::Stream::input, duration, signal, sampleRate);
+
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        AudioLatency latency;
+
+        result = AudioAnalysis::measureLatency (reference, signal, sampleRate, static_cast<int> (maxLatency * sampleRate / 1000.0), latency);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        return latency.toVar();
+    });
+   #endif
+
+   #if STRAW_OFFLINE_RENDERING_AVAILABLE
+    m.def ("renderProcessor", [](py::args args) -> juce::var
+    {
+        ScopedTraceSpan span ("python", "straw.renderProcessor");
+
+        if (args.size() == 0)
+            throw popsicle::ScriptException ("Missing argument request when calling renderProcessor");
+
+        std::vector<OfflineRenderJob> jobs;
+
+        auto result = OfflineRenderer::parseJobs (args [0].cast<var>(), jobs);
+        if (result.failed())
+            throw popsicle::ScriptException (result.getErrorMessage().toRawUTF8());
+
+        // The script blocks until the renders finish, they don't need the interpreter
+        std::vector<OfflineRenderResult> results;
+
+        {
+            py::gil_scoped_release release;
+            results = OfflineRenderer::getInstance()->render (jobs);
+        }
+
+        return OfflineRenderer::resultsToVar (results);
+    });
+   #endif
+
     m.def ("invokeComponentCustomMethod", [](py::args args) -> juce::var
     {
+        ScopedTraceSpan span ("python", "straw.invokeComponentCustomMethod");
+
         if (args.size() < 2)
             throw popsicle::ScriptException ("Missing arguments componentID and/or methodName when calling invokeComponentCustomMethod");
 
@@ -132,11 +541,15 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertAlways", []([[maybe_unused]] py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertAlways");
+
         throw popsicle::ScriptException ("Failing always");
     });
 
     m.def ("assertTrue", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertTrue");
+
         if (args.size() != 1)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertTrue");
 
@@ -148,6 +561,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertFalse", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertFalse");
+
         if (args.size() != 1)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertFalse");
 
@@ -159,6 +574,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertEqual", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertEqual");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertEqual");
 
@@ -170,6 +587,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertNotEqual", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertNotEqual");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertNotEqual");
 
@@ -181,6 +600,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertLessThan", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertLessThan");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertLessThan");
 
@@ -192,6 +613,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertLessThanEqual", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertLessThanEqual");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertLessThanEqual");
 
@@ -203,6 +626,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertGreaterThan", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertGreaterThan");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertGreaterThan");
 
@@ -214,6 +639,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("assertGreaterThanEqual", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.assertGreaterThanEqual");
+
         if (args.size() != 2)
             throw popsicle::ScriptException ("Invalid number of arguments when calling assertGreaterThanEqual");
 
@@ -225,6 +652,8 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("throwException", [](py::args args)
     {
+        ScopedTraceSpan span ("python", "straw.throwException");
+
         String message;
         for (const auto& arg : args)
             message << arg.cast<py::str>();
@@ -238,23 +667,21 @@ PYBIND11_EMBEDDED_MODULE(straw, m)
 
     m.def ("quitApplication", []
     {
+        ScopedTraceSpan span ("python", "straw.quitApplication");
+
         juce::JUCEApplication::getInstance()->quit();
     });
 
     m.def ("log", [](py::args args)
     {
-        auto currentTime = Time::getCurrentTime();
+        ScopedTraceSpan span ("python", "straw.log");
 
         String message;
-        message
-            << JUCEApplication::getInstance()->getApplicationName()
-            << currentTime.formatted (" (%Y/%m/%d %H:%M:%S.")
-            << currentTime.getMilliseconds()
-            << ")> ";
 
         for (const auto& arg : args)
             message << arg.cast<py::str>();
 
-        Logger::writeToLog (message);
+        // The logger adds the timestamp, and writes the message without blocking the script
+        AsyncLogger::getInstance()->log (LogLevel::info, JUCEApplication::getInstance()->getApplicationName(), message);
     });
 }
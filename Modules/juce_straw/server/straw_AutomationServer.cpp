@@ -3,35 +3,24 @@
  */
 
 #include "straw_AutomationServer.h"
+#include "straw_Http.h"
 
 #include "../endpoints/straw_ComponentEndpoints.h"
 #include "../helpers/straw_ComponentHelpers.h"
+#include "../helpers/straw_ProcessHelpers.h"
+#include "../diagnostics/straw_AsyncLogger.h"
+#include "../diagnostics/straw_MessageThreadTracer.h"
+#include "../diagnostics/straw_SessionTracer.h"
+#include "../diagnostics/straw_MemoryTracker.h"
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_events/juce_events.h>
 
-#if JUCE_WINDOWS
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
-
 namespace straw {
 namespace {
 
 //=================================================================================================
 
-int32_t currentProcessPid()
-{
-#if JUCE_MAC || JUCE_LINUX
-    return static_cast<int32_t> (::getpid());
-#else
-    return static_cast<int32_t> (GetCurrentProcessId());
-#endif
-}
-
-//=================================================================================================
-
 template <class... Args>
 juce::Result failedResult (Args&&... args)
 {
@@ -44,191 +33,241 @@ juce::Result failedResult (Args&&... args)
 
 //=================================================================================================
 
-bool startsWithHttpVerb (const juce::String& httpLine)
+juce::var makeResultVar (const juce::var& value)
+{
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("result", value);
+    return object.get();
+}
+
+juce::var makeErrorVar (juce::StringRef message)
 {
-    return httpLine.startsWith ("GET")
-        || httpLine.startsWith ("PUT")
-        || httpLine.startsWith ("POST");
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+    object->setProperty ("error", juce::String (message));
+    return object.get();
 }
 
 //=================================================================================================
 
-juce::String makeHttpStatusCode (int statusCode)
+void writeHttpResponse (const juce::MemoryBlock& responseMessage, int status, Connection& connection)
 {
-    static const std::unordered_map<int, juce::String> httpStatusCodes
+    ScopedTraceSpan span ("server", "write");
+
+    auto endpointMetrics = ScopedEndpointMetrics::getCurrent();
+    auto writeStartTicks = juce::Time::getHighResolutionTicks();
+
+    connection.write (responseMessage.getData(), static_cast<int> (responseMessage.getSize()));
+
+    if (endpointMetrics != nullptr)
     {
-        { 100, "100 Continue" },
-        { 200, "200 OK" },
-        { 404, "404 Not Found" },
-        { 500, "500 Internal Server Error" }
-    };
+        endpointMetrics->writeTime.recordSince (writeStartTicks);
+        endpointMetrics->bytesOut.fetch_add (responseMessage.getSize(), std::memory_order_relaxed);
 
-    auto it = httpStatusCodes.find (statusCode);
-    if (it == httpStatusCodes.end())
-        return "500 Internal Server Error";
+        if (status >= 400)
+            endpointMetrics->numErrors.fetch_add (1, std::memory_order_relaxed);
+    }
+}
 
-    return it->second;
+void recordSerializationTime (juce::int64 startTicks)
+{
+    if (auto endpointMetrics = ScopedEndpointMetrics::getCurrent())
+        endpointMetrics->serializationTime.recordSince (startTicks);
 }
 
 //=================================================================================================
 
-juce::MemoryBlock makeHttpResponse (const juce::String& payload, const juce::String& contentType, int status = 200)
+bool replaceFileAtomically (const juce::File& file, const juce::String& content)
 {
-    juce::String response;
+    // Readers either see the previous content or the new one, never a partially written file
+    juce::TemporaryFile temporaryFile (file, juce::TemporaryFile::useHiddenFile);
 
-    response
-    << "HTTP/1.1 " << makeHttpStatusCode (status) << "\n"
-    << "Server: Squeeze/0.0.1" << "\n"
-    << "Content-Type: " << contentType << "\n"
-    << "Content-Length: " << payload.getNumBytesAsUTF8() << "\n"
-    << "Connection: Closed" << "\n\n";
+    if (! temporaryFile.getFile().replaceWithText (content))
+        return false;
 
-    juce::MemoryBlock mb;
-    mb.append (response.toRawUTF8(), response.getNumBytesAsUTF8());
-    mb.append (payload.toRawUTF8(), payload.getNumBytesAsUTF8());
-    return mb;
+    return temporaryFile.overwriteTargetFileWithTemporary();
 }
 
-juce::MemoryBlock makeHttpResponse (const juce::MemoryBlock& payload, const juce::String& contentType, int status = 200)
+juce::File getSharedMemoryDirectory()
 {
-    juce::String response;
+    // Prefer the memory backed file system, so the ring never hits the disk
+    juce::File sharedMemoryDirectory ("/dev/shm");
+    if (sharedMemoryDirectory.isDirectory())
+        return sharedMemoryDirectory;
 
-    response
-    << "HTTP/1.1 " << makeHttpStatusCode (status) << "\n"
-    << "Server: Squeeze/0.0.1" << "\n"
-    << "Content-Type: " << contentType << "\n"
-    << "Content-Length: " << payload.getSize() << "\n"
-    << "Connection: Closed" << "\n\n";
-
-    juce::MemoryBlock mb;
-    mb.append (response.toRawUTF8(), response.getNumBytesAsUTF8());
-    mb.append (payload.getData(), payload.getSize());
-    return mb;
+    return juce::File::getSpecialLocation (juce::File::tempDirectory);
 }
 
-//=================================================================================================
-
-juce::MemoryBlock readHttpPayload (juce::StreamingSocket& connection)
+juce::String getRunningApplicationName()
 {
-    juce::MemoryBlock payload;
-    juce::uint8 data[1024] = { 0 };
+    if (auto application = juce::JUCEApplicationBase::getInstance())
+        return application->getApplicationName();
 
-    while (true)
-    {
-        auto numBytesRead = connection.read (data, juce::numElementsInArray (data), false);
-        if (numBytesRead <= 0)
-            break;
+    return juce::File::getSpecialLocation (juce::File::currentExecutableFile).getFileNameWithoutExtension();
+}
 
-        payload.append (data, static_cast<size_t> (numBytesRead));
+const char* pythonStateToString (AutomationServer::PythonState state)
+{
+    switch (state)
+    {
+        case AutomationServer::PythonState::warming: return "warming";
+        case AutomationServer::PythonState::ready: return "ready";
+        case AutomationServer::PythonState::cold:
+        default: break;
     }
 
-    return payload;
+    return "cold";
 }
 
+} // namespace
+
 //=================================================================================================
 
-Request parseHttpPayload (const juce::String& payload)
+void sendHttpResponse (const juce::MemoryBlock& response, juce::StringRef contentType, int status, Connection& connection)
 {
-    Request request;
-
-    auto requestStrings = juce::StringArray::fromLines (payload);
-    for (int i = 0; i < requestStrings.size(); ++i)
+    if (auto ring = connection.getSharedMemoryRing(); ring != nullptr && response.getSize() >= SharedMemoryRing::minimumPayloadSize)
     {
-        const auto& requestString = requestStrings [i];
-        //juce::Logger::writeToLog (requestString);
-
-        if (startsWithHttpVerb (requestString))
+        // Hand over large payloads through the ring, and only send their location through the connection
+        if (auto block = ring->write (response.getData(), response.getSize()))
         {
-            auto pathParts = juce::StringArray::fromTokens (requestString, false);
-            if (pathParts.size() >= 1)
-                request.verb = pathParts [0];
-            if (pathParts.size() >= 2)
-                request.path = pathParts [1];
-        }
-        else if (requestString.startsWith ("Content-Type: "))
-        {
-            request.contentType = requestString
-                .fromFirstOccurrenceOf ("Content-Type: ", false, true)
-                .upToFirstOccurrenceOf (";", false, false);
-        }
-        else if (requestString.startsWith ("Content-Length: "))
-        {
-            request.contentLength = requestString.fromFirstOccurrenceOf ("Content-Length: ", false, true).getIntValue();
-        }
-        else if (requestString.isEmpty())
-        {
-            auto remainingPayload = requestStrings;
-            remainingPayload.removeRange (0, i + 1);
+            juce::StringPairArray headers;
+            headers.set ("X-Straw-Shm-Path", ring->getFile().getFullPathName());
+            headers.set ("X-Straw-Shm-Position", juce::String (block->position));
+            headers.set ("X-Straw-Shm-Size", juce::String (block->size));
 
-            request.contentData = remainingPayload.joinIntoString ("\n");
-
-            break;
+            auto responseMessage = Http::makeHttpResponse (juce::MemoryBlock(), contentType, status, headers);
+            writeHttpResponse (responseMessage, status, connection);
+            return;
         }
     }
 
-    return request;
-}
-
-juce::var makeResultVar (const juce::var& value)
-{
-    juce::DynamicObject::Ptr object = new juce::DynamicObject;
-    object->setProperty ("result", value);
-    return object.get();
-}
-
-juce::var makeErrorVar (juce::StringRef message)
-{
-    juce::DynamicObject::Ptr object = new juce::DynamicObject;
-    object->setProperty ("error", juce::String (message));
-    return object.get();
+    auto responseMessage = Http::makeHttpResponse (response, contentType, status);
+    writeHttpResponse (responseMessage, status, connection);
 }
 
-} // namespace
-
-//=================================================================================================
-
-void sendHttpResponse (const juce::MemoryBlock& response, juce::StringRef contentType, int status, juce::StreamingSocket& connection)
+void sendHttpResponse (const juce::Image& image, int status, Connection& connection)
 {
-    auto responseMessage = makeHttpResponse (response, contentType, status);
-    connection.write (responseMessage.getData(), static_cast<int> (responseMessage.getSize()));
-}
+    auto serializationStartTicks = juce::Time::getHighResolutionTicks();
 
-void sendHttpResponse (const juce::Image& image, int status, juce::StreamingSocket& connection)
-{
     juce::MemoryBlock mb;
     juce::MemoryOutputStream mos (mb, false);
 
     juce::PNGImageFormat pngFormat;
     if (pngFormat.writeImageToStream (image, mos))
+    {
+        mos.flush();
+        recordSerializationTime (serializationStartTicks);
+        SessionTracer::getInstance()->addSpan ("server", "serialize", serializationStartTicks, juce::Time::getHighResolutionTicks());
+
         sendHttpResponse (mb, "image/png", status, connection);
+    }
     else
+    {
         sendHttpErrorResponse ("Unable to send image", status, connection);
+    }
 }
 
-void sendHttpResponse (const juce::var& response, int status, juce::StreamingSocket& connection)
+void sendHttpResponse (const juce::var& response, int status, Connection& connection)
 {
+    auto serializationStartTicks = juce::Time::getHighResolutionTicks();
+
+    const auto format = connection.getResponseFormat();
+    if (isBinaryWireFormat (format))
+    {
+        auto encodedResponse = encodeVar (response, format);
+
+        recordSerializationTime (serializationStartTicks);
+        SessionTracer::getInstance()->addSpan ("server", "serialize", serializationStartTicks, juce::Time::getHighResolutionTicks());
+
+        sendHttpResponse (encodedResponse, wireFormatToMimeType (format), status, connection);
+        return;
+    }
+
     auto resultJson = juce::JSON::toString (response);
-    juce::Logger::writeToLog (resultJson);
 
-    auto responseMessage = makeHttpResponse (resultJson, "plain/text", status);
-    connection.write (responseMessage.getData(), static_cast<int> (responseMessage.getSize()));
+    recordSerializationTime (serializationStartTicks);
+    SessionTracer::getInstance()->addSpan ("server", "serialize", serializationStartTicks, juce::Time::getHighResolutionTicks());
+
+    auto endpointMetrics = ScopedEndpointMetrics::getCurrent();
+    AsyncLogger::getInstance()->logPayload ("response", endpointMetrics != nullptr ? endpointMetrics->path : juce::String ("server"), resultJson);
+
+    if (connection.getSharedMemoryRing() != nullptr && static_cast<std::size_t> (resultJson.getNumBytesAsUTF8()) >= SharedMemoryRing::minimumPayloadSize)
+    {
+        sendHttpResponse (juce::MemoryBlock (resultJson.toRawUTF8(), resultJson.getNumBytesAsUTF8()), "plain/text", status, connection);
+        return;
+    }
+
+    auto responseMessage = Http::makeHttpResponse (resultJson, "plain/text", status);
+    writeHttpResponse (responseMessage, status, connection);
 }
 
-void sendHttpResultResponse (const juce::var& result, int status, juce::StreamingSocket& connection)
+void sendHttpResultResponse (const juce::var& result, int status, Connection& connection)
 {
     sendHttpResponse (makeResultVar (result), status, connection);
 }
 
-void sendHttpErrorResponse (juce::StringRef message, int status, juce::StreamingSocket& connection)
+void sendHttpErrorResponse (juce::StringRef message, int status, Connection& connection)
 {
     sendHttpResponse (makeErrorVar (message), status, connection);
 }
 
 //=================================================================================================
 
+bool callOnMessageThread (std::function<void()> function)
+{
+    auto endpointMetrics = ScopedEndpointMetrics::getCurrent();
+    if (endpointMetrics == nullptr)
+        return juce::MessageManager::callAsync (MessageThreadTracer::getInstance()->wrap ("callOnMessageThread", std::move (function)));
+
+    auto postedTicks = juce::Time::getHighResolutionTicks();
+
+    return juce::MessageManager::callAsync (MessageThreadTracer::getInstance()->wrap (endpointMetrics->path, [endpointMetrics, postedTicks, function = std::move (function)]
+    {
+        endpointMetrics->messageThreadWait.recordSince (postedTicks);
+
+        ScopedEndpointMetrics scope (endpointMetrics);
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        function();
+        endpointMetrics->messageThreadTime.recordSince (startTicks);
+    }));
+}
+
+//=================================================================================================
+
+class AutomationServer::UnixSocketAcceptor : public juce::Thread
+{
+public:
+    explicit UnixSocketAcceptor (AutomationServer& owner)
+        : juce::Thread ("Squeeze Unix Socket Thread")
+        , owner (owner)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit() && owner.unixSocket.isListening())
+        {
+            // Time out regularly to check if we should exit, the listener is closed only after this thread stopped
+            auto connection = owner.unixSocket.waitForNextConnection (100);
+            if (connection == nullptr)
+                continue;
+
+            SessionTracer::getInstance()->addSpan ("server", "accept", juce::Time::getHighResolutionTicks(), 0);
+
+            owner.handleConnection (std::shared_ptr<Connection> (std::move (connection)));
+        }
+    }
+
+private:
+    AutomationServer& owner;
+};
+
+//=================================================================================================
+
 AutomationServer::AutomationServer()
     : juce::Thread ("Squeeze Server Thread")
     , connectionPool (juce::ThreadPoolOptions().withThreadName ("Squeeze Requests Thread"))
+    , pythonMetrics (metrics.getEndpointMetrics ("text/x-python"))
 {
 }
 
@@ -236,63 +275,224 @@ AutomationServer::~AutomationServer()
 {
     popsicle::Bindings::clearComponentTypes();
 
+    // Wait for a pending asynchronous start, which would otherwise start the server after stopping it
+    connectionPool.removeAllJobs (true, 10000);
+
     stop();
+
+    scriptEngine.reset();
 }
 
 //=================================================================================================
 
-juce::Result AutomationServer::start (std::optional<int> port)
+juce::Result AutomationServer::start (std::optional<int> port, const juce::File& unixSocketFile)
 {
+    auto lock = juce::CriticalSection::ScopedLockType (startLock);
+
     if (socket.isConnected())
         return failedResult ("Unable to listen, server already listening");
 
-    localPort.reset();
+    localPort = 0;
 
-    int definedPort = port.value_or (8001);
+    if (port.has_value())
+    {
+        if (! socket.createListener (*port))
+            return failedResult ("Unable to listen to port ", *port);
+    }
+    else if (! socket.createListener (defaultPort))
+    {
+        // Let the system pick a free port instead of probing ports one by one, the bound port is published in the registry
+        if (! socket.createListener (0))
+            return failedResult ("Unable to listen to port ", defaultPort, " or to any free port");
+    }
 
-    if (! socket.createListener (definedPort))
+    const int boundPort = socket.getBoundPort();
+    if (boundPort <= 0)
     {
-        if (port.has_value())
-            return failedResult ("Unable to listen to port ", definedPort);
+        socket.close();
+        return failedResult ("Unable to retrieve the listening port");
+    }
 
-        int currentPort = definedPort, upperPort = juce::jmin (65535, definedPort + 1000);
-        while (! socket.createListener (currentPort) && currentPort < upperPort)
-            ++currentPort;
+    if (unixSocketFile != juce::File())
+    {
+        if (auto result = unixSocket.createListener (unixSocketFile); result.failed())
+        {
+            socket.close();
+            return result;
+        }
 
-        if (! socket.isConnected())
-            return failedResult ("Unable to listen to ports in range ", definedPort, "-", upperPort);
+        unixSocketAcceptor = std::make_unique<UnixSocketAcceptor> (*this);
+        if (! unixSocketAcceptor->startThread())
+        {
+            unixSocketAcceptor.reset();
+            unixSocket.close();
+            socket.close();
+            return failedResult ("Unable to start unix socket thread");
+        }
     }
 
     if (! startThread())
+    {
+        if (unixSocketAcceptor != nullptr)
+        {
+            unixSocketAcceptor->stopThread (1000);
+            unixSocketAcceptor.reset();
+            unixSocket.close();
+        }
+
+        socket.close();
         return failedResult ("Unable to start thread");
+    }
+
+    {
+        auto runFileScopedLock = juce::CriticalSection::ScopedLockType (runFileLock);
 
-    localPort = definedPort;
+        localPort = boundPort;
+        startTimeMilliseconds = juce::Time::currentTimeMillis();
 
-    updateLocalRunFile();
+        updateLocalRunFile();
+    }
+
+    if (isPythonWarmUpEnabled && pythonState == PythonState::cold)
+    {
+        // The interpreter lives on the message thread, initialising it in a posted message never delays the caller
+        juce::MessageManager::callAsync ([weakThis = juce::WeakReference<AutomationServer> (this)]
+        {
+            if (weakThis != nullptr)
+                weakThis->getScriptEngine();
+        });
+    }
 
     return juce::Result::ok();
 }
 
+void AutomationServer::startAsync (std::optional<int> port, const juce::File& unixSocketFile, StartCallback callback)
+{
+    juce::WeakReference<AutomationServer> weakThis (this);
+
+    connectionPool.addJob ([this, weakThis, port, unixSocketFile, callback = std::move (callback)]
+    {
+        auto result = start (port, unixSocketFile);
+        if (result.failed())
+            AsyncLogger::getInstance()->log (LogLevel::error, "server", result.getErrorMessage());
+
+        if (callback != nullptr)
+        {
+            juce::MessageManager::callAsync ([weakThis, callback, result]
+            {
+                if (weakThis != nullptr)
+                    callback (result);
+            });
+        }
+    });
+}
+
 void AutomationServer::stop()
 {
-    if (! socket.isConnected() || ! localPort.has_value())
+    auto lock = juce::CriticalSection::ScopedLockType (startLock);
+
+    if (! socket.isConnected() || localPort == 0)
         return;
 
     signalThreadShouldExit();
     socket.close();
 
+    if (unixSocketAcceptor != nullptr)
+    {
+        unixSocketAcceptor->stopThread (10000);
+        unixSocketAcceptor.reset();
+        unixSocket.close();
+    }
+
     connectionPool.removeAllJobs (true, 10000);
 
-    getLocalRunFile().deleteFile();
+    {
+        auto runFileScopedLock = juce::CriticalSection::ScopedLockType (runFileLock);
+
+        removeLocalRunFile();
+        localPort = 0;
+    }
 
     waitForThreadToExit (10000);
 }
 
 //=================================================================================================
 
+void AutomationServer::setPythonWarmUpEnabled (bool shouldWarmUp)
+{
+    isPythonWarmUpEnabled = shouldWarmUp;
+}
+
+AutomationServer::PythonState AutomationServer::getPythonState() const
+{
+    return pythonState;
+}
+
+juce::StringArray AutomationServer::getPythonModules() const
+{
+    juce::StringArray modules{ "straw" };
+
+    {
+        auto lock = juce::CriticalSection::ScopedLockType (modulesLock);
+        modules.addArray (modulesToImport);
+    }
+
+    modules.removeDuplicates (false);
+    return modules;
+}
+
+popsicle::ScriptEngine& AutomationServer::getScriptEngine()
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // Modules registered once the interpreter is running are only imported by a new engine, never while a script is using it
+    auto modules = getPythonModules();
+    if (scriptEngine == nullptr || (modules != scriptEngineModules && ! isRunningScript))
+    {
+        setPythonState (PythonState::warming);
+
+        {
+            ScopedTraceSpan span ("python", "initialise");
+
+            scriptEngine.reset();
+            scriptEngine = std::make_unique<popsicle::ScriptEngine> (modules);
+            scriptEngineModules = modules;
+        }
+
+        setPythonState (PythonState::ready);
+    }
+
+    return *scriptEngine;
+}
+
+void AutomationServer::setPythonState (PythonState newState)
+{
+    pythonState = newState;
+
+    updateLocalRunFile();
+}
+
+//=================================================================================================
+
 std::optional<int> AutomationServer::getPort() const
 {
-    return localPort;
+    if (const auto port = localPort.load(); port != 0)
+        return port;
+
+    return std::nullopt;
+}
+
+std::optional<juce::File> AutomationServer::getUnixSocketFile() const
+{
+    if (! unixSocket.isListening())
+        return std::nullopt;
+
+    return unixSocket.getSocketFile();
+}
+
+const ServerMetrics& AutomationServer::getMetrics() const
+{
+    return metrics;
 }
 
 //=================================================================================================
@@ -309,13 +509,9 @@ void AutomationServer::run()
         if (! connection)
             continue;
 
-        auto pooledConnection = std::shared_ptr<juce::StreamingSocket> (connection, [](auto* conn)
-        {
-            conn->close();
-            delete conn;
-        });
+        SessionTracer::getInstance()->addSpan ("server", "accept", juce::Time::getHighResolutionTicks(), 0);
 
-        handleConnection (std::move (pooledConnection));
+        handleConnection (std::make_shared<SocketConnection> (std::unique_ptr<juce::StreamingSocket> (connection)));
     }
 }
 
@@ -323,48 +519,127 @@ void AutomationServer::run()
 
 void AutomationServer::updateLocalRunFile()
 {
-    jassert (localPort.has_value());
+    auto lock = juce::CriticalSection::ScopedLockType (runFileLock);
+
+    // Not listening, or stopped while the python interpreter was initialised
+    if (localPort == 0)
+        return;
 
     juce::String content;
 
     content
-        << "pid=" << currentProcessPid() << juce::newLine
-        << "port=" << *localPort << juce::newLine;
+        << "pid=" << Helpers::getCurrentProcessId() << juce::newLine
+        << "port=" << localPort.load() << juce::newLine
+        << "name=" << getRunningApplicationName() << juce::newLine
+        << "executable=" << juce::File::getSpecialLocation (juce::File::currentExecutableFile).getFullPathName() << juce::newLine
+        << "started=" << juce::Time (startTimeMilliseconds.load()).toISO8601 (true) << juce::newLine
+        << "python=" << pythonStateToString (pythonState) << juce::newLine;
+
+    if (auto unixSocketFile = getUnixSocketFile())
+        content << "unix_socket=" << unixSocketFile->getFullPathName() << juce::newLine;
+
+    auto registryDirectory = getRegistryDirectory();
+    if (registryDirectory.createDirectory().wasOk())
+        replaceFileAtomically (getRegistryFile(), content);
+
+    // Kept for the tools reading a single instance file, the last started instance wins
+    replaceFileAtomically (getLocalRunFile(), content);
+}
+
+void AutomationServer::removeLocalRunFile()
+{
+    getRegistryFile().deleteFile();
+
+    // Don't remove the legacy run file if another instance took it over
+    auto localRunFile = getLocalRunFile();
+    if (localRunFile.loadFileAsString().contains ("pid=" + juce::String (Helpers::getCurrentProcessId()) + juce::newLine))
+        localRunFile.deleteFile();
+}
+
+//=================================================================================================
+
+std::shared_ptr<SharedMemoryRing> AutomationServer::getSharedMemoryRing()
+{
+    auto lock = juce::CriticalSection::ScopedLockType (sharedMemoryLock);
 
-    getLocalRunFile().replaceWithText (content);
+    // Created on first request, most clients never ask for it
+    if (sharedMemoryRing == nullptr)
+    {
+        // The random part keeps other local users from guessing the name and creating the file first
+        auto file = getSharedMemoryDirectory().getChildFile ("straw-" + juce::String (Helpers::getCurrentProcessId())
+            + "-" + juce::String::toHexString (juce::Random::getSystemRandom().nextInt64()) + ".shm");
+
+        if (auto result = SharedMemoryRing::create (file, SharedMemoryRing::defaultCapacity, sharedMemoryRing); result.failed())
+            AsyncLogger::getInstance()->log (LogLevel::error, "server", result.getErrorMessage());
+    }
+
+    return sharedMemoryRing;
 }
 
 //=================================================================================================
 
-void AutomationServer::handleConnection (std::shared_ptr<juce::StreamingSocket> connection)
+void AutomationServer::handleConnection (std::shared_ptr<Connection> connection)
 {
+    ScopedTraceSpan span ("server", "connection");
+
+    metrics.numConnections.fetch_add (1, std::memory_order_relaxed);
+
     auto connectionStatus = connection->waitUntilReady (true, 1000);
     if (connectionStatus == -1)
     {
+        metrics.numRejectedConnections.fetch_add (1, std::memory_order_relaxed);
         sendHttpErrorResponse ("failed syncing with connection reading", 500, *connection);
         return;
     }
 
-    juce::MemoryBlock payload = readHttpPayload (*connection);
+    auto readStartTicks = juce::Time::getHighResolutionTicks();
+
+    juce::MemoryBlock payload = Http::readHttpPayload (*connection);
+
+    metrics.readTime.recordSince (readStartTicks);
+    SessionTracer::getInstance()->addSpan ("server", "read", readStartTicks, juce::Time::getHighResolutionTicks());
+    metrics.bytesIn.fetch_add (payload.getSize(), std::memory_order_relaxed);
+
     if (payload.isEmpty())
     {
+        metrics.numRejectedConnections.fetch_add (1, std::memory_order_relaxed);
         sendHttpErrorResponse ("invalid processing of empty payload", 500, *connection);
         return;
     }
 
-    juce::Logger::writeToLog (payload.toString());
+    auto parseStartTicks = juce::Time::getHighResolutionTicks();
 
-    Request request = parseHttpPayload (payload.toString());
+    Request request = Http::parseHttpPayload (payload);
     request.connection = connection;
 
-    if (request.contentLength == 0 || request.contentData.length() != request.contentLength)
+    connection->setResponseFormat (Http::negotiateResponseFormat (request));
+
+    // Same host clients can ask for bulk responses to be delivered through shared memory
+    if (request.headers ["X-Straw-Transport"] == "shm" && connection->isLocal())
+        connection->setSharedMemoryRing (getSharedMemoryRing());
+
+    metrics.parseTime.recordSince (parseStartTicks);
+    SessionTracer::getInstance()->addSpan ("server", "parse", parseStartTicks, juce::Time::getHighResolutionTicks());
+
+    const auto requestFormat = wireFormatFromMimeType (request.contentType);
+
+    // Requests without a body (like a metrics scraper GET) are dispatched as json requests without data
+    const bool isBodyless = request.contentLength == 0 && request.contentData.isEmpty() && request.contentBinary.isEmpty();
+    const auto contentSize = request.contentBinary.isEmpty() ? static_cast<std::size_t> (request.contentData.length()) : request.contentBinary.getSize();
+    if (isBodyless && (request.contentType.isEmpty() || requestFormat.has_value()))
+    {
+        if (request.contentType.isEmpty())
+            request.contentType = "application/json";
+    }
+    else if (request.contentLength == 0 || contentSize != static_cast<std::size_t> (request.contentLength))
     {
+        metrics.numRejectedConnections.fetch_add (1, std::memory_order_relaxed);
         sendHttpErrorResponse ("invalid content length", 500, *connection);
         return;
     }
 
-    if (request.contentType == "application/json")
-        handleApplicationJsonRequest (std::move (request));
+    if (wireFormatFromMimeType (request.contentType).has_value())
+        handleEndpointRequest (std::move (request));
 
     if (request.contentType == "text/x-python")
         handlePythonScriptRequest (std::move (request));
@@ -372,7 +647,7 @@ void AutomationServer::handleConnection (std::shared_ptr<juce::StreamingSocket>
 
 //=================================================================================================
 
-void AutomationServer::handleApplicationJsonRequest (Request request)
+void AutomationServer::handleEndpointRequest (Request request)
 {
     if (request.path.isEmpty())
     {
@@ -380,26 +655,85 @@ void AutomationServer::handleApplicationJsonRequest (Request request)
         return;
     }
 
-    auto result = juce::JSON::parse (request.contentData, request.data);
-    if (result.failed())
+    if (request.contentData.isNotEmpty() || ! request.contentBinary.isEmpty())
     {
-        sendHttpErrorResponse ("failed parsing json", 500, *request.connection);
-        return;
+        const auto format = wireFormatFromMimeType (request.contentType).value_or (WireFormat::json);
+
+        auto parseStartTicks = juce::Time::getHighResolutionTicks();
+
+        auto result = request.contentBinary.isEmpty()
+            ? juce::JSON::parse (request.contentData, request.data)
+            : decodeVar (request.contentBinary.getData(), request.contentBinary.getSize(), format, request.data);
+
+        metrics.parseTime.recordSince (parseStartTicks);
+        SessionTracer::getInstance()->addSpan ("server", isBinaryWireFormat (format) ? "parse binary" : "parse json", parseStartTicks, juce::Time::getHighResolutionTicks());
+
+        if (result.failed())
+        {
+            metrics.numRejectedConnections.fetch_add (1, std::memory_order_relaxed);
+            sendHttpErrorResponse (isBinaryWireFormat (format) ? "failed parsing " + wireFormatToMimeType (format) : juce::String ("failed parsing json"), 500, *request.connection);
+            return;
+        }
     }
 
     {
-        auto lock = juce::CriticalSection::ScopedLockType (callbacksLock);
+        ScopedTraceSpan span ("server", "dispatch");
 
-        auto it = callbacks.find (request.path);
-        if (it == callbacks.end())
+        auto match = router.findRoute (request.verb, request.path);
+        if (match.route == nullptr)
         {
-            sendHttpErrorResponse ("path not found", 404, *request.connection);
+            metrics.numRejectedConnections.fetch_add (1, std::memory_order_relaxed);
+
+            if (match.isMethodNotAllowed)
+                sendHttpErrorResponse ("method not allowed", 405, *request.connection);
+            else
+                sendHttpErrorResponse ("path not found", 404, *request.connection);
+
             return;
         }
 
-        connectionPool.addJob ([callback = it->second, request = std::move (request)]
+        if (match.parameters.size() > 0)
+        {
+            request.parameters = std::move (match.parameters);
+
+            // Expose the path parameters like body properties, taking precedence over them
+            if (request.data.isVoid())
+                request.data = new juce::DynamicObject;
+
+            if (auto object = request.data.getDynamicObject())
+            {
+                for (int i = 0; i < request.parameters.size(); ++i)
+                    object->setProperty (request.parameters.getAllKeys() [i], request.parameters.getAllValues() [i]);
+            }
+        }
+
+        // Logged once routed, so payloads are sampled per endpoint, binary bodies would only be noise in the log
+        if (auto* logger = AsyncLogger::getInstance(); logger->isEnabled (LogLevel::debug))
+        {
+            if (! request.contentBinary.isEmpty())
+                logger->logPayload ("request", match.route->pattern, juce::String (request.contentBinary.getSize()) + " bytes of " + request.contentType);
+            else
+                logger->logPayload ("request", match.route->pattern, request.verb + " " + request.path + " " + request.contentData);
+        }
+
+        auto endpointMetrics = match.route->metrics;
+        endpointMetrics->numRequests.fetch_add (1, std::memory_order_relaxed);
+        endpointMetrics->bytesIn.fetch_add (static_cast<juce::uint64> (request.contentData.getNumBytesAsUTF8()) + request.contentBinary.getSize(), std::memory_order_relaxed);
+
+        auto queuedTicks = juce::Time::getHighResolutionTicks();
+
+        // Routes are never destroyed while the server is alive, so the callback is not copied for each request
+        connectionPool.addJob ([route = match.route, endpointMetrics, queuedTicks, request = std::move (request)]
         {
-            callback (std::move (request));
+            endpointMetrics->queueWait.recordSince (queuedTicks);
+            SessionTracer::getInstance()->addSpan ("server", "queue", queuedTicks, juce::Time::getHighResolutionTicks());
+
+            ScopedEndpointMetrics scope (endpointMetrics);
+            ScopedTraceSpan span ("endpoint", endpointMetrics->path);
+
+            auto callbackStartTicks = juce::Time::getHighResolutionTicks();
+            route->callback (std::move (request));
+            endpointMetrics->callbackTime.recordSince (callbackStartTicks);
         });
     }
 }
@@ -408,50 +742,123 @@ void AutomationServer::handleApplicationJsonRequest (Request request)
 
 void AutomationServer::handlePythonScriptRequest (Request request)
 {
-    juce::MessageManager::callAsync ([this, request = std::move (request)]
+    pythonMetrics->numRequests.fetch_add (1, std::memory_order_relaxed);
+    pythonMetrics->bytesIn.fetch_add (static_cast<juce::uint64> (request.contentData.getNumBytesAsUTF8()), std::memory_order_relaxed);
+
+    ScopedEndpointMetrics scope (pythonMetrics);
+
+    AsyncLogger::getInstance()->logPayload ("request", pythonMetrics->path, request.contentData);
+
+    // Scripts can be accounted for the memory they use, the report replaces their result
+    const auto memoryReportHeader = request.headers ["X-Straw-Memory-Report"];
+    const bool withMemoryReport = memoryReportHeader == "1" || memoryReportHeader.equalsIgnoreCase ("true");
+
+    callOnMessageThread ([this, withMemoryReport, request = std::move (request)]() mutable
     {
-        popsicle::ScriptEngine engine ([this]
+        runPythonScript (std::move (request), withMemoryReport);
+    });
+}
+
+void AutomationServer::runPythonScript (Request request, bool withMemoryReport)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // Scripts pump the message loop while waiting for clicks and gestures, a script received meanwhile must not run nested in the same interpreter
+    if (isRunningScript)
+    {
+        pendingScripts.push_back ([this, withMemoryReport, request = std::move (request)]() mutable
         {
-            juce::StringArray modules{ "straw" };
+            runPythonScript (std::move (request), withMemoryReport);
+        });
 
-            {
-                auto lock = juce::CriticalSection::ScopedLockType (callbacksLock);
-                modules.addArray (modulesToImport);
-            }
+        return;
+    }
+
+    auto& engine = getScriptEngine();
 
-            modules.removeDuplicates (false);
-            return modules;
-        }());
+    if (withMemoryReport)
+        MemoryTracker::getInstance()->beginReport();
 
-        auto result = engine.runScript (request.contentData);
+    auto result = [&]
+    {
+        const juce::ScopedValueSetter<bool> runningScript (isRunningScript, true);
+
+        ScopedTraceSpan span ("python", "script");
+        return engine.runScript (request.contentData);
+    }();
+
+    auto memoryReport = withMemoryReport ? MemoryTracker::getInstance()->endReport() : juce::var();
+
+    connectionPool.addJob ([result = std::move (result), memoryReport = std::move (memoryReport), request = std::move (request), endpointMetrics = ScopedEndpointMetrics::getCurrent()]
+    {
+        ScopedEndpointMetrics scope (endpointMetrics);
 
-        connectionPool.addJob ([result = std::move (result), request = std::move (request)]
+        if (result.failed())
         {
-            if (result.failed())
-            {
-                sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
-            }
-            else
-            {
-                sendHttpResultResponse (true, 200, *request.connection);
-            }
-        });
+            sendHttpErrorResponse (result.getErrorMessage(), 500, *request.connection);
+        }
+        else
+        {
+            sendHttpResultResponse (memoryReport.isVoid() ? juce::var (true) : memoryReport, 200, *request.connection);
+        }
     });
+
+    if (! pendingScripts.empty())
+    {
+        auto nextScript = std::move (pendingScripts.front());
+        pendingScripts.pop_front();
+
+        callOnMessageThread (std::move (nextScript));
+    }
+}
+
+//=================================================================================================
+
+void AutomationServer::handleMetricsRequest (Request request)
+{
+    auto content = metrics.toPrometheus (connectionPool.getNumJobs(), connectionPool.getNumThreads());
+
+    juce::MemoryBlock mb (content.toRawUTF8(), content.getNumBytesAsUTF8());
+    sendHttpResponse (mb, "text/plain; version=0.0.4", 200, *request.connection);
+}
+
+void AutomationServer::handleHealthRequest (Request request)
+{
+    // Answered from the server threads, so it reports liveness even when the message thread is busy
+    juce::DynamicObject::Ptr health = new juce::DynamicObject;
+    health->setProperty ("status", "ok");
+    health->setProperty ("python", pythonStateToString (pythonState));
+    health->setProperty ("uptime", (juce::Time::currentTimeMillis() - startTimeMilliseconds.load()) / 1000.0);
+
+    sendHttpResultResponse (health.get(), 200, *request.connection);
 }
 
 //=================================================================================================
 
 void AutomationServer::registerEndpoint (juce::StringRef path, EndpointCallback callback)
 {
-    auto lock = juce::CriticalSection::ScopedLockType (callbacksLock);
+    registerEndpoint ("*", path, std::move (callback));
+}
 
-    callbacks [path] = std::move (callback);
+void AutomationServer::registerEndpoint (juce::StringRef verb, juce::StringRef path, EndpointCallback callback)
+{
+    // Metrics are accounted per pattern, so parameters don't explode the number of series
+    router.addRoute (verb, path, std::move (callback), metrics.getEndpointMetrics (path));
 }
 
 void AutomationServer::registerDefaultEndpoints()
 {
     // General
     registerEndpoint ("/straw/sleep", &Endpoints::sleep);
+    registerEndpoint ("/straw/metrics", [this] (Request request) { handleMetricsRequest (std::move (request)); });
+    registerEndpoint ("/straw/health", [this] (Request request) { handleHealthRequest (std::move (request)); });
+    registerEndpoint ("/straw/time/advance", &Endpoints::timeAdvance);
+    registerEndpoint ("/straw/time/warp", &Endpoints::timeWarp);
+    registerEndpoint ("/straw/time/real", &Endpoints::timeReal);
+    registerEndpoint ("/straw/state/capture", &Endpoints::stateCapture);
+    registerEndpoint ("/straw/state/restore", &Endpoints::stateRestore);
+    registerEndpoint ("/straw/state/list", &Endpoints::stateList);
+    registerEndpoint ("/straw/memory", &Endpoints::memorySnapshot);
 
     // Components
     registerEndpoint ("/straw/component/exists", &Endpoints::componentExists);
@@ -459,6 +866,47 @@ void AutomationServer::registerDefaultEndpoints()
     registerEndpoint ("/straw/component/info", &Endpoints::componentInfo);
     registerEndpoint ("/straw/component/click", &Endpoints::componentClick);
     registerEndpoint ("/straw/component/render", &Endpoints::componentRender);
+    registerEndpoint ("/straw/component/at", &Endpoints::componentAt);
+    registerEndpoint ("/straw/component/find", &Endpoints::componentFind);
+    registerEndpoint ("/straw/accessibility/find", &Endpoints::accessibilityFind);
+    registerEndpoint ("/straw/accessibility/snapshot", &Endpoints::accessibilitySnapshot);
+    registerEndpoint ("GET", "/straw/component/{id}/exists", &Endpoints::componentExists);
+    registerEndpoint ("GET", "/straw/component/{id}/visible", &Endpoints::componentVisible);
+    registerEndpoint ("GET", "/straw/component/{id}/info", &Endpoints::componentInfo);
+    registerEndpoint ("POST", "/straw/component/{id}/click", &Endpoints::componentClick);
+    registerEndpoint ("GET", "/straw/component/{id}/render", &Endpoints::componentRender);
+
+    // Input
+    registerEndpoint ("/straw/gesture/play", &Endpoints::gesturePlay);
+    registerEndpoint ("/straw/recorder/start", &Endpoints::recorderStart);
+    registerEndpoint ("/straw/recorder/stop", &Endpoints::recorderStop);
+    registerEndpoint ("/straw/recorder/replay", &Endpoints::recorderReplay);
+
+    // Diagnostics
+    registerEndpoint ("/straw/trace/hops", &Endpoints::traceHops);
+    registerEndpoint ("/straw/trace/hops/chrome", &Endpoints::traceHopsChrome);
+    registerEndpoint ("/straw/trace/stalls/configure", &Endpoints::traceStallsConfigure);
+    registerEndpoint ("/straw/trace/session/start", &Endpoints::traceSessionStart);
+    registerEndpoint ("/straw/trace/session/stop", &Endpoints::traceSessionStop);
+    registerEndpoint ("/straw/trace/session/dump", &Endpoints::traceSessionDump);
+    registerEndpoint ("/straw/log/configure", &Endpoints::logConfigure);
+    registerEndpoint ("/straw/profile/paint", &Endpoints::profilePaint);
+    registerEndpoint ("/straw/frames/start", &Endpoints::framesStart);
+    registerEndpoint ("/straw/frames/stop", &Endpoints::framesStop);
+    registerEndpoint ("/straw/frames/stats", &Endpoints::framesStats);
+
+   #if STRAW_AUDIO_ANALYSIS_AVAILABLE
+    // Audio
+    registerEndpoint ("/straw/audio/taps", &Endpoints::audioTaps);
+    registerEndpoint ("/straw/audio/levels", &Endpoints::audioLevels);
+    registerEndpoint ("/straw/audio/spectrum", &Endpoints::audioSpectrum);
+    registerEndpoint ("/straw/audio/latency", &Endpoints::audioLatency);
+   #endif
+
+   #if STRAW_OFFLINE_RENDERING_AVAILABLE
+    registerEndpoint ("/straw/audio/processors", &Endpoints::audioProcessors);
+    registerEndpoint ("/straw/audio/render", &Endpoints::audioRender);
+   #endif
 }
 
 //=================================================================================================
@@ -488,7 +936,7 @@ void AutomationServer::registerDefaultComponents()
 
 void AutomationServer::registerCustomPythonModules (std::initializer_list<const char*> modules)
 {
-    auto lock = juce::CriticalSection::ScopedLockType (callbacksLock);
+    auto lock = juce::CriticalSection::ScopedLockType (modulesLock);
 
     for (const auto& m : modules)
         modulesToImport.add (m);
@@ -502,4 +950,19 @@ juce::File AutomationServer::getLocalRunFile() const
     return applicationFile.getParentDirectory().getChildFile ("straw.run");
 }
 
+juce::File AutomationServer::getRegistryFile() const
+{
+    return getRegistryDirectory().getChildFile (juce::String (Helpers::getCurrentProcessId()) + ".run");
+}
+
+juce::File AutomationServer::getRegistryDirectory()
+{
+    auto registryPath = juce::SystemStats::getEnvironmentVariable ("STRAW_REGISTRY_DIR", {});
+    if (registryPath.isNotEmpty() && juce::File::isAbsolutePath (registryPath))
+        return juce::File (registryPath);
+
+    juce::File applicationFile = juce::File::getSpecialLocation (juce::File::currentApplicationFile);
+    return applicationFile.getParentDirectory().getChildFile ("straw.run.d");
+}
+
 } // namespace straw
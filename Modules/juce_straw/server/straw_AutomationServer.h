@@ -25,15 +25,21 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_python/juce_python.h>
 
+#include "straw_Connection.h"
 #include "straw_Request.h"
+#include "straw_Router.h"
+#include "straw_SharedMemoryRing.h"
+#include "straw_UnixSocket.h"
+#include "../diagnostics/straw_Metrics.h"
 //#include "../scripting/straw_ScriptEngine.h"
 //#include "../scripting/straw_ScriptBindings.h"
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
-#include <unordered_map>
 #include <variant>
 
 namespace straw {
@@ -48,9 +54,9 @@ namespace straw {
  *
  * @param response The `juce::var` containing the response body data.
  * @param status The HTTP status code to be included in the response.
- * @param connection The `StreamingSocket` used to send the response.
+ * @param connection The `Connection` used to send the response.
  */
-void sendHttpResponse (const juce::var& response, int status, juce::StreamingSocket& connection);
+void sendHttpResponse (const juce::var& response, int status, Connection& connection);
 
 /**
  * @brief Send an HTTP response using a MemoryBlock.
@@ -61,9 +67,9 @@ void sendHttpResponse (const juce::var& response, int status, juce::StreamingSoc
  * @param response The `MemoryBlock` containing the response body data.
  * @param contentType The content type of the response (e.g., "application/json").
  * @param status The HTTP status code to be included in the response.
- * @param connection The `StreamingSocket` used to send the response.
+ * @param connection The `Connection` used to send the response.
  */
-void sendHttpResponse (const juce::MemoryBlock& response, juce::StringRef contentType, int status, juce::StreamingSocket& connection);
+void sendHttpResponse (const juce::MemoryBlock& response, juce::StringRef contentType, int status, Connection& connection);
 
 /**
  * @brief Send an HTTP response containing an image.
@@ -72,9 +78,9 @@ void sendHttpResponse (const juce::MemoryBlock& response, juce::StringRef conten
  *
  * @param image The `juce::Image` to be included in the response.
  * @param status The HTTP status code to be included in the response.
- * @param connection The `StreamingSocket` used to send the response.
+ * @param connection The `Connection` used to send the response.
  */
-void sendHttpResponse (const juce::Image& image, int status, juce::StreamingSocket& connection);
+void sendHttpResponse (const juce::Image& image, int status, Connection& connection);
 
 //=================================================================================================
 
@@ -82,25 +88,40 @@ void sendHttpResponse (const juce::Image& image, int status, juce::StreamingSock
  * @brief Send an HTTP result message response.
  *
  * This function sends an HTTP response with an result message. It allows you to specify the result value, HTTP status code, and the
- * `StreamingSocket` to send the response.
+ * `Connection` to send the response.
  *
  * @param result The result object to be included in the response.
  * @param status The HTTP status code to be included in the response.
- * @param connection The `StreamingSocket` used to send the response.
+ * @param connection The `Connection` used to send the response.
  */
-void sendHttpResultResponse (const juce::var& result, int status, juce::StreamingSocket& connection);
+void sendHttpResultResponse (const juce::var& result, int status, Connection& connection);
 
 /**
  * @brief Send an HTTP error message response.
  *
  * This function sends an HTTP response with an error message. It allows you to specify the error message, HTTP status code, and the
- * `StreamingSocket` to send the response.
+ * `Connection` to send the response.
  *
  * @param message The error message to be included in the response.
  * @param status The HTTP status code to be included in the response.
- * @param connection The `StreamingSocket` used to send the response.
+ * @param connection The `Connection` used to send the response.
  */
-void sendHttpErrorResponse (juce::StringRef message, int status, juce::StreamingSocket& connection);
+void sendHttpErrorResponse (juce::StringRef message, int status, Connection& connection);
+
+//=================================================================================================
+
+/**
+ * @brief Post a function to be executed on the message thread.
+ *
+ * This behaves like `juce::MessageManager::callAsync`, but it also accounts the time spent waiting for the message thread
+ * and the time spent executing the function to the endpoint being served by the calling thread, if any. Endpoints should
+ * prefer this when hopping to the message thread.
+ *
+ * @param function The function to execute on the message thread.
+ *
+ * @return True if the message was successfully posted.
+ */
+bool callOnMessageThread (std::function<void()> function);
 
 //=================================================================================================
 
@@ -121,6 +142,23 @@ public:
      */
     using EndpointCallback = std::function<void (Request)>;
 
+    /**
+     * @brief Callback type invoked on the message thread when an asynchronous start completes.
+     *
+     * @param result The outcome of the start.
+     */
+    using StartCallback = std::function<void (juce::Result)>;
+
+    /**
+     * @brief The readiness of the embedded python interpreter.
+     */
+    enum class PythonState
+    {
+        cold,       ///< The interpreter has not been initialised yet.
+        warming,    ///< The interpreter is being initialised.
+        ready       ///< The interpreter is initialised and scripts run without startup costs.
+    };
+
     /**
      * @brief Constructor for the AutomationServer class.
      */
@@ -134,11 +172,31 @@ public:
     /**
      * @brief Starts the automation server on the specified port.
      *
-     * @param port The port number on which the server should listen. Default is 8001.
+     * Without a port, the server listens on the default port 8001 and falls back to a free port picked by the system when the
+     * default one is taken. Pass 0 to always let the system pick a free port. The port in use is returned by `getPort`, and
+     * published in the instance registry.
+     *
+     * When a socket file is specified, the server also accepts same host clients on a Unix domain socket at that path, which is
+     * published in the instance registry as `unix_socket`. Unix domain sockets are not supported on Windows.
+     *
+     * @param port The port number on which the server should listen.
+     * @param unixSocketFile The path of the Unix domain socket on which the server should also listen, if any.
      *
      * @return A juce::Result indicating the success or failure of the server start operation.
      */
-    [[nodiscard]] juce::Result start (std::optional<int> port = std::nullopt);
+    [[nodiscard]] juce::Result start (std::optional<int> port = std::nullopt, const juce::File& unixSocketFile = {});
+
+    /**
+     * @brief Starts the automation server in the background, without blocking the caller.
+     *
+     * Binding the sockets and publishing the instance registry entry happen on a server thread, so this can be called from
+     * `JUCEApplication::initialise` without delaying the application startup. The outcome is logged when the start fails.
+     *
+     * @param port The port number on which the server should listen, see `start`.
+     * @param unixSocketFile The path of the Unix domain socket on which the server should also listen, see `start`.
+     * @param callback The optional callback invoked on the message thread once the server is started or failed to start.
+     */
+    void startAsync (std::optional<int> port = std::nullopt, const juce::File& unixSocketFile = {}, StartCallback callback = nullptr);
 
     /**
      * @brief Stops the automation server.
@@ -147,21 +205,76 @@ public:
      */
     void stop();
 
+    /**
+     * @brief Enable or disable the initialisation of the python interpreter in the background once the server is started.
+     *
+     * Enabled by default, so the first script doesn't pay the interpreter startup. When disabled, the interpreter is
+     * initialised on demand by the first script. In both cases it's initialised on the message thread, in a posted message,
+     * and kept alive to run all the following scripts.
+     *
+     * @param shouldWarmUp True to initialise the interpreter in the background.
+     */
+    void setPythonWarmUpEnabled (bool shouldWarmUp);
+
+    /**
+     * @brief Get the readiness of the embedded python interpreter.
+     *
+     * It's also published as `python` in the instance registry, and returned by the `/straw/health` endpoint.
+     */
+    [[nodiscard]] PythonState getPythonState() const;
+
     /**
      * @brief Get the current port being used.
      */
     [[nodiscard]] std::optional<int> getPort() const;
 
+    /**
+     * @brief Get the Unix domain socket file being listened on, if any.
+     */
+    [[nodiscard]] std::optional<juce::File> getUnixSocketFile() const;
+
+    /**
+     * @brief Get the directory where the running instances are registered.
+     *
+     * Each running server writes a `<pid>.run` file with its `pid`, `port`, `name`, `executable`, `started` time, `python`
+     * readiness and optional `unix_socket` path as `key=value` lines, updated when the readiness changes, atomically replaced so readers never see partial entries, and removed when the server stops.
+     * The directory is `straw.run.d` next to the application, unless the `STRAW_REGISTRY_DIR` environment variable points
+     * to an absolute path.
+     */
+    [[nodiscard]] static juce::File getRegistryDirectory();
+
+    /**
+     * @brief Get the metrics collected by the server.
+     *
+     * The same metrics are exposed in the Prometheus text format at the `/straw/metrics` endpoint.
+     */
+    [[nodiscard]] const ServerMetrics& getMetrics() const;
+
     /**
      * @brief Registers an endpoint with a callback function.
      *
      * Clients can register custom endpoints using this function. When a request is received at the specified path, the associated callback function will be called.
      *
+     * The path can contain `{name}` parameters matching a single segment and end with a `*` wildcard matching the remaining
+     * segments, like `/straw/component/{id}/info`. Parameters are available in `Request::parameters`, and are also set as
+     * properties of the request data so endpoints read them like properties of the body.
+     *
      * @param path The path for the endpoint.
      * @param callback The callback function to handle requests for this endpoint.
      */
     void registerEndpoint (juce::StringRef path, EndpointCallback callback);
 
+    /**
+     * @brief Registers an endpoint responding only to a specific HTTP verb.
+     *
+     * Requests matching the path with another verb are answered with a 405 status.
+     *
+     * @param verb The HTTP verb of the endpoint, like `GET` or `POST`.
+     * @param path The path for the endpoint.
+     * @param callback The callback function to handle requests for this endpoint.
+     */
+    void registerEndpoint (juce::StringRef verb, juce::StringRef path, EndpointCallback callback);
+
     /**
      * @brief Registers default endpoints for common operations.
      *
@@ -199,20 +312,54 @@ private:
     void run() override;
 
     juce::File getLocalRunFile() const;
+    juce::File getRegistryFile() const;
     void updateLocalRunFile();
+    void removeLocalRunFile();
+
+    std::shared_ptr<SharedMemoryRing> getSharedMemoryRing();
 
-    void handleConnection (std::shared_ptr<juce::StreamingSocket> connection);
-    void handleApplicationJsonRequest (Request request);
+    void handleConnection (std::shared_ptr<Connection> connection);
+    void handleEndpointRequest (Request request);
     void handlePythonScriptRequest (Request request);
+    void runPythonScript (Request request, bool withMemoryReport);
+    void handleMetricsRequest (Request request);
+    void handleHealthRequest (Request request);
+
+    juce::StringArray getPythonModules() const;
+    popsicle::ScriptEngine& getScriptEngine();
+    void setPythonState (PythonState newState);
+
+    class UnixSocketAcceptor;
 
     juce::StreamingSocket socket;
+    UnixSocketListener unixSocket;
+    std::unique_ptr<UnixSocketAcceptor> unixSocketAcceptor;
     juce::ThreadPool connectionPool;
 
-    juce::CriticalSection callbacksLock;
-    std::unordered_map<juce::String, EndpointCallback> callbacks;
+    juce::CriticalSection sharedMemoryLock;
+    std::shared_ptr<SharedMemoryRing> sharedMemoryRing;
+
+    ServerMetrics metrics;
+    std::shared_ptr<EndpointMetrics> pythonMetrics;
+
+    Router router;
+
+    juce::CriticalSection modulesLock;
     juce::StringArray modulesToImport;
 
-    std::optional<int> localPort;
+    std::unique_ptr<popsicle::ScriptEngine> scriptEngine;
+    juce::StringArray scriptEngineModules;
+    bool isRunningScript = false;
+    std::deque<std::function<void()>> pendingScripts;
+    std::atomic<PythonState> pythonState = PythonState::cold;
+    std::atomic<bool> isPythonWarmUpEnabled = true;
+
+    juce::CriticalSection startLock;
+    juce::CriticalSection runFileLock;
+    std::atomic<juce::int64> startTimeMilliseconds = 0;
+
+    static constexpr int defaultPort = 8001;
+    std::atomic<int> localPort = 0; // 0 when not listening
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationServer)
     JUCE_DECLARE_WEAK_REFERENCEABLE (AutomationServer)
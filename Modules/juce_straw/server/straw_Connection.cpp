@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Connection.h"
+#include "straw_SharedMemoryRing.h"
+
+namespace straw {
+
+//=================================================================================================
+
+void Connection::setSharedMemoryRing (std::shared_ptr<SharedMemoryRing> ring)
+{
+    sharedMemoryRing = std::move (ring);
+}
+
+SharedMemoryRing* Connection::getSharedMemoryRing() const
+{
+    return sharedMemoryRing.get();
+}
+
+void Connection::setResponseFormat (WireFormat format)
+{
+    responseFormat = format;
+}
+
+WireFormat Connection::getResponseFormat() const
+{
+    return responseFormat;
+}
+
+//=================================================================================================
+
+SocketConnection::SocketConnection (std::unique_ptr<juce::StreamingSocket> connectedSocket)
+    : socket (std::move (connectedSocket))
+{
+    jassert (socket != nullptr);
+}
+
+SocketConnection::~SocketConnection()
+{
+    close();
+}
+
+int SocketConnection::read (void* destBuffer, int maxBytesToRead, bool blockUntilSpecifiedAmountHasArrived)
+{
+    return socket->read (destBuffer, maxBytesToRead, blockUntilSpecifiedAmountHasArrived);
+}
+
+int SocketConnection::write (const void* sourceBuffer, int numBytesToWrite)
+{
+    return socket->write (sourceBuffer, numBytesToWrite);
+}
+
+int SocketConnection::waitUntilReady (bool readyForReading, int timeoutMsecs)
+{
+    return socket->waitUntilReady (readyForReading, timeoutMsecs);
+}
+
+void SocketConnection::close()
+{
+    socket->close();
+}
+
+bool SocketConnection::isLocal() const
+{
+    return socket->isLocal();
+}
+
+} // namespace straw
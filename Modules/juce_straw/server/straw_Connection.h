@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "../values/straw_WireFormat.h"
+
+#include <memory>
+
+namespace straw {
+
+class SharedMemoryRing;
+
+//=================================================================================================
+
+/**
+ * @brief A client connection to the automation server, carrying one HTTP request and its response.
+ *
+ * Connections abstract the transport, so the same request and response framing is used over TCP and Unix domain sockets.
+ */
+class Connection
+{
+public:
+    /**
+     * @brief Destructor for the Connection class, closes the connection.
+     */
+    virtual ~Connection() = default;
+
+    /**
+     * @brief Read data from the connection.
+     *
+     * @param destBuffer The buffer to read into.
+     * @param maxBytesToRead The maximum number of bytes to read.
+     * @param blockUntilSpecifiedAmountHasArrived If true, wait until the requested number of bytes has arrived.
+     *
+     * @return The number of bytes read, 0 when the connection was closed by the peer, or -1 on error.
+     */
+    virtual int read (void* destBuffer, int maxBytesToRead, bool blockUntilSpecifiedAmountHasArrived) = 0;
+
+    /**
+     * @brief Write data to the connection.
+     *
+     * @param sourceBuffer The data to write.
+     * @param numBytesToWrite The number of bytes to write.
+     *
+     * @return The number of bytes written, or -1 on error.
+     */
+    virtual int write (const void* sourceBuffer, int numBytesToWrite) = 0;
+
+    /**
+     * @brief Wait until the connection is ready for reading or writing.
+     *
+     * @param readyForReading True to wait for data to read, false to wait until data can be written.
+     * @param timeoutMsecs The timeout in milliseconds, negative to wait forever.
+     *
+     * @return 1 when ready, 0 on timeout, or -1 on error.
+     */
+    virtual int waitUntilReady (bool readyForReading, int timeoutMsecs) = 0;
+
+    /**
+     * @brief Close the connection.
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief Check if the peer runs on the same host, and can therefore receive responses through shared memory.
+     */
+    [[nodiscard]] virtual bool isLocal() const = 0;
+
+    /**
+     * @brief Set the shared memory ring bulk responses should be delivered through, if any.
+     */
+    void setSharedMemoryRing (std::shared_ptr<SharedMemoryRing> ring);
+
+    /**
+     * @brief Get the shared memory ring bulk responses should be delivered through, nullptr when not requested.
+     */
+    [[nodiscard]] SharedMemoryRing* getSharedMemoryRing() const;
+
+    /**
+     * @brief Set the wire format responses should be encoded in, as negotiated with the peer.
+     */
+    void setResponseFormat (WireFormat format);
+
+    /**
+     * @brief Get the wire format responses should be encoded in, JSON unless negotiated otherwise.
+     */
+    [[nodiscard]] WireFormat getResponseFormat() const;
+
+private:
+    std::shared_ptr<SharedMemoryRing> sharedMemoryRing;
+    WireFormat responseFormat = WireFormat::json;
+};
+
+//=================================================================================================
+
+/**
+ * @brief A connection over a TCP socket.
+ */
+class SocketConnection final : public Connection
+{
+public:
+    /**
+     * @brief Constructor for the SocketConnection class.
+     *
+     * @param socket The connected socket, owned by the connection.
+     */
+    explicit SocketConnection (std::unique_ptr<juce::StreamingSocket> socket);
+
+    /**
+     * @brief Destructor for the SocketConnection class.
+     */
+    ~SocketConnection() override;
+
+    /** @internal */
+    int read (void* destBuffer, int maxBytesToRead, bool blockUntilSpecifiedAmountHasArrived) override;
+    /** @internal */
+    int write (const void* sourceBuffer, int numBytesToWrite) override;
+    /** @internal */
+    int waitUntilReady (bool readyForReading, int timeoutMsecs) override;
+    /** @internal */
+    void close() override;
+    /** @internal */
+    bool isLocal() const override;
+
+private:
+    std::unique_ptr<juce::StreamingSocket> socket;
+
+    JUCE_DECLARE_NON_COPYABLE (SocketConnection)
+};
+
+} // namespace straw
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Http.h"
+
+#include <unordered_map>
+
+namespace straw::Http {
+
+//=================================================================================================
+
+bool startsWithHttpVerb (const juce::String& httpLine)
+{
+    return httpLine.startsWith ("GET")
+        || httpLine.startsWith ("PUT")
+        || httpLine.startsWith ("POST")
+        || httpLine.startsWith ("DELETE");
+}
+
+//=================================================================================================
+
+juce::String makeHttpStatusCode (int statusCode)
+{
+    static const std::unordered_map<int, juce::String> httpStatusCodes
+    {
+        { 100, "100 Continue" },
+        { 200, "200 OK" },
+        { 404, "404 Not Found" },
+        { 405, "405 Method Not Allowed" },
+        { 500, "500 Internal Server Error" }
+    };
+
+    auto it = httpStatusCodes.find (statusCode);
+    if (it == httpStatusCodes.end())
+        return "500 Internal Server Error";
+
+    return it->second;
+}
+
+//=================================================================================================
+
+namespace {
+
+void appendHttpHeaders (juce::String& response, const juce::StringPairArray& headers)
+{
+    for (int i = 0; i < headers.size(); ++i)
+        response << headers.getAllKeys() [i] << ": " << headers.getAllValues() [i] << "\n";
+
+    response << "\n";
+}
+
+} // namespace
+
+//=================================================================================================
+
+juce::MemoryBlock makeHttpResponse (const juce::String& payload, const juce::String& contentType, int status, const juce::StringPairArray& extraHeaders)
+{
+    juce::String response;
+
+    response
+    << "HTTP/1.1 " << makeHttpStatusCode (status) << "\n"
+    << "Server: Squeeze/0.0.1" << "\n"
+    << "Content-Type: " << contentType << "\n"
+    << "Content-Length: " << payload.getNumBytesAsUTF8() << "\n"
+    << "Connection: Closed" << "\n";
+
+    appendHttpHeaders (response, extraHeaders);
+
+    juce::MemoryBlock mb;
+    mb.append (response.toRawUTF8(), response.getNumBytesAsUTF8());
+    mb.append (payload.toRawUTF8(), payload.getNumBytesAsUTF8());
+    return mb;
+}
+
+juce::MemoryBlock makeHttpResponse (const juce::MemoryBlock& payload, const juce::String& contentType, int status, const juce::StringPairArray& extraHeaders)
+{
+    juce::String response;
+
+    response
+    << "HTTP/1.1 " << makeHttpStatusCode (status) << "\n"
+    << "Server: Squeeze/0.0.1" << "\n"
+    << "Content-Type: " << contentType << "\n"
+    << "Content-Length: " << payload.getSize() << "\n"
+    << "Connection: Closed" << "\n";
+
+    appendHttpHeaders (response, extraHeaders);
+
+    juce::MemoryBlock mb;
+    mb.append (response.toRawUTF8(), response.getNumBytesAsUTF8());
+    mb.append (payload.getData(), payload.getSize());
+    return mb;
+}
+
+//=================================================================================================
+
+juce::MemoryBlock readHttpPayload (Connection& connection)
+{
+    juce::MemoryBlock payload;
+    juce::uint8 data[1024] = { 0 };
+
+    while (true)
+    {
+        auto numBytesRead = connection.read (data, juce::numElementsInArray (data), false);
+        if (numBytesRead <= 0)
+            break;
+
+        payload.append (data, static_cast<size_t> (numBytesRead));
+    }
+
+    return payload;
+}
+
+//=================================================================================================
+
+Request parseHttpPayload (const juce::String& payload)
+{
+    Request request;
+
+    auto requestStrings = juce::StringArray::fromLines (payload);
+    for (int i = 0; i < requestStrings.size(); ++i)
+    {
+        const auto& requestString = requestStrings [i];
+        //juce::Logger::writeToLog (requestString);
+
+        if (startsWithHttpVerb (requestString))
+        {
+            auto pathParts = juce::StringArray::fromTokens (requestString, false);
+            if (pathParts.size() >= 1)
+                request.verb = pathParts [0];
+            if (pathParts.size() >= 2)
+                request.path = pathParts [1];
+        }
+        else if (requestString.startsWith ("Content-Type: "))
+        {
+            request.headers.set ("Content-Type", requestString.fromFirstOccurrenceOf ("Content-Type: ", false, true));
+
+            request.contentType = requestString
+                .fromFirstOccurrenceOf ("Content-Type: ", false, true)
+                .upToFirstOccurrenceOf (";", false, false);
+        }
+        else if (requestString.startsWith ("Content-Length: "))
+        {
+            request.headers.set ("Content-Length", requestString.fromFirstOccurrenceOf ("Content-Length: ", false, true));
+
+            request.contentLength = requestString.fromFirstOccurrenceOf ("Content-Length: ", false, true).getIntValue();
+        }
+        else if (requestString.isNotEmpty() && requestString.containsChar (':'))
+        {
+            request.headers.set (requestString.upToFirstOccurrenceOf (":", false, false).trim(),
+                                 requestString.fromFirstOccurrenceOf (":", false, false).trim());
+        }
+        else if (requestString.isEmpty())
+        {
+            auto remainingPayload = requestStrings;
+            remainingPayload.removeRange (0, i + 1);
+
+            request.contentData = remainingPayload.joinIntoString ("\n");
+
+            break;
+        }
+    }
+
+    return request;
+}
+
+Request parseHttpPayload (const juce::MemoryBlock& payload)
+{
+    const auto* data = static_cast<const char*> (payload.getData());
+    const auto size = payload.getSize();
+
+    // Locate the end of the headers, accepting both CRLF and bare LF line endings
+    std::size_t contentOffset = size;
+    for (std::size_t i = 0; i + 1 < size; ++i)
+    {
+        if (data [i] != '\n')
+            continue;
+
+        if (data [i + 1] == '\n')
+        {
+            contentOffset = i + 2;
+            break;
+        }
+
+        if (data [i + 1] == '\r' && i + 2 < size && data [i + 2] == '\n')
+        {
+            contentOffset = i + 3;
+            break;
+        }
+    }
+
+    // Binary bodies are not valid text, so only the headers are parsed as such
+    auto request = parseHttpPayload (juce::String::fromUTF8 (data, static_cast<int> (contentOffset)));
+
+    auto format = wireFormatFromMimeType (request.contentType);
+    if (! format.has_value() || ! isBinaryWireFormat (*format))
+        return parseHttpPayload (payload.toString());
+
+    request.contentBinary = juce::MemoryBlock (data + contentOffset, size - contentOffset);
+
+    return request;
+}
+
+//=================================================================================================
+
+WireFormat negotiateResponseFormat (const Request& request)
+{
+    for (const auto& acceptedType : juce::StringArray::fromTokens (request.headers ["Accept"], ",", {}))
+    {
+        if (auto format = wireFormatFromMimeType (acceptedType))
+            return *format;
+    }
+
+    return wireFormatFromMimeType (request.contentType).value_or (WireFormat::json);
+}
+
+} // namespace straw::Http
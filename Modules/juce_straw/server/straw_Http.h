@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "straw_Request.h"
+#include "../values/straw_WireFormat.h"
+
+namespace straw::Http {
+
+//=================================================================================================
+
+/**
+ * @brief Check if a line of an HTTP request is the request line, starting with a supported verb.
+ *
+ * @param httpLine The line to check.
+ *
+ * @return True if the line starts with one of the supported HTTP verbs.
+ */
+bool startsWithHttpVerb (const juce::String& httpLine);
+
+/**
+ * @brief Make the status line text of an HTTP status code.
+ *
+ * @param statusCode The HTTP status code.
+ *
+ * @return The status code followed by its reason phrase, a 500 status for unsupported codes.
+ */
+juce::String makeHttpStatusCode (int statusCode);
+
+//=================================================================================================
+
+/**
+ * @brief Make a complete HTTP response, headers and payload.
+ *
+ * @param payload The text payload of the response.
+ * @param contentType The content type of the payload.
+ * @param status The HTTP status code of the response.
+ * @param extraHeaders Additional headers to send with the response.
+ *
+ * @return The response ready to be written to the connection.
+ */
+juce::MemoryBlock makeHttpResponse (const juce::String& payload, const juce::String& contentType, int status = 200, const juce::StringPairArray& extraHeaders = {});
+
+/**
+ * @brief Make a complete HTTP response, headers and payload.
+ *
+ * @param payload The binary payload of the response.
+ * @param contentType The content type of the payload.
+ * @param status The HTTP status code of the response.
+ * @param extraHeaders Additional headers to send with the response.
+ *
+ * @return The response ready to be written to the connection.
+ */
+juce::MemoryBlock makeHttpResponse (const juce::MemoryBlock& payload, const juce::String& contentType, int status = 200, const juce::StringPairArray& extraHeaders = {});
+
+//=================================================================================================
+
+/**
+ * @brief Read all the data currently available from a connection.
+ *
+ * @param connection The connection to read from.
+ *
+ * @return The data read.
+ */
+juce::MemoryBlock readHttpPayload (Connection& connection);
+
+/**
+ * @brief Parse an HTTP request, extracting the verb, path, headers and content data.
+ *
+ * The connection and the parsed data of the returned request are left empty.
+ *
+ * @param payload The raw HTTP request.
+ *
+ * @return The parsed request.
+ */
+Request parseHttpPayload (const juce::String& payload);
+
+/**
+ * @brief Parse a raw HTTP request, extracting the verb, path, headers and content.
+ *
+ * Bodies in a binary wire format are stored untouched in the content binary of the request, other bodies are parsed as text
+ * in the content data.
+ *
+ * @param payload The raw HTTP request.
+ *
+ * @return The parsed request.
+ */
+Request parseHttpPayload (const juce::MemoryBlock& payload);
+
+/**
+ * @brief Choose the wire format of the response to a request.
+ *
+ * The first supported format listed in the `Accept` header wins, otherwise the response is sent in the format of the request
+ * body, falling back to JSON.
+ *
+ * @param request The request to respond to.
+ *
+ * @return The wire format of the response.
+ */
+WireFormat negotiateResponseFormat (const Request& request);
+
+} // namespace straw::Http
@@ -23,6 +23,8 @@
 
 #include <juce_core/juce_core.h>
 
+#include "straw_Connection.h"
+
 #include <memory>
 
 namespace straw {
@@ -33,12 +35,15 @@ struct Request
 {
     Request() = default;
 
-    std::shared_ptr<juce::StreamingSocket> connection;
+    std::shared_ptr<Connection> connection;
     juce::String verb;
     juce::String path;
+    juce::StringPairArray headers;
+    juce::StringPairArray parameters;
     int contentLength = 0;
     juce::String contentType;
     juce::String contentData;
+    juce::MemoryBlock contentBinary;
     juce::var data;
 };
 
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_Router.h"
+
+#include <algorithm>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+// Lower ranks are more specific
+int getSegmentRank (const juce::String& segment)
+{
+    if (segment == "*")
+        return 2;
+
+    if (segment.startsWithChar ('{') && segment.endsWithChar ('}'))
+        return 1;
+
+    return 0;
+}
+
+bool isPatternSegment (const juce::String& segment)
+{
+    return getSegmentRank (segment) != 0;
+}
+
+bool isMoreSpecificRoute (const Router::Route* lhs, const Router::Route* rhs)
+{
+    const auto numSegments = juce::jmin (lhs->segments.size(), rhs->segments.size());
+
+    for (int i = 0; i < numSegments; ++i)
+    {
+        const auto lhsRank = getSegmentRank (lhs->segments [i]);
+        const auto rhsRank = getSegmentRank (rhs->segments [i]);
+
+        if (lhsRank != rhsRank)
+            return lhsRank < rhsRank;
+    }
+
+    return lhs->segments.size() > rhs->segments.size();
+}
+
+bool isVerbAccepted (const Router::Route& route, juce::StringRef verb)
+{
+    return route.verb == "*" || route.verb.equalsIgnoreCase (verb);
+}
+
+juce::String makeRouteKey (const juce::StringArray& segments)
+{
+    return "/" + segments.joinIntoString ("/");
+}
+
+} // namespace
+
+//=================================================================================================
+
+Router::Router() = default;
+
+Router::~Router() = default;
+
+//=================================================================================================
+
+void Router::addRoute (juce::StringRef verb, juce::StringRef pattern, Callback callback, std::shared_ptr<EndpointMetrics> metrics)
+{
+    auto route = std::make_unique<Route>();
+    route->verb = verb.isEmpty() ? juce::String ("*") : juce::String (verb).toUpperCase();
+    route->pattern = pattern;
+    route->segments = splitPath (pattern);
+    route->callback = std::move (callback);
+    route->metrics = std::move (metrics);
+
+    const juce::ScopedLock lock (writeLock);
+
+    // Copy on write, the published table is never modified
+    std::vector<std::unique_ptr<Route>> routes;
+
+    if (auto table = currentTable.load (std::memory_order_acquire))
+    {
+        for (const auto& existingRoute : table->routes)
+        {
+            if (existingRoute->verb != route->verb || existingRoute->segments != route->segments)
+                routes.push_back (std::make_unique<Route> (*existingRoute));
+        }
+    }
+
+    routes.push_back (std::move (route));
+
+    auto newTable = makeRouteTable (std::move (routes));
+    currentTable.store (newTable.get(), std::memory_order_release);
+
+    tables.push_back (std::move (newTable));
+}
+
+//=================================================================================================
+
+Router::Match Router::findRoute (juce::StringRef verb, juce::StringRef path) const
+{
+    Match match;
+
+    auto table = currentTable.load (std::memory_order_acquire);
+    if (table == nullptr)
+        return match;
+
+    const auto pathSegments = splitPath (path);
+
+    if (auto it = table->exactRoutes.find (makeRouteKey (pathSegments)); it != table->exactRoutes.end())
+    {
+        for (auto route : it->second)
+        {
+            if (isVerbAccepted (*route, verb))
+            {
+                match.route = route;
+                return match;
+            }
+        }
+
+        match.isMethodNotAllowed = true;
+    }
+
+    for (auto route : table->patternRoutes)
+    {
+        juce::StringPairArray parameters;
+        if (! matchSegments (*route, pathSegments, parameters))
+            continue;
+
+        if (! isVerbAccepted (*route, verb))
+        {
+            match.isMethodNotAllowed = true;
+            continue;
+        }
+
+        match.route = route;
+        match.parameters = std::move (parameters);
+        match.isMethodNotAllowed = false;
+        return match;
+    }
+
+    return match;
+}
+
+//=================================================================================================
+
+juce::StringArray Router::splitPath (juce::StringRef path)
+{
+    auto segments = juce::StringArray::fromTokens (juce::String (path).upToFirstOccurrenceOf ("?", false, false), "/", {});
+    segments.removeEmptyStrings();
+    return segments;
+}
+
+//=================================================================================================
+
+std::unique_ptr<Router::RouteTable> Router::makeRouteTable (std::vector<std::unique_ptr<Route>> routes)
+{
+    auto table = std::make_unique<RouteTable>();
+    table->routes = std::move (routes);
+
+    for (const auto& route : table->routes)
+    {
+        if (std::any_of (route->segments.begin(), route->segments.end(), isPatternSegment))
+            table->patternRoutes.push_back (route.get());
+        else
+            table->exactRoutes [makeRouteKey (route->segments)].push_back (route.get());
+    }
+
+    std::stable_sort (table->patternRoutes.begin(), table->patternRoutes.end(), isMoreSpecificRoute);
+
+    return table;
+}
+
+bool Router::matchSegments (const Route& route, const juce::StringArray& pathSegments, juce::StringPairArray& parameters)
+{
+    for (int i = 0; i < route.segments.size(); ++i)
+    {
+        const auto& segment = route.segments [i];
+
+        switch (getSegmentRank (segment))
+        {
+            case 2:
+                parameters.set ("*", juce::URL::removeEscapeChars (pathSegments.joinIntoString ("/", i)));
+                return true;
+
+            case 1:
+                if (i >= pathSegments.size())
+                    return false;
+
+                parameters.set (segment.substring (1, segment.length() - 1), juce::URL::removeEscapeChars (pathSegments [i]));
+                break;
+
+            default:
+                if (i >= pathSegments.size() || segment != pathSegments [i])
+                    return false;
+
+                break;
+        }
+    }
+
+    return route.segments.size() == pathSegments.size();
+}
+
+} // namespace straw
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "straw_Request.h"
+#include "../diagnostics/straw_Metrics.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Maps HTTP verbs and paths to endpoint callbacks.
+ *
+ * Route patterns are made of `/` separated segments, each one being either a literal, a `{name}` parameter matching a
+ * single segment, or a trailing `*` matching all the remaining segments. Literal segments take precedence over parameters,
+ * which take precedence over wildcards, and exact routes are found with a single hash lookup.
+ *
+ * The route table is immutable once published: adding a route copies the current table and atomically swaps in the new
+ * one, so lookups never lock and never contend with each other. Replaced tables are retired but kept alive until the router
+ * is destroyed, as lookups in flight may still be using them. Routes are expected to be registered at startup.
+ */
+class Router
+{
+public:
+    /**
+     * @brief Callback type for handling routed requests.
+     */
+    using Callback = std::function<void (Request)>;
+
+    /**
+     * @brief A registered route.
+     */
+    struct Route
+    {
+        juce::String verb;
+        juce::String pattern;
+        juce::StringArray segments;
+        Callback callback;
+        std::shared_ptr<EndpointMetrics> metrics;
+    };
+
+    /**
+     * @brief The outcome of a route lookup.
+     */
+    struct Match
+    {
+        const Route* route = nullptr;
+        juce::StringPairArray parameters;
+        bool isMethodNotAllowed = false;
+    };
+
+    /**
+     * @brief Constructor for the Router class.
+     */
+    Router();
+
+    /**
+     * @brief Destructor for the Router class.
+     */
+    ~Router();
+
+    /**
+     * @brief Add a route, replacing any route with the same verb and pattern.
+     *
+     * @param verb The HTTP verb the route responds to, or `*` for any verb.
+     * @param pattern The path pattern of the route.
+     * @param callback The callback handling the requests.
+     * @param metrics The metrics to account the requests to.
+     */
+    void addRoute (juce::StringRef verb, juce::StringRef pattern, Callback callback, std::shared_ptr<EndpointMetrics> metrics);
+
+    /**
+     * @brief Find the route matching a request, without locking. Can be called from any thread.
+     *
+     * @param verb The HTTP verb of the request.
+     * @param path The path of the request, any query string is ignored.
+     *
+     * @return The matched route with its percent decoded parameters. When the path matches only routes with other verbs, the
+     * route is null and `isMethodNotAllowed` is set.
+     */
+    [[nodiscard]] Match findRoute (juce::StringRef verb, juce::StringRef path) const;
+
+    /**
+     * @brief Split a path or a pattern in its segments, ignoring empty segments and any query string.
+     */
+    [[nodiscard]] static juce::StringArray splitPath (juce::StringRef path);
+
+private:
+    struct RouteTable
+    {
+        std::vector<std::unique_ptr<Route>> routes;
+        std::unordered_map<juce::String, std::vector<const Route*>> exactRoutes;
+        std::vector<const Route*> patternRoutes;
+    };
+
+    static std::unique_ptr<RouteTable> makeRouteTable (std::vector<std::unique_ptr<Route>> routes);
+    static bool matchSegments (const Route& route, const juce::StringArray& pathSegments, juce::StringPairArray& parameters);
+
+    std::atomic<const RouteTable*> currentTable { nullptr };
+
+    juce::CriticalSection writeLock;
+    std::vector<std::unique_ptr<const RouteTable>> tables;
+
+    JUCE_DECLARE_NON_COPYABLE (Router)
+};
+
+} // namespace straw
@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_SharedMemoryRing.h"
+
+#include <cstring>
+
+#if ! JUCE_WINDOWS
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr const char sharedMemoryMagic[8] = { 'S', 'T', 'R', 'A', 'W', 'S', 'H', 'M' };
+constexpr juce::uint64 sharedMemoryVersion = 1;
+
+static_assert (std::atomic<juce::uint64>::is_always_lock_free, "Shared memory positions must be lock free");
+
+//=================================================================================================
+
+juce::Result createSharedMemoryFile (const juce::File& file, juce::int64 size)
+{
+   #if ! JUCE_WINDOWS
+    // Only readable by the current user, and never reusing a file someone else created
+    const auto handle = ::open (file.getFullPathName().toRawUTF8(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (handle == -1)
+        return juce::Result::fail ("Unable to create shared memory file " + file.getFullPathName());
+
+    // Extend the file to its full size without writing the whole data area
+    const auto truncated = ::ftruncate (handle, static_cast<off_t> (size)) == 0;
+    ::close (handle);
+
+    if (! truncated)
+    {
+        file.deleteFile();
+        return juce::Result::fail ("Unable to size shared memory file " + file.getFullPathName());
+    }
+   #else
+    // The temporary directory is private to the user on Windows
+    if (file.exists())
+        return juce::Result::fail ("Shared memory file already exists " + file.getFullPathName());
+
+    bool created = false;
+
+    {
+        // Extend the file to its full size without writing the whole data area
+        juce::FileOutputStream output (file);
+        created = ! output.failedToOpen()
+            && output.setPosition (size - 1)
+            && output.writeByte (0);
+    }
+
+    if (! created)
+    {
+        file.deleteFile();
+        return juce::Result::fail ("Unable to create shared memory file " + file.getFullPathName());
+    }
+   #endif
+
+    return juce::Result::ok();
+}
+
+} // namespace
+
+//=================================================================================================
+
+SharedMemoryRing::SharedMemoryRing (const juce::File& backingFile, std::size_t dataCapacity)
+    : file (backingFile)
+    , capacity (dataCapacity)
+{
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    mappedFile.reset();
+    file.deleteFile();
+}
+
+//=================================================================================================
+
+juce::Result SharedMemoryRing::create (const juce::File& file, std::size_t capacity, std::shared_ptr<SharedMemoryRing>& result)
+{
+    if (capacity == 0)
+        return juce::Result::fail ("Invalid shared memory capacity");
+
+    if (auto creation = createSharedMemoryFile (file, static_cast<juce::int64> (headerSize + capacity)); creation.failed())
+        return creation;
+
+    std::shared_ptr<SharedMemoryRing> ring (new SharedMemoryRing (file, capacity));
+
+    ring->mappedFile = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readWrite);
+
+    auto* data = static_cast<char*> (ring->mappedFile->getData());
+    if (data == nullptr || ring->mappedFile->getSize() < headerSize + capacity)
+        return juce::Result::fail ("Unable to map shared memory file " + file.getFullPathName());
+
+    auto header = juce::MemoryBlock (headerSize, true);
+    header.copyFrom (sharedMemoryMagic, 0, sizeof (sharedMemoryMagic));
+
+    // The header integers are little endian on all platforms
+    auto writeUint64 = [&header] (std::size_t offset, juce::uint64 value)
+    {
+        value = juce::ByteOrder::swapIfBigEndian (value);
+        header.copyFrom (&value, static_cast<int> (offset), sizeof (value));
+    };
+
+    writeUint64 (8, sharedMemoryVersion);
+    writeUint64 (16, static_cast<juce::uint64> (capacity));
+    std::memcpy (data, header.getData(), headerSize);
+
+    ring->reservedBytes = new (data + 24) std::atomic<juce::uint64> (0);
+
+    result = std::move (ring);
+    return juce::Result::ok();
+}
+
+//=================================================================================================
+
+std::optional<SharedMemoryRing::Block> SharedMemoryRing::write (const void* data, std::size_t size)
+{
+    if (size == 0 || size > capacity)
+        return std::nullopt;
+
+    auto lock = juce::CriticalSection::ScopedLockType (writeLock);
+
+    // Keep each payload contiguous, skipping the tail of the data area when the payload doesn't fit before wrapping
+    auto position = nextPosition;
+    if (position % capacity + size > capacity)
+        position += capacity - position % capacity;
+
+    nextPosition = position + size;
+
+    // Publish the reservation before overwriting, so readers of the overwritten payloads can detect it
+    reservedBytes->store (nextPosition, std::memory_order_seq_cst);
+
+    auto* destination = static_cast<char*> (mappedFile->getData()) + headerSize + position % capacity;
+    std::memcpy (destination, data, size);
+
+    std::atomic_thread_fence (std::memory_order_release);
+
+    return Block { position, static_cast<juce::uint64> (size) };
+}
+
+//=================================================================================================
+
+juce::File SharedMemoryRing::getFile() const
+{
+    return file;
+}
+
+std::size_t SharedMemoryRing::getCapacity() const
+{
+    return capacity;
+}
+
+} // namespace straw
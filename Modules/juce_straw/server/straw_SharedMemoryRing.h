@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A ring buffer in a memory mapped file, used to deliver bulk responses to same host clients without copying them
+ * through the socket.
+ *
+ * The file starts with a 64 bytes header: the `STRAWSHM` magic, the format version and the capacity of the data area as
+ * little endian 64 bits integers at offsets 8 and 16, and the total number of bytes reserved so far at offset 24, written
+ * atomically. Payloads are stored contiguously in the data area at `64 + position % capacity`, where `position` is the
+ * monotonically increasing position of the payload in the stream of all the payloads written.
+ *
+ * A client receiving a response with `X-Straw-Shm-Position` and `X-Straw-Shm-Size` headers copies the payload out of the data
+ * area and then checks that the total number of bytes reserved minus the position is still less than or equal to the
+ * capacity. If that's not the case the payload was overwritten while reading and the request must be repeated.
+ */
+class SharedMemoryRing
+{
+public:
+    /**
+     * @brief The smallest payload worth delivering through shared memory, smaller payloads are sent inline.
+     */
+    static constexpr std::size_t minimumPayloadSize = 64 * 1024;
+
+    /**
+     * @brief The default capacity of the data area.
+     */
+    static constexpr std::size_t defaultCapacity = 64 * 1024 * 1024;
+
+    /**
+     * @brief The position and size of a payload written in the ring.
+     */
+    struct Block
+    {
+        juce::uint64 position = 0;
+        juce::uint64 size = 0;
+    };
+
+    /**
+     * @brief Destructor for the SharedMemoryRing class, unmaps and removes the backing file.
+     */
+    ~SharedMemoryRing();
+
+    /**
+     * @brief Create a ring backed by a new file.
+     *
+     * The file is created readable and writable by the current user only, and creation fails if it already exists.
+     *
+     * @param file The backing file, which must not exist.
+     * @param capacity The capacity of the data area in bytes.
+     * @param result The created ring.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    [[nodiscard]] static juce::Result create (const juce::File& file, std::size_t capacity, std::shared_ptr<SharedMemoryRing>& result);
+
+    /**
+     * @brief Write a payload in the ring, overwriting the oldest payloads. Can be called from any thread.
+     *
+     * @param data The payload data.
+     * @param size The payload size in bytes.
+     *
+     * @return The block written, or nothing when the payload doesn't fit in the ring.
+     */
+    [[nodiscard]] std::optional<Block> write (const void* data, std::size_t size);
+
+    /**
+     * @brief Get the backing file of the ring, to be mapped by the clients.
+     */
+    [[nodiscard]] juce::File getFile() const;
+
+    /**
+     * @brief Get the capacity of the data area in bytes.
+     */
+    [[nodiscard]] std::size_t getCapacity() const;
+
+    /**
+     * @brief The size of the file header, preceding the data area.
+     */
+    static constexpr std::size_t headerSize = 64;
+
+private:
+    SharedMemoryRing (const juce::File& file, std::size_t capacity);
+
+    juce::File file;
+    std::size_t capacity = 0;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::atomic<juce::uint64>* reservedBytes = nullptr;
+
+    juce::CriticalSection writeLock;
+    juce::uint64 nextPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMemoryRing)
+};
+
+} // namespace straw
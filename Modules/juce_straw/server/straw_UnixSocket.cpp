@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_UnixSocket.h"
+
+#if ! JUCE_WINDOWS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace straw {
+
+//=================================================================================================
+
+#if ! JUCE_WINDOWS
+
+UnixSocketConnection::UnixSocketConnection (int socketHandle)
+    : handle (socketHandle)
+{
+   #if JUCE_MAC || JUCE_IOS
+    int noSigPipe = 1;
+    ::setsockopt (handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof (noSigPipe));
+   #endif
+}
+
+UnixSocketConnection::~UnixSocketConnection()
+{
+    close();
+}
+
+int UnixSocketConnection::read (void* destBuffer, int maxBytesToRead, bool blockUntilSpecifiedAmountHasArrived)
+{
+    int numBytesRead = 0;
+
+    while (numBytesRead < maxBytesToRead)
+    {
+        auto result = ::recv (handle, static_cast<char*> (destBuffer) + numBytesRead, static_cast<size_t> (maxBytesToRead - numBytesRead), 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return numBytesRead > 0 ? numBytesRead : -1;
+        }
+
+        if (result == 0)
+            break;
+
+        numBytesRead += static_cast<int> (result);
+
+        if (! blockUntilSpecifiedAmountHasArrived)
+            break;
+    }
+
+    return numBytesRead;
+}
+
+int UnixSocketConnection::write (const void* sourceBuffer, int numBytesToWrite)
+{
+   #if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+    constexpr int sendFlags = MSG_NOSIGNAL;
+   #else
+    constexpr int sendFlags = 0;
+   #endif
+
+    int numBytesWritten = 0;
+
+    while (numBytesWritten < numBytesToWrite)
+    {
+        auto result = ::send (handle, static_cast<const char*> (sourceBuffer) + numBytesWritten, static_cast<size_t> (numBytesToWrite - numBytesWritten), sendFlags);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        numBytesWritten += static_cast<int> (result);
+    }
+
+    return numBytesWritten;
+}
+
+int UnixSocketConnection::waitUntilReady (bool readyForReading, int timeoutMsecs)
+{
+    pollfd descriptor {};
+    descriptor.fd = handle;
+    descriptor.events = readyForReading ? POLLIN : POLLOUT;
+
+    auto result = ::poll (&descriptor, 1, timeoutMsecs);
+    if (result < 0)
+        return -1;
+
+    return result > 0 ? 1 : 0;
+}
+
+void UnixSocketConnection::close()
+{
+    if (handle >= 0)
+    {
+        ::close (handle);
+        handle = -1;
+    }
+}
+
+bool UnixSocketConnection::isLocal() const
+{
+    return true;
+}
+
+//=================================================================================================
+
+UnixSocketListener::~UnixSocketListener()
+{
+    close();
+}
+
+bool UnixSocketListener::isSupported()
+{
+    return true;
+}
+
+juce::Result UnixSocketListener::createListener (const juce::File& file)
+{
+    close();
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    auto path = file.getFullPathName();
+    if (static_cast<std::size_t> (path.getNumBytesAsUTF8()) >= sizeof (address.sun_path))
+        return juce::Result::fail ("Unix socket path is too long: " + path);
+
+    path.copyToUTF8 (address.sun_path, sizeof (address.sun_path));
+
+    // Remove the socket left behind by a crashed instance, connections to it would be refused anyway
+    file.deleteFile();
+
+    int newHandle = ::socket (AF_UNIX, SOCK_STREAM, 0);
+    if (newHandle < 0)
+        return juce::Result::fail ("Unable to create unix socket");
+
+    ::fcntl (newHandle, F_SETFD, FD_CLOEXEC);
+
+    if (::bind (newHandle, reinterpret_cast<sockaddr*> (&address), sizeof (address)) != 0
+        || ::listen (newHandle, SOMAXCONN) != 0)
+    {
+        auto errorMessage = juce::String (std::strerror (errno));
+        ::close (newHandle);
+        return juce::Result::fail ("Unable to listen to unix socket " + path + ": " + errorMessage);
+    }
+
+    socketFile = file;
+    handle.store (newHandle);
+
+    return juce::Result::ok();
+}
+
+std::unique_ptr<Connection> UnixSocketListener::waitForNextConnection (int timeoutMsecs)
+{
+    auto listenerHandle = handle.load();
+    if (listenerHandle < 0)
+        return nullptr;
+
+    pollfd descriptor {};
+    descriptor.fd = listenerHandle;
+    descriptor.events = POLLIN;
+
+    if (::poll (&descriptor, 1, timeoutMsecs) <= 0 || (descriptor.revents & POLLIN) == 0)
+        return nullptr;
+
+    int connectionHandle = ::accept (listenerHandle, nullptr, nullptr);
+    if (connectionHandle < 0)
+        return nullptr;
+
+    ::fcntl (connectionHandle, F_SETFD, FD_CLOEXEC);
+
+    return std::make_unique<UnixSocketConnection> (connectionHandle);
+}
+
+void UnixSocketListener::close()
+{
+    auto listenerHandle = handle.exchange (-1);
+    if (listenerHandle < 0)
+        return;
+
+    ::shutdown (listenerHandle, SHUT_RDWR);
+    ::close (listenerHandle);
+
+    socketFile.deleteFile();
+    socketFile = juce::File();
+}
+
+#else
+
+UnixSocketConnection::UnixSocketConnection (int socketHandle)
+    : handle (socketHandle)
+{
+    jassertfalse;
+}
+
+UnixSocketConnection::~UnixSocketConnection() = default;
+
+int UnixSocketConnection::read (void*, int, bool) { return -1; }
+int UnixSocketConnection::write (const void*, int) { return -1; }
+int UnixSocketConnection::waitUntilReady (bool, int) { return -1; }
+void UnixSocketConnection::close() {}
+bool UnixSocketConnection::isLocal() const { return true; }
+
+//=================================================================================================
+
+UnixSocketListener::~UnixSocketListener() = default;
+
+bool UnixSocketListener::isSupported()
+{
+    return false;
+}
+
+juce::Result UnixSocketListener::createListener (const juce::File&)
+{
+    return juce::Result::fail ("Unix domain sockets are not supported on this platform");
+}
+
+std::unique_ptr<Connection> UnixSocketListener::waitForNextConnection (int)
+{
+    return nullptr;
+}
+
+void UnixSocketListener::close()
+{
+}
+
+#endif
+
+//=================================================================================================
+
+bool UnixSocketListener::isListening() const
+{
+    return handle.load() >= 0;
+}
+
+juce::File UnixSocketListener::getSocketFile() const
+{
+    return socketFile;
+}
+
+} // namespace straw
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "straw_Connection.h"
+
+#include <atomic>
+#include <memory>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief A connection over a Unix domain socket.
+ */
+class UnixSocketConnection final : public Connection
+{
+public:
+    /**
+     * @brief Constructor for the UnixSocketConnection class.
+     *
+     * @param socketHandle The connected socket handle, owned by the connection.
+     */
+    explicit UnixSocketConnection (int socketHandle);
+
+    /**
+     * @brief Destructor for the UnixSocketConnection class.
+     */
+    ~UnixSocketConnection() override;
+
+    /** @internal */
+    int read (void* destBuffer, int maxBytesToRead, bool blockUntilSpecifiedAmountHasArrived) override;
+    /** @internal */
+    int write (const void* sourceBuffer, int numBytesToWrite) override;
+    /** @internal */
+    int waitUntilReady (bool readyForReading, int timeoutMsecs) override;
+    /** @internal */
+    void close() override;
+    /** @internal */
+    bool isLocal() const override;
+
+private:
+    int handle = -1;
+
+    JUCE_DECLARE_NON_COPYABLE (UnixSocketConnection)
+};
+
+//=================================================================================================
+
+/**
+ * @brief Listens for connections on a Unix domain socket.
+ *
+ * Same host clients connecting through the socket file skip the TCP stack entirely. Unix domain sockets are not supported
+ * on Windows.
+ */
+class UnixSocketListener
+{
+public:
+    /**
+     * @brief Constructor for the UnixSocketListener class.
+     */
+    UnixSocketListener() = default;
+
+    /**
+     * @brief Destructor for the UnixSocketListener class, closes the listener and removes the socket file.
+     */
+    ~UnixSocketListener();
+
+    /**
+     * @brief Check if Unix domain sockets are supported on this platform.
+     */
+    [[nodiscard]] static bool isSupported();
+
+    /**
+     * @brief Start listening on a socket file, replacing any stale socket file at the same path.
+     *
+     * @param file The path of the socket file.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    [[nodiscard]] juce::Result createListener (const juce::File& file);
+
+    /**
+     * @brief Wait for the next client connection.
+     *
+     * @param timeoutMsecs The maximum time to wait in milliseconds.
+     *
+     * @return The accepted connection, or nullptr on timeout, error or when the listener is closed.
+     */
+    [[nodiscard]] std::unique_ptr<Connection> waitForNextConnection (int timeoutMsecs);
+
+    /**
+     * @brief Stop listening and remove the socket file.
+     */
+    void close();
+
+    /**
+     * @brief Check if the listener is listening.
+     */
+    [[nodiscard]] bool isListening() const;
+
+    /**
+     * @brief Get the socket file the listener is listening on.
+     */
+    [[nodiscard]] juce::File getSocketFile() const;
+
+private:
+    std::atomic<int> handle { -1 };
+    juce::File socketFile;
+
+    JUCE_DECLARE_NON_COPYABLE (UnixSocketListener)
+};
+
+} // namespace straw
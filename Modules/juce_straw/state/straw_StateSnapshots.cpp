@@ -0,0 +1,389 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_StateSnapshots.h"
+
+#include "../values/straw_WireFormat.h"
+
+#include <algorithm>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+constexpr juce::int32 snapshotMagic = 0x4e535453; // STSN
+constexpr juce::int32 snapshotVersion = 1;
+
+// A provider without state: the string terminator and a single byte compressed size
+constexpr int minEncodedProviderSize = 2;
+
+//=================================================================================================
+
+void restoreValueTreeNode (juce::ValueTree& target, const juce::ValueTree& source, juce::UndoManager* undoManager)
+{
+    for (int index = target.getNumProperties(); --index >= 0;)
+    {
+        const auto name = target.getPropertyName (index);
+
+        if (! source.hasProperty (name))
+            target.removeProperty (name, undoManager);
+    }
+
+    // Setting an unchanged property doesn't notify the listeners
+    for (int index = 0; index < source.getNumProperties(); ++index)
+    {
+        const auto name = source.getPropertyName (index);
+        target.setProperty (name, source.getProperty (name), undoManager);
+    }
+
+    const auto numChildren = source.getNumChildren();
+
+    while (target.getNumChildren() > numChildren)
+        target.removeChild (target.getNumChildren() - 1, undoManager);
+
+    for (int index = 0; index < numChildren; ++index)
+    {
+        const auto sourceChild = source.getChild (index);
+
+        if (index < target.getNumChildren())
+        {
+            auto targetChild = target.getChild (index);
+
+            if (targetChild.getType() == sourceChild.getType())
+            {
+                restoreValueTreeNode (targetChild, sourceChild, undoManager);
+                continue;
+            }
+
+            target.removeChild (index, undoManager);
+        }
+
+        target.addChild (sourceChild.createCopy(), index, undoManager);
+    }
+}
+
+//=================================================================================================
+
+bool isSerialisableProperty (const juce::var& value)
+{
+    return ! value.isMethod() && (! value.isObject() || value.getDynamicObject() != nullptr);
+}
+
+void captureComponentProperties (juce::Component& component, juce::DynamicObject& result)
+{
+    if (const auto componentID = component.getComponentID(); componentID.isNotEmpty())
+    {
+        juce::DynamicObject::Ptr properties = new juce::DynamicObject;
+
+        for (const auto& property : component.getProperties())
+        {
+            if (isSerialisableProperty (property.value))
+                properties->setProperty (property.name, property.value);
+        }
+
+        result.setProperty (componentID, properties.get());
+    }
+
+    for (auto child : component.getChildren())
+        captureComponentProperties (*child, result);
+}
+
+void restoreComponentProperties (juce::Component& component, const juce::DynamicObject& snapshot)
+{
+    if (const auto componentID = component.getComponentID(); componentID.isNotEmpty())
+    {
+        if (auto snapshotProperties = snapshot.getProperty (componentID).getDynamicObject())
+        {
+            auto& properties = component.getProperties();
+
+            for (int index = properties.size(); --index >= 0;)
+            {
+                const auto name = properties.getName (index);
+
+                if (isSerialisableProperty (properties.getValueAt (index)) && ! snapshotProperties->hasProperty (name))
+                    properties.remove (name);
+            }
+
+            for (const auto& property : snapshotProperties->getProperties())
+                properties.set (property.name, property.value);
+        }
+    }
+
+    for (auto child : component.getChildren())
+        restoreComponentProperties (*child, snapshot);
+}
+
+} // namespace
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (StateSnapshots)
+
+StateSnapshots::~StateSnapshots()
+{
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+void StateSnapshots::addProvider (const juce::String& name, CaptureCallback captureCallback, RestoreCallback restoreCallback)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+    jassert (captureCallback != nullptr && restoreCallback != nullptr);
+
+    removeProvider (name);
+
+    providers.push_back ({ name, std::move (captureCallback), std::move (restoreCallback) });
+}
+
+void StateSnapshots::addValueTreeProvider (const juce::String& name, juce::ValueTree tree, juce::UndoManager* undoManager)
+{
+    jassert (tree.isValid());
+
+    addProvider (name,
+        [tree]
+        {
+            juce::MemoryBlock result;
+
+            juce::MemoryOutputStream output (result, false);
+            tree.writeToStream (output);
+            output.flush();
+
+            return result;
+        },
+        [tree, undoManager] (const juce::MemoryBlock& data) mutable
+        {
+            const auto source = juce::ValueTree::readFromData (data.getData(), data.getSize());
+            if (! source.isValid() || source.getType() != tree.getType())
+                return juce::Result::fail ("invalid value tree snapshot");
+
+            restoreValueTreeNode (tree, source, undoManager);
+            return juce::Result::ok();
+        });
+}
+
+void StateSnapshots::addComponentPropertiesProvider (const juce::String& name, juce::Component& component)
+{
+    addProvider (name,
+        [safeComponent = juce::Component::SafePointer<juce::Component> (&component)]
+        {
+            auto targetComponent = safeComponent.getComponent();
+            if (targetComponent == nullptr)
+                return juce::MemoryBlock();
+
+            juce::DynamicObject::Ptr result = new juce::DynamicObject;
+            captureComponentProperties (*targetComponent, *result);
+
+            return encodeVar (result.get(), WireFormat::msgpack);
+        },
+        [safeComponent = juce::Component::SafePointer<juce::Component> (&component)] (const juce::MemoryBlock& data)
+        {
+            auto targetComponent = safeComponent.getComponent();
+            if (targetComponent == nullptr)
+                return juce::Result::fail ("component has been deleted");
+
+            juce::var snapshot;
+
+            auto result = decodeVar (data.getData(), data.getSize(), WireFormat::msgpack, snapshot);
+            if (result.failed())
+                return result;
+
+            if (auto snapshotObject = snapshot.getDynamicObject())
+                restoreComponentProperties (*targetComponent, *snapshotObject);
+
+            return juce::Result::ok();
+        });
+}
+
+void StateSnapshots::removeProvider (const juce::String& name)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    providers.erase (std::remove_if (providers.begin(), providers.end(), [&name] (const auto& provider) { return provider.name == name; }),
+                     providers.end());
+}
+
+juce::StringArray StateSnapshots::getProviderNames() const
+{
+    juce::StringArray result;
+
+    for (const auto& provider : providers)
+        result.add (provider.name);
+
+    return result;
+}
+
+//=================================================================================================
+
+juce::Result StateSnapshots::capture (const juce::String& snapshotName)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (snapshotName.isEmpty())
+        return juce::Result::fail ("invalid snapshot name");
+
+    Snapshot snapshot;
+
+    for (const auto& provider : providers)
+        snapshot [provider.name] = provider.captureCallback();
+
+    snapshots [snapshotName] = std::move (snapshot);
+
+    return juce::Result::ok();
+}
+
+juce::Result StateSnapshots::restore (const juce::String& snapshotName, RestoreStats& stats)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    stats = {};
+
+    auto snapshot = snapshots.find (snapshotName);
+    if (snapshot == snapshots.end())
+        return juce::Result::fail ("snapshot not found: " + snapshotName);
+
+    for (const auto& provider : providers)
+    {
+        auto state = snapshot->second.find (provider.name);
+        if (state == snapshot->second.end())
+            continue;
+
+        // Capturing is much cheaper than restoring, which notifies listeners and rebuilds user interfaces
+        if (provider.captureCallback() == state->second)
+        {
+            ++stats.numUnchangedProviders;
+            continue;
+        }
+
+        auto result = provider.restoreCallback (state->second);
+        if (result.failed())
+            return juce::Result::fail ("unable to restore " + provider.name + ": " + result.getErrorMessage());
+
+        stats.restoredProviders.add (provider.name);
+    }
+
+    return juce::Result::ok();
+}
+
+bool StateSnapshots::hasSnapshot (const juce::String& snapshotName) const
+{
+    return snapshots.find (snapshotName) != snapshots.end();
+}
+
+void StateSnapshots::removeSnapshot (const juce::String& snapshotName)
+{
+    snapshots.erase (snapshotName);
+}
+
+//=================================================================================================
+
+juce::MemoryBlock StateSnapshots::toBinary (const juce::String& snapshotName) const
+{
+    juce::MemoryBlock result;
+
+    auto snapshot = snapshots.find (snapshotName);
+    if (snapshot == snapshots.end())
+        return result;
+
+    juce::MemoryOutputStream output (result, false);
+    output.writeInt (snapshotMagic);
+    output.writeByte (static_cast<char> (snapshotVersion));
+    output.writeCompressedInt (static_cast<int> (snapshot->second.size()));
+
+    for (const auto& [providerName, state] : snapshot->second)
+    {
+        output.writeString (providerName);
+        output.writeCompressedInt (static_cast<int> (state.getSize()));
+        output.write (state.getData(), state.getSize());
+    }
+
+    output.flush();
+    return result;
+}
+
+juce::Result StateSnapshots::fromBinary (const juce::String& snapshotName, const juce::MemoryBlock& data)
+{
+    if (snapshotName.isEmpty())
+        return juce::Result::fail ("invalid snapshot name");
+
+    juce::MemoryInputStream input (data, false);
+
+    if (input.readInt() != snapshotMagic)
+        return juce::Result::fail ("invalid state snapshot");
+
+    if (input.readByte() != static_cast<char> (snapshotVersion))
+        return juce::Result::fail ("unsupported state snapshot version");
+
+    Snapshot snapshot;
+
+    const auto numProviders = input.readCompressedInt();
+    if (numProviders < 0 || numProviders > input.getNumBytesRemaining() / minEncodedProviderSize)
+        return juce::Result::fail ("corrupted state snapshot");
+
+    for (int index = 0; index < numProviders; ++index)
+    {
+        if (input.isExhausted())
+            return juce::Result::fail ("truncated state snapshot");
+
+        auto providerName = input.readString();
+
+        const auto size = input.readCompressedInt();
+        if (size < 0 || size > input.getNumBytesRemaining())
+            return juce::Result::fail ("truncated state snapshot");
+
+        juce::MemoryBlock state;
+        input.readIntoMemoryBlock (state, size);
+
+        snapshot [providerName] = std::move (state);
+    }
+
+    snapshots [snapshotName] = std::move (snapshot);
+
+    return juce::Result::ok();
+}
+
+//=================================================================================================
+
+juce::var StateSnapshots::toVar() const
+{
+    juce::Array<juce::var> providerNames;
+    for (const auto& provider : providers)
+        providerNames.add (provider.name);
+
+    juce::DynamicObject::Ptr snapshotSizes = new juce::DynamicObject;
+    for (const auto& [snapshotName, snapshot] : snapshots)
+    {
+        juce::DynamicObject::Ptr stateSizes = new juce::DynamicObject;
+
+        for (const auto& [providerName, state] : snapshot)
+            stateSizes->setProperty (providerName, static_cast<juce::int64> (state.getSize()));
+
+        snapshotSizes->setProperty (snapshotName, stateSizes.get());
+    }
+
+    juce::DynamicObject::Ptr result = new juce::DynamicObject;
+    result->setProperty ("providers", providerNames);
+    result->setProperty ("snapshots", snapshotSizes.get());
+    return result.get();
+}
+
+} // namespace straw
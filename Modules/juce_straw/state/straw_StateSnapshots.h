@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief Captures the state of the application and restores it in process, so tests can start from a clean state without
+ * relaunching the application.
+ *
+ * Applications register named providers, each one able to capture its part of the state into a binary blob and to restore
+ * it back, like a `juce::ValueTree`, the properties of a component hierarchy or any custom serialiser. A snapshot is the
+ * set of blobs captured from all the providers at a given time, usually once as a baseline after startup.
+ *
+ * Restoring is diff based: the current state of each provider is captured and compared with the snapshot, and only the
+ * providers whose state changed are restored. Value trees are restored node by node, touching only the properties and
+ * children that differ, so listeners are notified of the actual changes only.
+ *
+ * Providers, capture and restore must be used from the message thread.
+ */
+class StateSnapshots : public juce::DeletedAtShutdown
+{
+public:
+    /**
+     * @brief Callback type capturing the state of a provider.
+     */
+    using CaptureCallback = std::function<juce::MemoryBlock()>;
+
+    /**
+     * @brief Callback type restoring the state of a provider from a previously captured blob.
+     */
+    using RestoreCallback = std::function<juce::Result (const juce::MemoryBlock&)>;
+
+    /**
+     * @brief The outcome of a restore.
+     */
+    struct RestoreStats
+    {
+        juce::StringArray restoredProviders;
+        int numUnchangedProviders = 0;
+    };
+
+    /**
+     * @brief Destructor for the StateSnapshots class.
+     */
+    ~StateSnapshots() override;
+
+    /**
+     * @brief Register a provider with custom capture and restore callbacks, replacing any provider with the same name.
+     *
+     * Providers are restored in order of registration.
+     *
+     * @param name The name of the provider.
+     * @param captureCallback The callback capturing the state.
+     * @param restoreCallback The callback restoring the state.
+     */
+    void addProvider (const juce::String& name, CaptureCallback captureCallback, RestoreCallback restoreCallback);
+
+    /**
+     * @brief Register a provider capturing and restoring a value tree.
+     *
+     * @param name The name of the provider.
+     * @param tree The value tree, restored in place so existing references and listeners stay valid.
+     * @param undoManager The optional undo manager used when restoring.
+     */
+    void addValueTreeProvider (const juce::String& name, juce::ValueTree tree, juce::UndoManager* undoManager = nullptr);
+
+    /**
+     * @brief Register a provider capturing and restoring the properties of a component and its identified descendants.
+     *
+     * Only the properties that can be serialised are captured, custom methods are left untouched.
+     *
+     * @param name The name of the provider.
+     * @param component The root of the component hierarchy, restoring fails once it's deleted.
+     */
+    void addComponentPropertiesProvider (const juce::String& name, juce::Component& component);
+
+    /**
+     * @brief Unregister a provider.
+     *
+     * @param name The name of the provider.
+     */
+    void removeProvider (const juce::String& name);
+
+    /**
+     * @brief Get the names of the registered providers.
+     */
+    [[nodiscard]] juce::StringArray getProviderNames() const;
+
+    /**
+     * @brief Capture a snapshot from all the registered providers, replacing any snapshot with the same name.
+     *
+     * @param snapshotName The name of the snapshot.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    juce::Result capture (const juce::String& snapshotName);
+
+    /**
+     * @brief Restore a snapshot, only for the providers whose state changed since it was captured.
+     *
+     * Providers registered after the snapshot was captured are left untouched.
+     *
+     * @param snapshotName The name of the snapshot.
+     * @param stats The outcome of the restore.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    juce::Result restore (const juce::String& snapshotName, RestoreStats& stats);
+
+    /**
+     * @brief Check if a snapshot has been captured.
+     *
+     * @param snapshotName The name of the snapshot.
+     */
+    [[nodiscard]] bool hasSnapshot (const juce::String& snapshotName) const;
+
+    /**
+     * @brief Discard a snapshot.
+     *
+     * @param snapshotName The name of the snapshot.
+     */
+    void removeSnapshot (const juce::String& snapshotName);
+
+    /**
+     * @brief Serialise a snapshot into a compact binary format, to store it across application runs.
+     *
+     * @param snapshotName The name of the snapshot.
+     *
+     * @return The binary snapshot, empty if the snapshot doesn't exist.
+     */
+    [[nodiscard]] juce::MemoryBlock toBinary (const juce::String& snapshotName) const;
+
+    /**
+     * @brief Deserialise a snapshot from the compact binary format, replacing any snapshot with the same name.
+     *
+     * @param snapshotName The name of the snapshot.
+     * @param data The binary snapshot.
+     *
+     * @return A juce::Result indicating the success or failure of the operation.
+     */
+    juce::Result fromBinary (const juce::String& snapshotName, const juce::MemoryBlock& data);
+
+    /**
+     * @brief Get the registered providers and the captured snapshots, with their sizes, as an object.
+     */
+    [[nodiscard]] juce::var toVar() const;
+
+    JUCE_DECLARE_SINGLETON (StateSnapshots, false)
+
+private:
+    StateSnapshots() = default;
+
+    struct Provider
+    {
+        juce::String name;
+        CaptureCallback captureCallback;
+        RestoreCallback restoreCallback;
+    };
+
+    using Snapshot = std::map<juce::String, juce::MemoryBlock>;
+
+    std::vector<Provider> providers;
+    std::map<juce::String, Snapshot> snapshots;
+};
+
+} // namespace straw
@@ -0,0 +1,375 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_VirtualClock.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace straw {
+
+//=================================================================================================
+
+JUCE_IMPLEMENT_SINGLETON (VirtualClock)
+
+VirtualClock::VirtualClock() = default;
+
+VirtualClock::~VirtualClock()
+{
+    stopTimer();
+
+    clearSingletonInstance();
+}
+
+//=================================================================================================
+
+bool VirtualClock::isVirtual() const
+{
+    auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+    return isVirtualTime;
+}
+
+double VirtualClock::getMillisecondCounterHiRes() const
+{
+    const auto realTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+    if (! isVirtualTime)
+        return realTime;
+
+    return virtualTimeBase + (realTime - realTimeBase) * warpFactor;
+}
+
+double VirtualClock::getWarpFactor() const
+{
+    auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+    return isVirtualTime ? warpFactor : 1.0;
+}
+
+//=================================================================================================
+
+void VirtualClock::setVirtual (bool shouldBeVirtual)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (shouldBeVirtual == isVirtual())
+        return;
+
+    if (shouldBeVirtual)
+    {
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+
+        {
+            auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+            isVirtualTime = true;
+            virtualTimeBase = now;
+            realTimeBase = now;
+            warpFactor = 0.0;
+        }
+
+        for (auto timer : timers)
+        {
+            timer->realTimer.stopTimer();
+            timer->nextDueTime = now + timer->interval;
+        }
+    }
+    else
+    {
+        const auto now = getMillisecondCounterHiRes();
+
+        {
+            auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+            isVirtualTime = false;
+            warpFactor = 1.0;
+        }
+
+        for (auto timer : timers)
+            timer->realTimer.startTimer (timer->interval);
+
+        for (auto& delayedCall : std::exchange (delayedCalls, {}))
+            juce::Timer::callAfterDelay (juce::jmax (0, juce::roundToInt (delayedCall.dueTime - now)), std::move (delayedCall.function));
+    }
+
+    updateWarpTimer();
+}
+
+void VirtualClock::setWarpFactor (double factor)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (! isVirtual())
+        setVirtual (true);
+
+    rebase (getMillisecondCounterHiRes(), juce::jmax (0.0, factor));
+
+    updateWarpTimer();
+}
+
+//=================================================================================================
+
+void VirtualClock::advance (double milliseconds)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    // Advancing from a callback fired while advancing would reorder the callbacks
+    if (isAdvancing)
+    {
+        jassertfalse;
+        return;
+    }
+
+    if (! isVirtual())
+        setVirtual (true);
+
+    const auto targetTime = getMillisecondCounterHiRes() + juce::jmax (0.0, milliseconds);
+
+    isAdvancing = true;
+
+    while (fireNextDue (targetTime, true))
+        ;
+
+    isAdvancing = false;
+
+    rebase (targetTime, getWarpFactor());
+}
+
+void VirtualClock::dispatchUntil (const std::function<bool()>& isDone)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    while (! isDone())
+    {
+        juce::MessageManager::getInstance()->runDispatchLoopUntil (1);
+
+        if (isDone())
+            break;
+
+        if (isVirtual() && getWarpFactor() == 0.0 && ! isAdvancing)
+            fireNextDue (std::numeric_limits<double>::max(), true);
+    }
+}
+
+//=================================================================================================
+
+juce::var VirtualClock::toVar() const
+{
+    juce::DynamicObject::Ptr result = new juce::DynamicObject;
+    result->setProperty ("virtual", isVirtual());
+    result->setProperty ("warp", getWarpFactor());
+    result->setProperty ("time", getMillisecondCounterHiRes());
+    result->setProperty ("timers", static_cast<int> (timers.size()));
+    result->setProperty ("delayedCalls", static_cast<int> (delayedCalls.size()));
+    return result.get();
+}
+
+//=================================================================================================
+
+void VirtualClock::timerCallback()
+{
+    // Drives the virtual time when it's warped, timers fire as soon as their due time is reached
+    if (isAdvancing)
+        return;
+
+    const auto now = getMillisecondCounterHiRes();
+
+    while (fireNextDue (now, false))
+        ;
+}
+
+//=================================================================================================
+
+void VirtualClock::addTimer (WarpableTimer& timer)
+{
+    if (std::find (timers.begin(), timers.end(), &timer) == timers.end())
+        timers.push_back (&timer);
+}
+
+void VirtualClock::removeTimer (WarpableTimer& timer)
+{
+    timers.erase (std::remove (timers.begin(), timers.end(), &timer), timers.end());
+}
+
+void VirtualClock::scheduleTimer (WarpableTimer& timer)
+{
+    addTimer (timer);
+
+    if (isVirtual())
+    {
+        timer.realTimer.stopTimer();
+        timer.nextDueTime = getMillisecondCounterHiRes() + timer.interval;
+    }
+    else
+    {
+        timer.realTimer.startTimer (timer.interval);
+    }
+}
+
+void VirtualClock::addDelayedCall (int milliseconds, std::function<void()> function)
+{
+    if (! isVirtual())
+    {
+        juce::Timer::callAfterDelay (milliseconds, std::move (function));
+        return;
+    }
+
+    delayedCalls.push_back ({ getMillisecondCounterHiRes() + juce::jmax (0, milliseconds), nextSequence++, std::move (function) });
+}
+
+//=================================================================================================
+
+void VirtualClock::rebase (double virtualTime, double factor)
+{
+    const auto realTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto lock = juce::CriticalSection::ScopedLockType (stateLock);
+
+    virtualTimeBase = virtualTime;
+    realTimeBase = realTime;
+    warpFactor = factor;
+}
+
+bool VirtualClock::fireNextDue (double untilTime, bool shouldSetTimeToDue)
+{
+    // Callbacks can start, stop and delete timers, so the next due one is searched again every time
+    auto dueTime = untilTime;
+
+    auto dueCall = delayedCalls.end();
+    for (auto it = delayedCalls.begin(); it != delayedCalls.end(); ++it)
+    {
+        if (it->dueTime < dueTime || (it->dueTime == dueTime && (dueCall == delayedCalls.end() || it->sequence < dueCall->sequence)))
+        {
+            dueTime = it->dueTime;
+            dueCall = it;
+        }
+    }
+
+    WarpableTimer* dueTimer = nullptr;
+    for (auto timer : timers)
+    {
+        // Delayed calls win ties, timers fire in the order they were started
+        if (timer->nextDueTime < dueTime || (timer->nextDueTime == dueTime && dueCall == delayedCalls.end() && dueTimer == nullptr))
+        {
+            dueTime = timer->nextDueTime;
+            dueTimer = timer;
+        }
+    }
+
+    if (dueTimer == nullptr && dueCall == delayedCalls.end())
+        return false;
+
+    if (shouldSetTimeToDue)
+        rebase (dueTime, getWarpFactor());
+
+    if (dueTimer != nullptr)
+    {
+        // Rescheduled before the callback, which might delete the timer
+        dueTimer->nextDueTime += dueTimer->interval;
+        dueTimer->timerCallback();
+    }
+    else
+    {
+        auto function = std::move (dueCall->function);
+        delayedCalls.erase (dueCall);
+
+        if (function != nullptr)
+            function();
+    }
+
+    return true;
+}
+
+void VirtualClock::updateWarpTimer()
+{
+    if (isVirtual() && getWarpFactor() > 0.0)
+        startTimer (1);
+    else
+        stopTimer();
+}
+
+//=================================================================================================
+
+WarpableTimer::WarpableTimer()
+    : realTimer (*this)
+{
+}
+
+WarpableTimer::~WarpableTimer()
+{
+    stopTimer();
+}
+
+void WarpableTimer::startTimer (int intervalMilliseconds)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    interval = juce::jmax (1, intervalMilliseconds);
+
+    VirtualClock::getInstance()->scheduleTimer (*this);
+}
+
+void WarpableTimer::startTimerHz (int timerFrequencyHz)
+{
+    if (timerFrequencyHz > 0)
+        startTimer (1000 / timerFrequencyHz);
+    else
+        stopTimer();
+}
+
+void WarpableTimer::stopTimer()
+{
+    realTimer.stopTimer();
+
+    if (interval > 0)
+    {
+        interval = 0;
+
+        // Timers outliving the clock at shutdown have nothing to unregister from
+        if (auto clock = VirtualClock::getInstanceWithoutCreating())
+            clock->removeTimer (*this);
+    }
+}
+
+bool WarpableTimer::isTimerRunning() const
+{
+    return interval > 0;
+}
+
+int WarpableTimer::getTimerInterval() const
+{
+    return interval;
+}
+
+//=================================================================================================
+
+void callAfterDelay (int milliseconds, std::function<void()> function)
+{
+    jassert (juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    VirtualClock::getInstance()->addDelayedCall (milliseconds, std::move (function));
+}
+
+} // namespace straw
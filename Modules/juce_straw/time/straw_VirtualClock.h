@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include <functional>
+#include <vector>
+
+namespace straw {
+
+class WarpableTimer;
+
+//=================================================================================================
+
+/**
+ * @brief The time source of straw timers, which can be switched from real time to a virtual time controlled by the tests.
+ *
+ * In real time mode, the default, `WarpableTimer` and `callAfterDelay` behave exactly like their JUCE counterparts. In
+ * virtual time mode, they are scheduled against a virtual clock instead: time is frozen unless it's advanced explicitly, in
+ * which case every timer and delayed call due in the advanced interval fires in order of due time, deterministically and
+ * without sleeping, or unless it's warped to flow faster (or slower) than real time.
+ *
+ * Scheduling and advancing must happen on the message thread, the current time can be read from any thread.
+ */
+class VirtualClock
+    : public juce::DeletedAtShutdown
+    , private juce::Timer
+{
+public:
+    /**
+     * @brief Destructor for the VirtualClock class.
+     */
+    ~VirtualClock() override;
+
+    /**
+     * @brief Check if the clock is in virtual time mode.
+     */
+    [[nodiscard]] bool isVirtual() const;
+
+    /**
+     * @brief Get the current time in milliseconds, like `juce::Time::getMillisecondCounterHiRes`.
+     *
+     * In virtual time mode this is the virtual time, which starts from the real time when the mode is enabled.
+     */
+    [[nodiscard]] double getMillisecondCounterHiRes() const;
+
+    /**
+     * @brief Switch to virtual time mode, with frozen time, or back to real time mode.
+     *
+     * Running timers are restarted in the new mode with their interval, and delayed calls pending in virtual time are
+     * rescheduled in real time with their remaining delay. Delayed calls scheduled in real time mode stay in real time.
+     */
+    void setVirtual (bool shouldBeVirtual);
+
+    /**
+     * @brief Make the virtual time flow at a multiple of the real time, switching to virtual time mode if needed.
+     *
+     * @param factor The speed of the virtual time relative to the real time, 0 freezes it.
+     */
+    void setWarpFactor (double factor);
+
+    /**
+     * @brief Get the speed of the virtual time relative to the real time, 1 in real time mode.
+     */
+    [[nodiscard]] double getWarpFactor() const;
+
+    /**
+     * @brief Advance the virtual time, switching to virtual time mode if needed.
+     *
+     * Timers and delayed calls due in the interval fire in order of due time before returning, each one seeing the current
+     * time set to its due time.
+     *
+     * @param milliseconds The time to advance by.
+     */
+    void advance (double milliseconds);
+
+    /**
+     * @brief Dispatch messages until a condition is met.
+     *
+     * When the virtual time is frozen, it's advanced to the next due timer or delayed call between each round of dispatched
+     * messages, so waiting on timers never hangs nor sleeps.
+     *
+     * @param isDone The condition to wait for.
+     */
+    void dispatchUntil (const std::function<bool()>& isDone);
+
+    /**
+     * @brief Get the state of the clock as an object.
+     */
+    [[nodiscard]] juce::var toVar() const;
+
+    JUCE_DECLARE_SINGLETON (VirtualClock, false)
+
+private:
+    friend class WarpableTimer;
+    friend void callAfterDelay (int milliseconds, std::function<void()> function);
+
+    struct DelayedCall
+    {
+        double dueTime = 0.0;
+        juce::uint64 sequence = 0;
+        std::function<void()> function;
+    };
+
+    VirtualClock();
+
+    void timerCallback() override;
+
+    void addTimer (WarpableTimer& timer);
+    void removeTimer (WarpableTimer& timer);
+    void scheduleTimer (WarpableTimer& timer);
+    void addDelayedCall (int milliseconds, std::function<void()> function);
+
+    void rebase (double virtualTime, double factor);
+    bool fireNextDue (double untilTime, bool shouldSetTimeToDue);
+    void updateWarpTimer();
+
+    juce::CriticalSection stateLock;
+    bool isVirtualTime = false;
+    double virtualTimeBase = 0.0;
+    double realTimeBase = 0.0;
+    double warpFactor = 1.0;
+
+    std::vector<WarpableTimer*> timers;
+    std::vector<DelayedCall> delayedCalls;
+    juce::uint64 nextSequence = 0;
+    bool isAdvancing = false;
+
+    JUCE_DECLARE_NON_COPYABLE (VirtualClock)
+};
+
+//=================================================================================================
+
+/**
+ * @brief A drop in replacement of `juce::Timer` following the `VirtualClock`.
+ *
+ * Unlike `juce::Timer`, it must be started and stopped from the message thread.
+ */
+class WarpableTimer
+{
+public:
+    /**
+     * @brief Constructor for the WarpableTimer class.
+     */
+    WarpableTimer();
+
+    /**
+     * @brief Destructor for the WarpableTimer class, stops the timer.
+     */
+    virtual ~WarpableTimer();
+
+    /**
+     * @brief The callback invoked when the timer fires, on the message thread.
+     */
+    virtual void timerCallback() = 0;
+
+    /**
+     * @brief Start the timer, or restart it with a new interval.
+     *
+     * @param intervalMilliseconds The interval between callbacks, in milliseconds.
+     */
+    void startTimer (int intervalMilliseconds);
+
+    /**
+     * @brief Start the timer with a frequency instead of an interval.
+     *
+     * @param timerFrequencyHz The number of callbacks per second.
+     */
+    void startTimerHz (int timerFrequencyHz);
+
+    /**
+     * @brief Stop the timer.
+     */
+    void stopTimer();
+
+    /**
+     * @brief Check if the timer is running.
+     */
+    [[nodiscard]] bool isTimerRunning() const;
+
+    /**
+     * @brief Get the interval of the timer in milliseconds, 0 if it's not running.
+     */
+    [[nodiscard]] int getTimerInterval() const;
+
+private:
+    friend class VirtualClock;
+
+    struct RealTimer : public juce::Timer
+    {
+        explicit RealTimer (WarpableTimer& timerToNotify)
+            : owner (timerToNotify)
+        {
+        }
+
+        void timerCallback() override
+        {
+            owner.timerCallback();
+        }
+
+        WarpableTimer& owner;
+    };
+
+    RealTimer realTimer;
+    int interval = 0;
+    double nextDueTime = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE (WarpableTimer)
+};
+
+//=================================================================================================
+
+/**
+ * @brief Invoke a function after a delay, like `juce::Timer::callAfterDelay`, following the `VirtualClock`.
+ *
+ * Must be called from the message thread.
+ *
+ * @param milliseconds The delay in milliseconds.
+ * @param function The function to invoke on the message thread.
+ */
+void callAfterDelay (int milliseconds, std::function<void()> function);
+
+} // namespace straw
@@ -40,7 +40,7 @@ struct VariantConverter<juce::Point<T>>
     {
         juce::DynamicObject::Ptr object = new juce::DynamicObject;
         object->setProperty("x", v.getX());
-        object->setProperty("y", v.getX());
+        object->setProperty("y", v.getY());
         return object.get();
     }
 };
@@ -60,7 +60,7 @@ struct VariantConverter<juce::Rectangle<T>>
     {
         juce::DynamicObject::Ptr object = new juce::DynamicObject;
         object->setProperty("x", v.getX());
-        object->setProperty("y", v.getX());
+        object->setProperty("y", v.getY());
         object->setProperty("width", v.getWidth());
         object->setProperty("height", v.getHeight());
         return object.get();
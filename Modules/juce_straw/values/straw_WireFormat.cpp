@@ -0,0 +1,1033 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "straw_WireFormat.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace straw {
+namespace {
+
+//=================================================================================================
+
+// Protects the decoders recursion from maliciously nested payloads
+constexpr int maxWireFormatDepth = 512;
+
+juce::Result wireFormatError (juce::StringRef format, juce::StringRef message)
+{
+    return juce::Result::fail (juce::String (format) + ": " + message);
+}
+
+juce::var makeIntegerVar (juce::int64 value)
+{
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max())
+        return static_cast<int> (value);
+
+    return value;
+}
+
+juce::var makeUnsignedIntegerVar (juce::uint64 value)
+{
+    if (value > static_cast<juce::uint64> (std::numeric_limits<juce::int64>::max()))
+        return static_cast<double> (value);
+
+    return makeIntegerVar (static_cast<juce::int64> (value));
+}
+
+bool isLosslessFloat (double value)
+{
+    if (std::isnan (value) || std::isinf (value))
+        return true;
+
+    return std::abs (value) <= std::numeric_limits<float>::max() && static_cast<double> (static_cast<float> (value)) == value;
+}
+
+//=================================================================================================
+
+// Bounds checked reader of big endian data, shared by the binary decoders
+class WireFormatReader
+{
+public:
+    WireFormatReader (const void* sourceData, std::size_t sourceSize)
+        : data (static_cast<const juce::uint8*> (sourceData))
+        , size (sourceSize)
+    {
+    }
+
+    bool isExhausted() const
+    {
+        return position >= size;
+    }
+
+    std::size_t getNumBytesRemaining() const
+    {
+        return size - position;
+    }
+
+    template <class T>
+    bool readBigEndian (T& value)
+    {
+        static_assert (std::is_unsigned_v<T>);
+
+        if (sizeof (T) > getNumBytesRemaining())
+            return false;
+
+        std::memcpy (&value, data + position, sizeof (T));
+        position += sizeof (T);
+
+        if constexpr (sizeof (T) > 1)
+            value = juce::ByteOrder::swapIfLittleEndian (value);
+
+        return true;
+    }
+
+    bool readFloat (float& value)
+    {
+        juce::uint32 bits = 0;
+        if (! readBigEndian (bits))
+            return false;
+
+        std::memcpy (&value, &bits, sizeof (value));
+        return true;
+    }
+
+    bool readDouble (double& value)
+    {
+        juce::uint64 bits = 0;
+        if (! readBigEndian (bits))
+            return false;
+
+        std::memcpy (&value, &bits, sizeof (value));
+        return true;
+    }
+
+    const juce::uint8* readBytes (juce::uint64 numBytes)
+    {
+        if (numBytes > getNumBytesRemaining())
+            return nullptr;
+
+        auto result = data + position;
+        position += static_cast<std::size_t> (numBytes);
+        return result;
+    }
+
+    bool skipIfNextByteIs (juce::uint8 value)
+    {
+        if (isExhausted() || data [position] != value)
+            return false;
+
+        ++position;
+        return true;
+    }
+
+private:
+    const juce::uint8* data = nullptr;
+    std::size_t size = 0;
+    std::size_t position = 0;
+};
+
+//=================================================================================================
+
+void writeMessagePackHeader (juce::OutputStream& output, std::size_t length, int fixPrefix, std::size_t fixMaximum, int prefix8, int prefix16, int prefix32)
+{
+    if (fixPrefix >= 0 && length <= fixMaximum)
+    {
+        output.writeByte (static_cast<char> (fixPrefix | static_cast<int> (length)));
+    }
+    else if (prefix8 >= 0 && length <= 0xff)
+    {
+        output.writeByte (static_cast<char> (prefix8));
+        output.writeByte (static_cast<char> (length));
+    }
+    else if (length <= 0xffff)
+    {
+        output.writeByte (static_cast<char> (prefix16));
+        output.writeShortBigEndian (static_cast<short> (length));
+    }
+    else
+    {
+        jassert (length <= 0xffffffff);
+
+        output.writeByte (static_cast<char> (prefix32));
+        output.writeIntBigEndian (static_cast<int> (static_cast<juce::uint32> (length)));
+    }
+}
+
+void writeMessagePackInteger (juce::OutputStream& output, juce::int64 value)
+{
+    if (value >= 0)
+    {
+        if (value <= 0x7f)
+        {
+            output.writeByte (static_cast<char> (value));
+        }
+        else if (value <= 0xff)
+        {
+            output.writeByte (static_cast<char> (0xcc));
+            output.writeByte (static_cast<char> (value));
+        }
+        else if (value <= 0xffff)
+        {
+            output.writeByte (static_cast<char> (0xcd));
+            output.writeShortBigEndian (static_cast<short> (value));
+        }
+        else if (value <= 0xffffffff)
+        {
+            output.writeByte (static_cast<char> (0xce));
+            output.writeIntBigEndian (static_cast<int> (static_cast<juce::uint32> (value)));
+        }
+        else
+        {
+            output.writeByte (static_cast<char> (0xcf));
+            output.writeInt64BigEndian (value);
+        }
+    }
+    else
+    {
+        if (value >= -32)
+        {
+            output.writeByte (static_cast<char> (value));
+        }
+        else if (value >= std::numeric_limits<juce::int8>::min())
+        {
+            output.writeByte (static_cast<char> (0xd0));
+            output.writeByte (static_cast<char> (value));
+        }
+        else if (value >= std::numeric_limits<juce::int16>::min())
+        {
+            output.writeByte (static_cast<char> (0xd1));
+            output.writeShortBigEndian (static_cast<short> (value));
+        }
+        else if (value >= std::numeric_limits<juce::int32>::min())
+        {
+            output.writeByte (static_cast<char> (0xd2));
+            output.writeIntBigEndian (static_cast<int> (value));
+        }
+        else
+        {
+            output.writeByte (static_cast<char> (0xd3));
+            output.writeInt64BigEndian (value);
+        }
+    }
+}
+
+void writeMessagePackString (juce::OutputStream& output, const juce::String& text)
+{
+    const auto numBytes = text.getNumBytesAsUTF8();
+
+    writeMessagePackHeader (output, numBytes, 0xa0, 31, 0xd9, 0xda, 0xdb);
+    output.write (text.toRawUTF8(), numBytes);
+}
+
+//=================================================================================================
+
+juce::Result decodeMessagePackValue (WireFormatReader& reader, juce::var& result, int depth);
+
+juce::Result decodeMessagePackString (WireFormatReader& reader, juce::uint64 length, juce::var& result)
+{
+    auto bytes = reader.readBytes (length);
+    if (bytes == nullptr)
+        return wireFormatError ("MessagePack", "truncated string");
+
+    result = juce::String::fromUTF8 (reinterpret_cast<const char*> (bytes), static_cast<int> (length));
+    return juce::Result::ok();
+}
+
+juce::Result decodeMessagePackBinary (WireFormatReader& reader, juce::uint64 length, juce::var& result)
+{
+    auto bytes = reader.readBytes (length);
+    if (bytes == nullptr)
+        return wireFormatError ("MessagePack", "truncated binary");
+
+    result = juce::var (bytes, static_cast<std::size_t> (length));
+    return juce::Result::ok();
+}
+
+juce::Result decodeMessagePackArray (WireFormatReader& reader, juce::uint64 count, juce::var& result, int depth)
+{
+    // Every element takes at least one byte, reject counts that can't possibly be satisfied before allocating
+    if (count > reader.getNumBytesRemaining())
+        return wireFormatError ("MessagePack", "truncated array");
+
+    juce::Array<juce::var> items;
+    items.resize (static_cast<int> (count));
+
+    for (auto& item : items)
+    {
+        if (auto decodeResult = decodeMessagePackValue (reader, item, depth + 1); decodeResult.failed())
+            return decodeResult;
+    }
+
+    result = std::move (items);
+    return juce::Result::ok();
+}
+
+juce::Result decodeMessagePackMap (WireFormatReader& reader, juce::uint64 count, juce::var& result, int depth)
+{
+    if (count > reader.getNumBytesRemaining() / 2)
+        return wireFormatError ("MessagePack", "truncated map");
+
+    juce::DynamicObject::Ptr object = new juce::DynamicObject;
+
+    for (juce::uint64 i = 0; i < count; ++i)
+    {
+        juce::var key, value;
+
+        if (auto decodeResult = decodeMessagePackValue (reader, key, depth + 1); decodeResult.failed())
+            return decodeResult;
+
+        if (auto decodeResult = decodeMessagePackValue (reader, value, depth + 1); decodeResult.failed())
+            return decodeResult;
+
+        auto name = key.toString();
+        if (name.isEmpty())
+            return wireFormatError ("MessagePack", "empty map keys are not supported");
+
+        object->setProperty (name, std::move (value));
+    }
+
+    result = object.get();
+    return juce::Result::ok();
+}
+
+template <class T>
+juce::Result readMessagePackLength (WireFormatReader& reader, juce::uint64& length)
+{
+    T value = 0;
+    if (! reader.readBigEndian (value))
+        return wireFormatError ("MessagePack", "truncated length");
+
+    length = value;
+    return juce::Result::ok();
+}
+
+juce::Result decodeMessagePackValue (WireFormatReader& reader, juce::var& result, int depth)
+{
+    if (depth > maxWireFormatDepth)
+        return wireFormatError ("MessagePack", "nesting too deep");
+
+    juce::uint8 type = 0;
+    if (! reader.readBigEndian (type))
+        return wireFormatError ("MessagePack", "truncated value");
+
+    // Fixed size types, with the value or the length packed in the type byte
+    if (type <= 0x7f)
+    {
+        result = static_cast<int> (type);
+        return juce::Result::ok();
+    }
+
+    if (type >= 0xe0)
+    {
+        result = static_cast<int> (static_cast<juce::int8> (type));
+        return juce::Result::ok();
+    }
+
+    if ((type & 0xf0) == 0x80)
+        return decodeMessagePackMap (reader, type & 0x0f, result, depth);
+
+    if ((type & 0xf0) == 0x90)
+        return decodeMessagePackArray (reader, type & 0x0f, result, depth);
+
+    if ((type & 0xe0) == 0xa0)
+        return decodeMessagePackString (reader, type & 0x1f, result);
+
+    juce::uint64 length = 0;
+
+    switch (type)
+    {
+        case 0xc0:
+            result = juce::var();
+            return juce::Result::ok();
+
+        case 0xc2:
+        case 0xc3:
+            result = (type == 0xc3);
+            return juce::Result::ok();
+
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+        {
+            auto lengthResult = type == 0xc4 ? readMessagePackLength<juce::uint8> (reader, length)
+                              : type == 0xc5 ? readMessagePackLength<juce::uint16> (reader, length)
+                                             : readMessagePackLength<juce::uint32> (reader, length);
+
+            return lengthResult.failed() ? lengthResult : decodeMessagePackBinary (reader, length, result);
+        }
+
+        case 0xca:
+        {
+            float value = 0.0f;
+            if (! reader.readFloat (value))
+                return wireFormatError ("MessagePack", "truncated float");
+
+            result = static_cast<double> (value);
+            return juce::Result::ok();
+        }
+
+        case 0xcb:
+        {
+            double value = 0.0;
+            if (! reader.readDouble (value))
+                return wireFormatError ("MessagePack", "truncated double");
+
+            result = value;
+            return juce::Result::ok();
+        }
+
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+        {
+            auto lengthResult = type == 0xcc ? readMessagePackLength<juce::uint8> (reader, length)
+                              : type == 0xcd ? readMessagePackLength<juce::uint16> (reader, length)
+                              : type == 0xce ? readMessagePackLength<juce::uint32> (reader, length)
+                                             : readMessagePackLength<juce::uint64> (reader, length);
+
+            if (lengthResult.failed())
+                return lengthResult;
+
+            result = makeUnsignedIntegerVar (length);
+            return juce::Result::ok();
+        }
+
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+        {
+            auto lengthResult = type == 0xd0 ? readMessagePackLength<juce::uint8> (reader, length)
+                              : type == 0xd1 ? readMessagePackLength<juce::uint16> (reader, length)
+                              : type == 0xd2 ? readMessagePackLength<juce::uint32> (reader, length)
+                                             : readMessagePackLength<juce::uint64> (reader, length);
+
+            if (lengthResult.failed())
+                return lengthResult;
+
+            // Sign extend from the encoded width
+            const auto numBits = 8 << (type - 0xd0);
+            auto value = static_cast<juce::int64> (length);
+            if (numBits < 64 && (length & (juce::uint64 (1) << (numBits - 1))) != 0)
+                value -= static_cast<juce::int64> (juce::uint64 (1) << numBits);
+
+            result = makeIntegerVar (value);
+            return juce::Result::ok();
+        }
+
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+        {
+            auto lengthResult = type == 0xd9 ? readMessagePackLength<juce::uint8> (reader, length)
+                              : type == 0xda ? readMessagePackLength<juce::uint16> (reader, length)
+                                             : readMessagePackLength<juce::uint32> (reader, length);
+
+            return lengthResult.failed() ? lengthResult : decodeMessagePackString (reader, length, result);
+        }
+
+        case 0xdc:
+        case 0xdd:
+        {
+            auto lengthResult = type == 0xdc ? readMessagePackLength<juce::uint16> (reader, length)
+                                             : readMessagePackLength<juce::uint32> (reader, length);
+
+            return lengthResult.failed() ? lengthResult : decodeMessagePackArray (reader, length, result, depth);
+        }
+
+        case 0xde:
+        case 0xdf:
+        {
+            auto lengthResult = type == 0xde ? readMessagePackLength<juce::uint16> (reader, length)
+                                             : readMessagePackLength<juce::uint32> (reader, length);
+
+            return lengthResult.failed() ? lengthResult : decodeMessagePackMap (reader, length, result, depth);
+        }
+
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+        case 0xd4:
+        case 0xd5:
+        case 0xd6:
+        case 0xd7:
+        case 0xd8:
+            return wireFormatError ("MessagePack", "extension types are not supported");
+
+        default:
+            break;
+    }
+
+    return wireFormatError ("MessagePack", "invalid type " + juce::String::toHexString (static_cast<int> (type)));
+}
+
+//=================================================================================================
+
+enum CborMajorType
+{
+    cborUnsigned = 0,
+    cborNegative = 1,
+    cborBytes = 2,
+    cborText = 3,
+    cborArray = 4,
+    cborMap = 5,
+    cborTag = 6,
+    cborSimple = 7
+};
+
+constexpr juce::uint8 cborBreak = 0xff;
+
+void writeCborHead (juce::OutputStream& output, CborMajorType majorType, juce::uint64 argument)
+{
+    const auto major = static_cast<int> (majorType) << 5;
+
+    if (argument < 24)
+    {
+        output.writeByte (static_cast<char> (major | static_cast<int> (argument)));
+    }
+    else if (argument <= 0xff)
+    {
+        output.writeByte (static_cast<char> (major | 24));
+        output.writeByte (static_cast<char> (argument));
+    }
+    else if (argument <= 0xffff)
+    {
+        output.writeByte (static_cast<char> (major | 25));
+        output.writeShortBigEndian (static_cast<short> (argument));
+    }
+    else if (argument <= 0xffffffff)
+    {
+        output.writeByte (static_cast<char> (major | 26));
+        output.writeIntBigEndian (static_cast<int> (static_cast<juce::uint32> (argument)));
+    }
+    else
+    {
+        output.writeByte (static_cast<char> (major | 27));
+        output.writeInt64BigEndian (static_cast<juce::int64> (argument));
+    }
+}
+
+void writeCborString (juce::OutputStream& output, const juce::String& text)
+{
+    const auto numBytes = text.getNumBytesAsUTF8();
+
+    writeCborHead (output, cborText, numBytes);
+    output.write (text.toRawUTF8(), numBytes);
+}
+
+double decodeCborHalfFloat (juce::uint16 half)
+{
+    const auto exponent = (half >> 10) & 0x1f;
+    const auto mantissa = half & 0x3ff;
+
+    double value = 0.0;
+    if (exponent == 0)
+        value = std::ldexp (static_cast<double> (mantissa), -24);
+    else if (exponent != 31)
+        value = std::ldexp (static_cast<double> (mantissa + 1024), exponent - 25);
+    else
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+
+    return (half & 0x8000) != 0 ? -value : value;
+}
+
+//=================================================================================================
+
+juce::Result decodeCborValue (WireFormatReader& reader, juce::var& result, int depth);
+
+juce::Result decodeCborSimple (WireFormatReader& reader, int info, juce::var& result)
+{
+    switch (info)
+    {
+        case 20: result = false; return juce::Result::ok();
+        case 21: result = true; return juce::Result::ok();
+        case 22: result = juce::var(); return juce::Result::ok();
+        case 23: result = juce::var::undefined(); return juce::Result::ok();
+
+        case 25:
+        {
+            juce::uint16 half = 0;
+            if (! reader.readBigEndian (half))
+                return wireFormatError ("CBOR", "truncated half float");
+
+            result = decodeCborHalfFloat (half);
+            return juce::Result::ok();
+        }
+
+        case 26:
+        {
+            float value = 0.0f;
+            if (! reader.readFloat (value))
+                return wireFormatError ("CBOR", "truncated float");
+
+            result = static_cast<double> (value);
+            return juce::Result::ok();
+        }
+
+        case 27:
+        {
+            double value = 0.0;
+            if (! reader.readDouble (value))
+                return wireFormatError ("CBOR", "truncated double");
+
+            result = value;
+            return juce::Result::ok();
+        }
+
+        case 31:
+            return wireFormatError ("CBOR", "unexpected break");
+
+        default:
+            break;
+    }
+
+    return wireFormatError ("CBOR", "unsupported simple value " + juce::String (info));
+}
+
+juce::Result decodeCborChunks (WireFormatReader& reader, CborMajorType majorType, juce::MemoryBlock& result)
+{
+    // Indefinite length strings are a sequence of definite length strings of the same type, terminated by a break
+    while (! reader.skipIfNextByteIs (cborBreak))
+    {
+        juce::uint8 initialByte = 0;
+        if (! reader.readBigEndian (initialByte))
+            return wireFormatError ("CBOR", "truncated string chunk");
+
+        if ((initialByte >> 5) != majorType || (initialByte & 0x1f) > 27)
+            return wireFormatError ("CBOR", "invalid string chunk");
+
+        juce::uint64 length = initialByte & 0x1f;
+        if (length >= 24)
+        {
+            bool lengthRead = false;
+
+            if (length == 24) { juce::uint8 value = 0; lengthRead = reader.readBigEndian (value); length = value; }
+            else if (length == 25) { juce::uint16 value = 0; lengthRead = reader.readBigEndian (value); length = value; }
+            else if (length == 26) { juce::uint32 value = 0; lengthRead = reader.readBigEndian (value); length = value; }
+            else { juce::uint64 value = 0; lengthRead = reader.readBigEndian (value); length = value; }
+
+            if (! lengthRead)
+                return wireFormatError ("CBOR", "truncated string chunk");
+        }
+
+        auto bytes = reader.readBytes (length);
+        if (bytes == nullptr)
+            return wireFormatError ("CBOR", "truncated string chunk");
+
+        result.append (bytes, static_cast<std::size_t> (length));
+    }
+
+    return juce::Result::ok();
+}
+
+juce::Result decodeCborValue (WireFormatReader& reader, juce::var& result, int depth)
+{
+    if (depth > maxWireFormatDepth)
+        return wireFormatError ("CBOR", "nesting too deep");
+
+    juce::uint8 initialByte = 0;
+    if (! reader.readBigEndian (initialByte))
+        return wireFormatError ("CBOR", "truncated value");
+
+    const auto majorType = static_cast<CborMajorType> (initialByte >> 5);
+    const auto info = initialByte & 0x1f;
+
+    if (majorType == cborSimple)
+        return decodeCborSimple (reader, info, result);
+
+    juce::uint64 argument = 0;
+    bool isIndefinite = false;
+
+    if (info < 24)
+    {
+        argument = static_cast<juce::uint64> (info);
+    }
+    else if (info <= 27)
+    {
+        bool argumentRead = false;
+
+        if (info == 24) { juce::uint8 value = 0; argumentRead = reader.readBigEndian (value); argument = value; }
+        else if (info == 25) { juce::uint16 value = 0; argumentRead = reader.readBigEndian (value); argument = value; }
+        else if (info == 26) { juce::uint32 value = 0; argumentRead = reader.readBigEndian (value); argument = value; }
+        else { argumentRead = reader.readBigEndian (argument); }
+
+        if (! argumentRead)
+            return wireFormatError ("CBOR", "truncated argument");
+    }
+    else if (info == 31 && majorType >= cborBytes && majorType <= cborMap)
+    {
+        isIndefinite = true;
+    }
+    else
+    {
+        return wireFormatError ("CBOR", "invalid additional information " + juce::String (info));
+    }
+
+    switch (majorType)
+    {
+        case cborUnsigned:
+            result = makeUnsignedIntegerVar (argument);
+            return juce::Result::ok();
+
+        case cborNegative:
+            if (argument > static_cast<juce::uint64> (std::numeric_limits<juce::int64>::max()))
+                result = -1.0 - static_cast<double> (argument);
+            else
+                result = makeIntegerVar (-1 - static_cast<juce::int64> (argument));
+
+            return juce::Result::ok();
+
+        case cborBytes:
+        case cborText:
+        {
+            const void* data = nullptr;
+            std::size_t size = 0;
+
+            juce::MemoryBlock chunks;
+
+            if (isIndefinite)
+            {
+                if (auto chunksResult = decodeCborChunks (reader, majorType, chunks); chunksResult.failed())
+                    return chunksResult;
+
+                data = chunks.getData();
+                size = chunks.getSize();
+            }
+            else
+            {
+                data = reader.readBytes (argument);
+                size = static_cast<std::size_t> (argument);
+
+                if (data == nullptr)
+                    return wireFormatError ("CBOR", "truncated string");
+            }
+
+            if (majorType == cborText)
+                result = juce::String::fromUTF8 (static_cast<const char*> (data), static_cast<int> (size));
+            else
+                result = juce::var (data, size);
+
+            return juce::Result::ok();
+        }
+
+        case cborArray:
+        {
+            if (! isIndefinite && argument > reader.getNumBytesRemaining())
+                return wireFormatError ("CBOR", "truncated array");
+
+            juce::Array<juce::var> items;
+            if (! isIndefinite)
+                items.ensureStorageAllocated (static_cast<int> (argument));
+
+            for (juce::uint64 i = 0; isIndefinite ? ! reader.skipIfNextByteIs (cborBreak) : i < argument; ++i)
+            {
+                juce::var item;
+                if (auto decodeResult = decodeCborValue (reader, item, depth + 1); decodeResult.failed())
+                    return decodeResult;
+
+                items.add (std::move (item));
+            }
+
+            result = std::move (items);
+            return juce::Result::ok();
+        }
+
+        case cborMap:
+        {
+            if (! isIndefinite && argument > reader.getNumBytesRemaining() / 2)
+                return wireFormatError ("CBOR", "truncated map");
+
+            juce::DynamicObject::Ptr object = new juce::DynamicObject;
+
+            for (juce::uint64 i = 0; isIndefinite ? ! reader.skipIfNextByteIs (cborBreak) : i < argument; ++i)
+            {
+                juce::var key, value;
+
+                if (auto decodeResult = decodeCborValue (reader, key, depth + 1); decodeResult.failed())
+                    return decodeResult;
+
+                if (auto decodeResult = decodeCborValue (reader, value, depth + 1); decodeResult.failed())
+                    return decodeResult;
+
+                auto name = key.toString();
+                if (name.isEmpty())
+                    return wireFormatError ("CBOR", "empty map keys are not supported");
+
+                object->setProperty (name, std::move (value));
+            }
+
+            result = object.get();
+            return juce::Result::ok();
+        }
+
+        case cborTag:
+            // Tags only add semantics to the tagged value, which is decoded as is
+            return decodeCborValue (reader, result, depth + 1);
+
+        case cborSimple:
+        default:
+            break;
+    }
+
+    return wireFormatError ("CBOR", "invalid major type");
+}
+
+} // namespace
+
+//=================================================================================================
+
+std::optional<WireFormat> wireFormatFromMimeType (juce::StringRef mimeType)
+{
+    auto type = juce::String (mimeType).upToFirstOccurrenceOf (";", false, false).trim().toLowerCase();
+
+    if (type == "application/json")
+        return WireFormat::json;
+
+    if (type == "application/msgpack" || type == "application/x-msgpack" || type == "application/vnd.msgpack")
+        return WireFormat::msgpack;
+
+    if (type == "application/cbor")
+        return WireFormat::cbor;
+
+    return std::nullopt;
+}
+
+juce::String wireFormatToMimeType (WireFormat format)
+{
+    switch (format)
+    {
+        case WireFormat::msgpack: return "application/msgpack";
+        case WireFormat::cbor: return "application/cbor";
+        case WireFormat::json:
+        default: break;
+    }
+
+    return "application/json";
+}
+
+bool isBinaryWireFormat (WireFormat format)
+{
+    return format != WireFormat::json;
+}
+
+//=================================================================================================
+
+juce::MemoryBlock encodeVar (const juce::var& value, WireFormat format)
+{
+    juce::MemoryBlock result;
+
+    if (format == WireFormat::json)
+    {
+        auto json = juce::JSON::toString (value);
+        result.append (json.toRawUTF8(), json.getNumBytesAsUTF8());
+        return result;
+    }
+
+    juce::MemoryOutputStream output (result, false);
+
+    if (format == WireFormat::msgpack)
+        MessagePack::encode (value, output);
+    else
+        Cbor::encode (value, output);
+
+    output.flush();
+    return result;
+}
+
+juce::Result decodeVar (const void* data, std::size_t size, WireFormat format, juce::var& result)
+{
+    switch (format)
+    {
+        case WireFormat::msgpack: return MessagePack::decode (data, size, result);
+        case WireFormat::cbor: return Cbor::decode (data, size, result);
+        case WireFormat::json:
+        default: break;
+    }
+
+    return juce::JSON::parse (juce::String::fromUTF8 (static_cast<const char*> (data), static_cast<int> (size)), result);
+}
+
+//=================================================================================================
+
+namespace MessagePack {
+
+void encode (const juce::var& value, juce::OutputStream& output)
+{
+    if (value.isBool())
+    {
+        output.writeByte (static_cast<bool> (value) ? static_cast<char> (0xc3) : static_cast<char> (0xc2));
+    }
+    else if (value.isInt() || value.isInt64())
+    {
+        writeMessagePackInteger (output, static_cast<juce::int64> (value));
+    }
+    else if (value.isDouble())
+    {
+        const auto number = static_cast<double> (value);
+
+        if (isLosslessFloat (number))
+        {
+            output.writeByte (static_cast<char> (0xca));
+            output.writeFloatBigEndian (static_cast<float> (number));
+        }
+        else
+        {
+            output.writeByte (static_cast<char> (0xcb));
+            output.writeDoubleBigEndian (number);
+        }
+    }
+    else if (value.isString())
+    {
+        writeMessagePackString (output, value.toString());
+    }
+    else if (auto block = value.getBinaryData())
+    {
+        writeMessagePackHeader (output, block->getSize(), -1, 0, 0xc4, 0xc5, 0xc6);
+        output.write (block->getData(), block->getSize());
+    }
+    else if (auto array = value.getArray())
+    {
+        writeMessagePackHeader (output, static_cast<std::size_t> (array->size()), 0x90, 15, -1, 0xdc, 0xdd);
+
+        for (const auto& item : *array)
+            encode (item, output);
+    }
+    else if (auto object = value.getDynamicObject())
+    {
+        const auto& properties = object->getProperties();
+
+        writeMessagePackHeader (output, static_cast<std::size_t> (properties.size()), 0x80, 15, -1, 0xde, 0xdf);
+
+        for (const auto& property : properties)
+        {
+            writeMessagePackString (output, property.name.toString());
+            encode (property.value, output);
+        }
+    }
+    else
+    {
+        output.writeByte (static_cast<char> (0xc0));
+    }
+}
+
+juce::Result decode (const void* data, std::size_t size, juce::var& result)
+{
+    WireFormatReader reader (data, size);
+
+    if (auto decodeResult = decodeMessagePackValue (reader, result, 0); decodeResult.failed())
+        return decodeResult;
+
+    if (! reader.isExhausted())
+        return wireFormatError ("MessagePack", "trailing data after value");
+
+    return juce::Result::ok();
+}
+
+} // namespace MessagePack
+
+//=================================================================================================
+
+namespace Cbor {
+
+void encode (const juce::var& value, juce::OutputStream& output)
+{
+    if (value.isBool())
+    {
+        output.writeByte (static_cast<bool> (value) ? static_cast<char> (0xf5) : static_cast<char> (0xf4));
+    }
+    else if (value.isInt() || value.isInt64())
+    {
+        const auto number = static_cast<juce::int64> (value);
+
+        if (number >= 0)
+            writeCborHead (output, cborUnsigned, static_cast<juce::uint64> (number));
+        else
+            writeCborHead (output, cborNegative, static_cast<juce::uint64> (-(number + 1)));
+    }
+    else if (value.isDouble())
+    {
+        const auto number = static_cast<double> (value);
+
+        if (isLosslessFloat (number))
+        {
+            output.writeByte (static_cast<char> (0xfa));
+            output.writeFloatBigEndian (static_cast<float> (number));
+        }
+        else
+        {
+            output.writeByte (static_cast<char> (0xfb));
+            output.writeDoubleBigEndian (number);
+        }
+    }
+    else if (value.isString())
+    {
+        writeCborString (output, value.toString());
+    }
+    else if (auto block = value.getBinaryData())
+    {
+        writeCborHead (output, cborBytes, block->getSize());
+        output.write (block->getData(), block->getSize());
+    }
+    else if (auto array = value.getArray())
+    {
+        writeCborHead (output, cborArray, static_cast<juce::uint64> (array->size()));
+
+        for (const auto& item : *array)
+            encode (item, output);
+    }
+    else if (auto object = value.getDynamicObject())
+    {
+        const auto& properties = object->getProperties();
+
+        writeCborHead (output, cborMap, static_cast<juce::uint64> (properties.size()));
+
+        for (const auto& property : properties)
+        {
+            writeCborString (output, property.name.toString());
+            encode (property.value, output);
+        }
+    }
+    else
+    {
+        output.writeByte (static_cast<char> (0xf6));
+    }
+}
+
+juce::Result decode (const void* data, std::size_t size, juce::var& result)
+{
+    WireFormatReader reader (data, size);
+
+    if (auto decodeResult = decodeCborValue (reader, result, 0); decodeResult.failed())
+        return decodeResult;
+
+    if (! reader.isExhausted())
+        return wireFormatError ("CBOR", "trailing data after value");
+
+    return juce::Result::ok();
+}
+
+} // namespace Cbor
+
+} // namespace straw
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the straw project.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   straw is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "straw_VariantConverter.h"
+
+#include <optional>
+
+namespace straw {
+
+//=================================================================================================
+
+/**
+ * @brief The encodings the automation server can exchange values with.
+ */
+enum class WireFormat
+{
+    json,       ///< Text, `application/json`.
+    msgpack,    ///< MessagePack, `application/msgpack`.
+    cbor        ///< CBOR, `application/cbor`.
+};
+
+/**
+ * @brief Get the wire format for a mime type, ignoring any parameter.
+ *
+ * @param mimeType The mime type, as found in a `Content-Type` or `Accept` header.
+ *
+ * @return The wire format, or nothing if the mime type is not a supported encoding.
+ */
+[[nodiscard]] std::optional<WireFormat> wireFormatFromMimeType (juce::StringRef mimeType);
+
+/**
+ * @brief Get the mime type of a wire format.
+ */
+[[nodiscard]] juce::String wireFormatToMimeType (WireFormat format);
+
+/**
+ * @brief Check if a wire format is a binary encoding.
+ */
+[[nodiscard]] bool isBinaryWireFormat (WireFormat format);
+
+//=================================================================================================
+
+/**
+ * @brief Encode a var in a wire format.
+ *
+ * Binary data stored in the var, like rendered images, is encoded as a native byte string by the binary formats, avoiding
+ * the base64 round trip needed with JSON. Methods are encoded as null.
+ *
+ * @param value The value to encode.
+ * @param format The format to encode the value in.
+ *
+ * @return The encoded data.
+ */
+[[nodiscard]] juce::MemoryBlock encodeVar (const juce::var& value, WireFormat format);
+
+/**
+ * @brief Decode a var from a wire format.
+ *
+ * Maps keys which are not strings are converted to strings, integers not representable in 64 bits signed integers are
+ * decoded as doubles.
+ *
+ * @param data The encoded data.
+ * @param size The size of the encoded data in bytes.
+ * @param format The format the data is encoded in.
+ * @param result The decoded value.
+ *
+ * @return A juce::Result indicating the success or failure of the operation.
+ */
+[[nodiscard]] juce::Result decodeVar (const void* data, std::size_t size, WireFormat format, juce::var& result);
+
+/**
+ * @brief Encode a value in a wire format, converting it through its `VariantConverter`.
+ */
+template <class T>
+[[nodiscard]] juce::MemoryBlock encodeValue (const T& value, WireFormat format)
+{
+    return encodeVar (toVar (value), format);
+}
+
+//=================================================================================================
+
+namespace MessagePack {
+
+/**
+ * @brief Encode a var as MessagePack, using the most compact representation of each value.
+ *
+ * @param value The value to encode.
+ * @param output The stream to write the encoded data to.
+ */
+void encode (const juce::var& value, juce::OutputStream& output);
+
+/**
+ * @brief Decode a var from MessagePack data, the data must contain exactly one value.
+ *
+ * @param data The encoded data.
+ * @param size The size of the encoded data in bytes.
+ * @param result The decoded value.
+ *
+ * @return A juce::Result indicating the success or failure of the operation.
+ */
+[[nodiscard]] juce::Result decode (const void* data, std::size_t size, juce::var& result);
+
+} // namespace MessagePack
+
+//=================================================================================================
+
+namespace Cbor {
+
+/**
+ * @brief Encode a var as CBOR, using definite lengths and the shortest form of each integer.
+ *
+ * @param value The value to encode.
+ * @param output The stream to write the encoded data to.
+ */
+void encode (const juce::var& value, juce::OutputStream& output);
+
+/**
+ * @brief Decode a var from CBOR data, the data must contain exactly one value.
+ *
+ * Indefinite lengths, half precision floats and tagged values are supported, tags are ignored.
+ *
+ * @param data The encoded data.
+ * @param size The size of the encoded data in bytes.
+ * @param result The decoded value.
+ *
+ * @return A juce::Result indicating the success or failure of the operation.
+ */
+[[nodiscard]] juce::Result decode (const void* data, std::size_t size, juce::var& result);
+
+} // namespace Cbor
+
+} // namespace straw
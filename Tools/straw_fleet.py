@@ -0,0 +1,214 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+"""
+Discover the running straw instances and fan out requests to all of them in parallel.
+
+Every running automation server registers itself as a `<pid>.run` file in the registry directory, which is `straw.run.d`
+next to the application executable unless `STRAW_REGISTRY_DIR` is set. Entries of processes that are not alive anymore are
+pruned while listing.
+
+Examples:
+
+    python3 straw_fleet.py --registry ./build/straw.run.d list
+    python3 straw_fleet.py --registry ./build/straw.run.d script Demo/Scripts/test.py
+    python3 straw_fleet.py --registry ./build/straw.run.d call /straw/component/exists '{"id":"button"}'
+"""
+
+import argparse
+import concurrent.futures
+import http.client
+import json
+import os
+import sys
+import time
+
+
+def is_process_alive(pid):
+    if pid <= 0:
+        return False
+
+    if os.name == "nt":
+        import ctypes
+        handle = ctypes.windll.kernel32.OpenProcess(0x1000, False, pid)  # PROCESS_QUERY_LIMITED_INFORMATION
+        if not handle:
+            return False
+        ctypes.windll.kernel32.CloseHandle(handle)
+        return True
+
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        return True
+
+    return True
+
+
+def parse_run_file(path):
+    entry = {}
+
+    with open(path, "r", encoding="utf-8") as f:
+        for line in f:
+            key, separator, value = line.strip().partition("=")
+            if separator:
+                entry[key] = value
+
+    entry["pid"] = int(entry.get("pid", 0))
+    entry["port"] = int(entry.get("port", 0))
+    return entry
+
+
+def discover_instances(registry, prune=True):
+    instances = []
+
+    if not os.path.isdir(registry):
+        return instances
+
+    for file_name in sorted(os.listdir(registry)):
+        if not file_name.endswith(".run"):
+            continue
+
+        path = os.path.join(registry, file_name)
+
+        try:
+            entry = parse_run_file(path)
+        except (OSError, ValueError):
+            continue
+
+        if not is_process_alive(entry["pid"]):
+            if prune:
+                try:
+                    os.remove(path)
+                except OSError:
+                    pass
+            continue
+
+        if entry["port"] > 0:
+            instances.append(entry)
+
+    return instances
+
+
+def send_request(instance, path, body, content_type, timeout):
+    # http.client keeps the header names as written, the server expects the canonical casing
+    connection = http.client.HTTPConnection("127.0.0.1", instance["port"], timeout=timeout)
+
+    start_time = time.monotonic()
+
+    try:
+        connection.request("POST", path, body=body, headers={"Content-Type": content_type})
+        response = connection.getresponse()
+        status, payload = response.status, response.read()
+    except (http.client.HTTPException, OSError) as e:
+        status, payload = 0, json.dumps({"error": str(e)}).encode("utf-8")
+    finally:
+        connection.close()
+
+    elapsed = time.monotonic() - start_time
+
+    try:
+        result = json.loads(payload.decode("utf-8"))
+    except (UnicodeDecodeError, ValueError):
+        result = {"error": "invalid response", "size": len(payload)}
+
+    return {
+        "pid": instance["pid"],
+        "port": instance["port"],
+        "name": instance.get("name", ""),
+        "status": status,
+        "elapsed_s": round(elapsed, 6),
+        "ok": status == 200,
+        "response": result,
+    }
+
+
+def fan_out(instances, path, body, content_type, timeout, max_workers):
+    if not instances:
+        return []
+
+    workers = max(1, min(max_workers, len(instances)))
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=workers) as executor:
+        futures = [executor.submit(send_request, instance, path, body, content_type, timeout) for instance in instances]
+        return [future.result() for future in futures]
+
+
+def merge_results(results):
+    return {
+        "instances": len(results),
+        "succeeded": sum(1 for result in results if result["ok"]),
+        "failed": sum(1 for result in results if not result["ok"]),
+        "max_elapsed_s": max((result["elapsed_s"] for result in results), default=0.0),
+        "results": sorted(results, key=lambda result: result["pid"]),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Coordinate a fleet of straw automated applications.")
+    parser.add_argument("--registry", default=os.environ.get("STRAW_REGISTRY_DIR"),
+                        help="registry directory of the running instances (defaults to STRAW_REGISTRY_DIR)")
+    parser.add_argument("--timeout", type=float, default=60.0, help="timeout of each request in seconds")
+    parser.add_argument("--jobs", type=int, default=64, help="maximum number of requests in flight")
+
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    commands.add_parser("list", help="list the running instances")
+
+    script_parser = commands.add_parser("script", help="run a python script on every instance")
+    script_parser.add_argument("script", help="path of the python script to run")
+
+    call_parser = commands.add_parser("call", help="call an endpoint on every instance")
+    call_parser.add_argument("path", help="endpoint path, like /straw/component/exists")
+    call_parser.add_argument("data", nargs="?", default="{}", help="json data of the request")
+
+    args = parser.parse_args()
+
+    if not args.registry:
+        parser.error("the registry directory must be specified with --registry or STRAW_REGISTRY_DIR")
+
+    instances = discover_instances(args.registry)
+
+    if args.command == "list":
+        print(json.dumps(instances, indent=2))
+        return 0
+
+    if args.command == "script":
+        with open(args.script, "rb") as f:
+            body = f.read()
+
+        results = fan_out(instances, "/", body, "text/x-python", args.timeout, args.jobs)
+
+    else:
+        try:
+            json.loads(args.data)
+        except ValueError as e:
+            parser.error(f"invalid json data: {e}")
+
+        results = fan_out(instances, args.path, args.data.encode("utf-8"), "application/json", args.timeout, args.jobs)
+
+    merged = merge_results(results)
+    print(json.dumps(merged, indent=2))
+
+    return 0 if merged["instances"] > 0 and merged["failed"] == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,166 @@
+# ==============================================================================
+#
+#   This file is part of the straw project.
+#   Copyright (c) 2024 - kunitoki@gmail.com
+#
+#   straw is an open source library subject to open-source licensing.
+#
+#   The code included in this file is provided under the terms of the ISC license
+#   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+#   To use, copy, modify, and/or distribute this software for any purpose with or
+#   without fee is hereby granted provided that the above copyright notice and
+#   this permission notice appear in all copies.
+#
+#   STRAW IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+#   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+#   DISCLAIMED.
+#
+# ==============================================================================
+
+"""
+Call a straw instance running on the same host, through its Unix domain socket and shared memory when available.
+
+The server publishes the `unix_socket` path in its registry entry when it was started with a socket file. Requests sent with
+the `X-Straw-Transport: shm` header get their bulk responses (like component renders) written in a memory mapped ring, and
+only the location of the payload is sent through the connection in the `X-Straw-Shm-Path`, `X-Straw-Shm-Position` and
+`X-Straw-Shm-Size` headers.
+
+Examples:
+
+    python3 straw_local.py --socket /tmp/straw.sock call /straw/component/render '{"id":"button"}' --output button.png
+    python3 straw_local.py --port 8001 --shm call /straw/trace/hops/chrome --output hops.json
+"""
+
+import argparse
+import json
+import mmap
+import os
+import socket
+import struct
+import sys
+
+
+SHM_MAGIC = b"STRAWSHM"
+SHM_HEADER_SIZE = 64
+
+
+class OverwrittenPayloadError(Exception):
+    pass
+
+
+def read_shared_memory(path, position, size):
+    with open(path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as ring:
+            if ring[0:8] != SHM_MAGIC:
+                raise ValueError("invalid shared memory file")
+
+            capacity = struct.unpack_from("<Q", ring, 16)[0]
+            offset = SHM_HEADER_SIZE + position % capacity
+            payload = bytes(ring[offset:offset + size])
+
+            # The payload is valid only if the writer didn't lap it while it was being copied
+            reserved = struct.unpack_from("<Q", ring, 24)[0]
+            if reserved - position > capacity:
+                raise OverwrittenPayloadError()
+
+            return payload
+
+
+def parse_response(data):
+    header_data, _, body = data.partition(b"\n\n")
+
+    lines = header_data.decode("utf-8").splitlines()
+    status = int(lines[0].split()[1]) if lines else 0
+
+    headers = {}
+    for line in lines[1:]:
+        key, separator, value = line.partition(":")
+        if separator:
+            headers[key.strip().lower()] = value.strip()
+
+    return status, headers, body
+
+
+def send_request(args, path, body, content_type):
+    if args.socket:
+        connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        connection.connect(args.socket)
+    else:
+        connection = socket.create_connection(("127.0.0.1", args.port))
+
+    request_headers = [
+        f"POST {path} HTTP/1.1",
+        "Host: localhost",
+        f"Content-Type: {content_type}",
+        f"Content-Length: {len(body)}",
+    ]
+
+    if args.shm:
+        request_headers.append("X-Straw-Transport: shm")
+
+    with connection:
+        connection.sendall(("\r\n".join(request_headers) + "\r\n\r\n").encode("utf-8") + body)
+        connection.shutdown(socket.SHUT_WR)
+
+        chunks = []
+        while True:
+            chunk = connection.recv(65536)
+            if not chunk:
+                break
+            chunks.append(chunk)
+
+    status, headers, payload = parse_response(b"".join(chunks))
+
+    if "x-straw-shm-path" in headers:
+        payload = read_shared_memory(headers["x-straw-shm-path"],
+                                     int(headers["x-straw-shm-position"]),
+                                     int(headers["x-straw-shm-size"]))
+
+    return status, payload
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Call a straw automated application running on the same host.")
+    parser.add_argument("--socket", help="path of the unix domain socket of the instance")
+    parser.add_argument("--port", type=int, default=8001, help="port of the instance, when not using a unix domain socket")
+    parser.add_argument("--shm", action="store_true", help="receive bulk responses through shared memory")
+    parser.add_argument("--retries", type=int, default=3, help="attempts when a shared memory payload was overwritten")
+
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    call_parser = commands.add_parser("call", help="call an endpoint")
+    call_parser.add_argument("path", help="endpoint path, like /straw/component/render")
+    call_parser.add_argument("data", nargs="?", default="{}", help="json data of the request")
+    call_parser.add_argument("--output", help="write the response payload to a file instead of the standard output")
+
+    args = parser.parse_args()
+
+    if args.socket and not hasattr(socket, "AF_UNIX"):
+        parser.error("unix domain sockets are not supported on this platform")
+
+    try:
+        json.loads(args.data)
+    except ValueError as e:
+        parser.error(f"invalid json data: {e}")
+
+    for _ in range(max(1, args.retries)):
+        try:
+            status, payload = send_request(args, args.path, args.data.encode("utf-8"), "application/json")
+            break
+        except OverwrittenPayloadError:
+            continue
+    else:
+        print("the shared memory payload was overwritten, increase the ring capacity", file=sys.stderr)
+        return 1
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(payload)
+    else:
+        sys.stdout.buffer.write(payload + b"\n")
+
+    return 0 if status == 200 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())